@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_builders.h"
+#include "mir/events/contact_state.h"
+
+#include <xkbcommon/xkbcommon-keysyms.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace mev = mir::events;
+
+// Count every heap allocation in the process (including those made by
+// capnproto, which uses malloc() directly) by interposing on glibc's malloc
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+}
+
+extern "C"
+{
+void* malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+namespace
+{
+std::vector<uint8_t> const no_cookie;
+
+// What the input platform and SurfaceInputDispatcher do with each event:
+// build it, then clone it for delivery to the target surface
+void pointer_motion(uint64_t i)
+{
+    auto const event = mev::make_event(
+        MirInputDeviceId{1}, std::chrono::nanoseconds{i}, no_cookie,
+        mir_input_event_modifier_none, mir_pointer_action_motion, 0,
+        i % 1920, i % 1080, 0.0f, 0.0f, 1.0f, 1.0f);
+    auto const delivered = mev::clone_event(*event);
+}
+
+void key_press(uint64_t i)
+{
+    auto const event = mev::make_event(
+        MirInputDeviceId{2}, std::chrono::nanoseconds{i}, no_cookie,
+        mir_keyboard_action_down, XKB_KEY_a, 30, mir_input_event_modifier_none);
+    auto const delivered = mev::clone_event(*event);
+}
+
+void touch_motion(uint64_t i)
+{
+    static std::vector<mev::ContactState> contacts{
+        {0, mir_touch_action_change, mir_touch_tooltype_finger, 0.0f, 0.0f, 1.0f, 5.0f, 5.0f, 0.0f},
+        {1, mir_touch_action_change, mir_touch_tooltype_finger, 0.0f, 0.0f, 1.0f, 5.0f, 5.0f, 0.0f}};
+
+    for (auto& contact : contacts)
+    {
+        contact.x = (i + contact.touch_id * 100) % 1920;
+        contact.y = (i + contact.touch_id * 100) % 1080;
+    }
+
+    auto const event = mev::make_event(
+        MirInputDeviceId{3}, std::chrono::nanoseconds{i}, no_cookie,
+        mir_input_event_modifier_none, contacts);
+    auto const delivered = mev::clone_event(*event);
+}
+
+void run(char const* name, std::function<void(uint64_t)> const& event_cycle, uint64_t event_count)
+{
+    // Warm up, so that any recycled storage is in place
+    for (uint64_t i = 0; i != 1000; ++i)
+        event_cycle(i);
+
+    auto const allocations_before = allocations.load();
+    auto const start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i != event_count; ++i)
+        event_cycle(i);
+
+    auto const duration = std::chrono::steady_clock::now() - start;
+    auto const allocated = allocations.load() - allocations_before;
+    auto const seconds = std::chrono::duration<double>(duration).count();
+
+    std::cout<<name<<": "<<event_count / seconds<<" events/s, "
+             <<double(allocated) / event_count<<" allocations/event"<<std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <event count>"<<std::endl;
+        exit(1);
+    }
+
+    uint64_t const event_count = std::atoll(argv[1]);
+
+    run("pointer", pointer_motion, event_count);
+    run("keyboard", key_press, event_count);
+    run("touch", touch_motion, event_count);
+
+    exit(0);
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/wayland_executor.h"
+
+#include <wayland-server-core.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace mf = mir::frontend;
+
+namespace
+{
+// Spawns work from several producer threads while the Wayland loop runs on
+// another, the way the frontend hands work from the compositor and input
+// threads to the Wayland thread
+void run(unsigned producer_count, uint64_t tasks_per_producer)
+{
+    auto const loop = wl_event_loop_create();
+    auto const executor = new mf::WaylandExecutor{loop};
+
+    uint64_t const total_tasks = producer_count * tasks_per_producer;
+    uint64_t executed{0};
+    uint64_t wakeups{0};
+    std::atomic<bool> producers_ready{false};
+
+    std::thread wayland_thread{
+        [&]
+        {
+            while (executed != total_tasks)
+            {
+                auto const executed_before = executed;
+                wl_event_loop_dispatch(loop, 100);
+                if (executed != executed_before)
+                    ++wakeups;
+            }
+        }};
+
+    std::vector<std::thread> producers;
+    auto const start = std::chrono::steady_clock::now();
+
+    for (auto i = 0u; i != producer_count; ++i)
+    {
+        producers.emplace_back(
+            [&]
+            {
+                while (!producers_ready)
+                    std::this_thread::yield();
+
+                for (uint64_t task = 0; task != tasks_per_producer; ++task)
+                {
+                    // Run on the Wayland thread only, so no need to synchronise
+                    executor->spawn([&executed] { ++executed; });
+                }
+            });
+    }
+    producers_ready = true;
+
+    for (auto& producer : producers)
+        producer.join();
+    auto const spawned = std::chrono::steady_clock::now();
+
+    wayland_thread.join();
+    auto const drained = std::chrono::steady_clock::now();
+
+    delete executor;
+    wl_event_loop_destroy(loop);
+
+    auto const spawn_seconds = std::chrono::duration<double>(spawned - start).count();
+    auto const total_seconds = std::chrono::duration<double>(drained - start).count();
+
+    std::cout<<producer_count<<" producers: "
+             <<total_tasks / spawn_seconds<<" spawns/s, "
+             <<total_tasks / total_seconds<<" tasks run/s, "
+             <<double(wakeups) / total_tasks<<" wakeups/task"<<std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <tasks per producer>"<<std::endl;
+        exit(1);
+    }
+
+    uint64_t const tasks_per_producer = std::atoll(argv[1]);
+
+    for (auto const producer_count : {1u, 2u, 4u, 8u})
+        run(producer_count, tasks_per_producer);
+
+    exit(0);
+}
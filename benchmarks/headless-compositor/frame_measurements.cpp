@@ -0,0 +1,166 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_measurements.h"
+
+#include "mir/compositor/display_buffer_compositor.h"
+
+#include <time.h>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+// Count every heap allocation in the process by interposing on glibc's malloc
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace
+{
+std::atomic<uint64_t> allocations{0};
+}
+
+extern "C"
+{
+void* malloc(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+auto allocation_count() -> uint64_t
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+namespace
+{
+auto cpu_time(clockid_t clock) -> std::chrono::nanoseconds
+{
+    timespec now;
+    clock_gettime(clock, &now);
+    return std::chrono::seconds{now.tv_sec} + std::chrono::nanoseconds{now.tv_nsec};
+}
+
+// Enough for a few minutes of compositing at a high frame rate, so that
+// recording frames doesn't allocate while measuring
+size_t const expected_frames = 1 << 16;
+}
+
+void FrameMeasurements::start()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    results_ = Results{};
+    results_.frame_times.reserve(expected_frames);
+    results_.cpu_times.reserve(expected_frames);
+
+    process_cpu_at_start = cpu_time(CLOCK_PROCESS_CPUTIME_ID);
+    allocations_at_start = allocation_count();
+    measuring = true;
+}
+
+void FrameMeasurements::stop()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    measuring = false;
+    results_.process_cpu_time = cpu_time(CLOCK_PROCESS_CPUTIME_ID) - process_cpu_at_start;
+    results_.allocations = allocation_count() - allocations_at_start;
+}
+
+void FrameMeasurements::record_frame(std::chrono::nanoseconds frame_time, std::chrono::nanoseconds cpu_time)
+{
+    if (!measuring)
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (measuring)
+    {
+        results_.frame_times.push_back(frame_time);
+        results_.cpu_times.push_back(cpu_time);
+    }
+}
+
+auto FrameMeasurements::results() const -> Results
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return results_;
+}
+
+MeasuringDisplayBufferCompositorFactory::MeasuringDisplayBufferCompositorFactory(
+    std::shared_ptr<mc::DisplayBufferCompositorFactory> const& wrapped,
+    std::shared_ptr<FrameMeasurements> const& measurements) :
+    wrapped{wrapped},
+    measurements{measurements}
+{
+}
+
+auto MeasuringDisplayBufferCompositorFactory::create_compositor_for(mg::DisplayBuffer& display_buffer)
+    -> std::unique_ptr<mc::DisplayBufferCompositor>
+{
+    struct MeasuringDisplayBufferCompositor : mc::DisplayBufferCompositor
+    {
+        MeasuringDisplayBufferCompositor(
+            std::unique_ptr<mc::DisplayBufferCompositor> wrapped,
+            std::shared_ptr<FrameMeasurements> const& measurements) :
+            wrapped{std::move(wrapped)},
+            measurements{measurements}
+        {
+        }
+
+        void composite(mc::SceneElementSequence&& scene_sequence) override
+        {
+            auto const cpu_before = cpu_time(CLOCK_THREAD_CPUTIME_ID);
+            auto const before = std::chrono::steady_clock::now();
+
+            wrapped->composite(std::move(scene_sequence));
+
+            auto const frame_time = std::chrono::steady_clock::now() - before;
+            measurements->record_frame(frame_time, cpu_time(CLOCK_THREAD_CPUTIME_ID) - cpu_before);
+        }
+
+        std::unique_ptr<mc::DisplayBufferCompositor> const wrapped;
+        std::shared_ptr<FrameMeasurements> const measurements;
+    };
+
+    return std::make_unique<MeasuringDisplayBufferCompositor>(
+        wrapped->create_compositor_for(display_buffer),
+        measurements);
+}
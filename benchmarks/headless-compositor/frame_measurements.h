@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_MEASUREMENTS_H_
+#define FRAME_MEASUREMENTS_H_
+
+#include "mir/compositor/display_buffer_compositor_factory.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// Number of heap allocations made by this process so far
+auto allocation_count() -> uint64_t;
+
+/// What the server spent on the frames composited between start() and stop()
+class FrameMeasurements
+{
+public:
+    void start();
+    void stop();
+
+    /// Called by the compositing threads
+    void record_frame(std::chrono::nanoseconds frame_time, std::chrono::nanoseconds cpu_time);
+
+    struct Results
+    {
+        std::vector<std::chrono::nanoseconds> frame_times;
+        std::vector<std::chrono::nanoseconds> cpu_times;
+        /// CPU time of the whole server process (the clients run in their own processes)
+        std::chrono::nanoseconds process_cpu_time;
+        uint64_t allocations;
+    };
+
+    auto results() const -> Results;
+
+private:
+    std::atomic<bool> measuring{false};
+
+    std::mutex mutable mutex;
+    std::chrono::nanoseconds process_cpu_at_start;
+    uint64_t allocations_at_start;
+    Results results_{};
+};
+
+/// Times each frame composited by the wrapped factory's compositors
+class MeasuringDisplayBufferCompositorFactory : public mir::compositor::DisplayBufferCompositorFactory
+{
+public:
+    MeasuringDisplayBufferCompositorFactory(
+        std::shared_ptr<mir::compositor::DisplayBufferCompositorFactory> const& wrapped,
+        std::shared_ptr<FrameMeasurements> const& measurements);
+
+    auto create_compositor_for(mir::graphics::DisplayBuffer& display_buffer)
+        -> std::unique_ptr<mir::compositor::DisplayBufferCompositor> override;
+
+private:
+    std::shared_ptr<mir::compositor::DisplayBufferCompositorFactory> const wrapped;
+    std::shared_ptr<FrameMeasurements> const measurements;
+};
+
+#endif // FRAME_MEASUREMENTS_H_
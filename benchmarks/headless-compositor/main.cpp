@@ -0,0 +1,348 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_measurements.h"
+#include "statistics.h"
+#include "synthetic_client.h"
+
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "miral/test_display_server.h"
+#include "miral/minimal_window_manager.h"
+
+#include "mir/fd.h"
+#include "mir/server.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace geom = mir::geometry;
+namespace mtf = mir_test_framework;
+using namespace std::chrono;
+
+namespace
+{
+struct Options
+{
+    int clients{4};
+    SyntheticClientConfig client{geom::Size{640, 480}, 60, DamagePattern::full, seconds{1}, seconds{10}};
+};
+
+auto name_of(DamagePattern pattern) -> char const*
+{
+    switch (pattern)
+    {
+    case DamagePattern::full: return "full";
+    case DamagePattern::strip: return "strip";
+    case DamagePattern::square: return "square";
+    }
+
+    return "unknown";
+}
+
+void usage(char const* program)
+{
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "Options:\n"
+              << "  --clients <count>                   number of client processes (default 4)\n"
+              << "  --size <width>x<height>             client surface size (default 640x480)\n"
+              << "  --rate <fps>                        client update rate, 0 for unthrottled (default 60)\n"
+              << "  --damage <full|strip|square>        what each frame redraws (default full)\n"
+              << "  --warm-up <seconds>                 time before measuring starts (default 1)\n"
+              << "  --duration <seconds>                time to measure for (default 10)\n"
+              << "Results are written to stdout as JSON." << std::endl;
+    exit(1);
+}
+
+auto parse_options(int argc, char const* argv[]) -> Options
+{
+    Options options;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        if (i + 1 == argc)
+            usage(argv[0]);
+
+        auto const option = argv[i];
+        auto const value = argv[++i];
+
+        if (strcmp(option, "--clients") == 0)
+        {
+            options.clients = std::atoi(value);
+        }
+        else if (strcmp(option, "--size") == 0)
+        {
+            int width, height;
+            if (sscanf(value, "%dx%d", &width, &height) != 2 || width <= 0 || height <= 0)
+                usage(argv[0]);
+            options.client.size = geom::Size{width, height};
+        }
+        else if (strcmp(option, "--rate") == 0)
+        {
+            options.client.update_rate = std::atoi(value);
+        }
+        else if (strcmp(option, "--damage") == 0)
+        {
+            if (strcmp(value, "full") == 0)
+                options.client.damage = DamagePattern::full;
+            else if (strcmp(value, "strip") == 0)
+                options.client.damage = DamagePattern::strip;
+            else if (strcmp(value, "square") == 0)
+                options.client.damage = DamagePattern::square;
+            else
+                usage(argv[0]);
+        }
+        else if (strcmp(option, "--warm-up") == 0)
+        {
+            options.client.warm_up = duration_cast<nanoseconds>(duration<double>{std::atof(value)});
+        }
+        else if (strcmp(option, "--duration") == 0)
+        {
+            options.client.duration = duration_cast<nanoseconds>(duration<double>{std::atof(value)});
+        }
+        else
+        {
+            usage(argv[0]);
+        }
+    }
+
+    if (options.clients <= 0 || options.client.update_rate < 0 || options.client.duration <= nanoseconds{0})
+        usage(argv[0]);
+
+    return options;
+}
+
+/// Tiles the client windows so that none of them is occluded (until they no longer fit)
+class TilingWindowManager : public miral::MinimalWindowManager
+{
+public:
+    TilingWindowManager(miral::WindowManagerTools const& tools, geom::Size tile_size) :
+        MinimalWindowManager{tools},
+        tile_size{tile_size}
+    {
+    }
+
+    auto place_new_window(miral::ApplicationInfo const& app_info, miral::WindowSpecification const& requested)
+        -> miral::WindowSpecification override
+    {
+        auto placement = MinimalWindowManager::place_new_window(app_info, requested);
+
+        auto const area = tools.active_output();
+        auto const columns = std::max(area.size.width.as_int() / tile_size.width.as_int(), 1);
+        auto const rows = std::max(area.size.height.as_int() / tile_size.height.as_int(), 1);
+        auto const layer = windows_placed / (columns * rows);
+        auto const tile = windows_placed % (columns * rows);
+
+        placement.top_left() = area.top_left + geom::Displacement{
+            (tile % columns) * tile_size.width.as_int() + 8 * layer,
+            (tile / columns) * tile_size.height.as_int() + 8 * layer};
+
+        ++windows_placed;
+        return placement;
+    }
+
+private:
+    geom::Size const tile_size;
+    int windows_placed{0};
+};
+
+class BenchmarkServer : public miral::TestDisplayServer
+{
+public:
+    BenchmarkServer(std::shared_ptr<FrameMeasurements> const& measurements, geom::Size client_size) :
+        client_size{client_size}
+    {
+        char socket_name[32];
+        snprintf(socket_name, sizeof socket_name, "mir-benchmark-%d", getpid());
+        add_to_environment("WAYLAND_DISPLAY", socket_name);
+
+        if (getenv("XDG_RUNTIME_DIR") == nullptr)
+            add_to_environment("XDG_RUNTIME_DIR", "/tmp");
+
+        add_server_init([measurements](mir::Server& server)
+            {
+                server.override_the_display_buffer_compositor_factory([measurements]
+                    {
+                        return std::make_shared<MeasuringDisplayBufferCompositorFactory>(
+                            std::make_shared<mtf::HeadlessDisplayBufferCompositorFactory>(),
+                            measurements);
+                    });
+            });
+    }
+
+    auto build_window_manager_policy(miral::WindowManagerTools const& tools)
+        -> std::unique_ptr<miral::WindowManagementPolicy> override
+    {
+        return std::make_unique<TilingWindowManager>(tools, client_size);
+    }
+
+private:
+    geom::Size const client_size;
+};
+
+struct ClientProcess
+{
+    pid_t pid;
+    mir::Fd start;
+    mir::Fd results;
+};
+
+// Clients are forked before the server starts any threads, and wait to be told to start
+auto spawn_client(SyntheticClientConfig const& config, std::vector<ClientProcess> const& siblings) -> ClientProcess
+{
+    int start_pipe[2];
+    int results_pipe[2];
+    if (pipe(start_pipe) || pipe(results_pipe))
+    {
+        perror("Failed to create pipe");
+        exit(1);
+    }
+
+    auto const pid = fork();
+    if (pid < 0)
+    {
+        perror("Failed to fork client");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        close(start_pipe[1]);
+        close(results_pipe[0]);
+
+        for (auto const& sibling : siblings)
+        {
+            close(sibling.start);
+            close(sibling.results);
+        }
+
+        char go;
+        if (read(start_pipe[0], &go, 1) != 1)
+            _exit(1);
+
+        try
+        {
+            run_synthetic_client(config).write_to(results_pipe[1]);
+        }
+        catch (std::exception const& error)
+        {
+            std::cerr << "Client failed: " << error.what() << std::endl;
+            _exit(1);
+        }
+
+        _exit(0);
+    }
+
+    close(start_pipe[0]);
+    close(results_pipe[1]);
+
+    return ClientProcess{pid, mir::Fd{start_pipe[1]}, mir::Fd{results_pipe[0]}};
+}
+
+void append(std::vector<nanoseconds>& to, std::vector<nanoseconds> const& from)
+{
+    to.insert(to.end(), from.begin(), from.end());
+}
+}
+
+int main(int argc, char const* argv[])
+{
+    auto const options = parse_options(argc, argv);
+    auto const measurements = std::make_shared<FrameMeasurements>();
+
+    BenchmarkServer server{measurements, options.client.size};
+
+    std::vector<ClientProcess> clients;
+    for (int i = 0; i != options.clients; ++i)
+        clients.push_back(spawn_client(options.client, clients));
+
+    server.start_server();
+
+    for (auto const& client : clients)
+    {
+        if (write(client.start, "!", 1) != 1)
+            perror("Failed to start client");
+    }
+
+    std::this_thread::sleep_for(options.client.warm_up);
+    measurements->start();
+    std::this_thread::sleep_for(options.client.duration);
+    measurements->stop();
+
+    SyntheticClientResults totals;
+    int failed_clients = 0;
+
+    for (auto const& client : clients)
+    {
+        try
+        {
+            auto const results = SyntheticClientResults::read_from(client.results);
+            totals.commits += results.commits;
+            totals.presented += results.presented;
+            totals.discarded += results.discarded;
+            append(totals.commit_to_present, results.commit_to_present);
+            append(totals.frame_intervals, results.frame_intervals);
+        }
+        catch (std::exception const&)
+        {
+            ++failed_clients;
+        }
+
+        int status;
+        waitpid(client.pid, &status, 0);
+    }
+
+    server.stop_server();
+
+    auto const server_results = measurements->results();
+    auto const frames = server_results.frame_times.size();
+    auto const per_frame = [frames](double total) { return frames ? total / frames : 0.0; };
+
+    std::cout << "{\n"
+              << "  \"config\": {"
+              << "\"clients\": " << options.clients
+              << ", \"width\": " << options.client.size.width.as_int()
+              << ", \"height\": " << options.client.size.height.as_int()
+              << ", \"update_rate\": " << options.client.update_rate
+              << ", \"damage\": \"" << name_of(options.client.damage) << "\""
+              << ", \"duration_s\": " << duration<double>{options.client.duration}.count()
+              << "},\n"
+              << "  \"server\": {\n"
+              << "    \"frames\": " << frames << ",\n"
+              << "    \"frame_time_us\": " << distribution_of(server_results.frame_times) << ",\n"
+              << "    \"composite_cpu_us\": " << distribution_of(server_results.cpu_times) << ",\n"
+              << "    \"cpu_per_frame_us\": "
+              << per_frame(duration<double, std::micro>{server_results.process_cpu_time}.count()) << ",\n"
+              << "    \"allocations_per_frame\": " << per_frame(server_results.allocations) << "\n"
+              << "  },\n"
+              << "  \"clients\": {\n"
+              << "    \"failed\": " << failed_clients << ",\n"
+              << "    \"commits\": " << totals.commits << ",\n"
+              << "    \"presented\": " << totals.presented << ",\n"
+              << "    \"discarded\": " << totals.discarded << ",\n"
+              << "    \"commit_to_present_us\": " << distribution_of(totals.commit_to_present) << ",\n"
+              << "    \"frame_interval_us\": " << distribution_of(totals.frame_intervals) << "\n"
+              << "  }\n"
+              << "}" << std::endl;
+
+    return failed_clients ? EXIT_FAILURE : EXIT_SUCCESS;
+}
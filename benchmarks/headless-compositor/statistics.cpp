@@ -0,0 +1,66 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "statistics.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+auto in_microseconds(std::chrono::nanoseconds duration) -> double
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+// Nearest-rank percentile of sorted, non-empty samples
+auto percentile(std::vector<std::chrono::nanoseconds> const& sorted, unsigned percent) -> double
+{
+    auto const rank = (sorted.size() * percent + 99) / 100;
+    return in_microseconds(sorted[std::max<size_t>(rank, 1) - 1]);
+}
+}
+
+auto distribution_of(std::vector<std::chrono::nanoseconds> samples) -> Distribution
+{
+    Distribution result;
+
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+
+    auto const total = std::accumulate(samples.begin(), samples.end(), std::chrono::nanoseconds{0});
+
+    result.samples = samples.size();
+    result.mean = in_microseconds(total) / samples.size();
+    result.p50 = percentile(samples, 50);
+    result.p90 = percentile(samples, 90);
+    result.p99 = percentile(samples, 99);
+    result.max = in_microseconds(samples.back());
+
+    return result;
+}
+
+auto operator<<(std::ostream& out, Distribution const& distribution) -> std::ostream&
+{
+    return out << "{\"samples\": " << distribution.samples
+               << ", \"mean\": " << distribution.mean
+               << ", \"p50\": " << distribution.p50
+               << ", \"p90\": " << distribution.p90
+               << ", \"p99\": " << distribution.p99
+               << ", \"max\": " << distribution.max << "}";
+}
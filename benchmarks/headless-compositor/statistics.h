@@ -0,0 +1,40 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STATISTICS_H_
+#define STATISTICS_H_
+
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+/// Summary of a set of durations, in microseconds
+struct Distribution
+{
+    size_t samples{0};
+    double mean{0};
+    double p50{0};
+    double p90{0};
+    double p99{0};
+    double max{0};
+};
+
+auto distribution_of(std::vector<std::chrono::nanoseconds> samples) -> Distribution;
+
+/// Writes \a distribution as a JSON object
+auto operator<<(std::ostream& out, Distribution const& distribution) -> std::ostream&;
+
+#endif // STATISTICS_H_
@@ -0,0 +1,628 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synthetic_client.h"
+
+#include "mir/anonymous_shm_file.h"
+
+#include <wayland-client.h>
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std::chrono;
+
+namespace
+{
+// The client side of wp_presentation, in lieu of wayland-scanner generated code
+wl_interface const* no_types[] = {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+wl_interface const* sync_output_types[] = {&wl_output_interface};
+
+wl_message const presentation_feedback_events[] = {
+    {"sync_output", "o", sync_output_types},
+    {"presented", "uuuuuuu", no_types},
+    {"discarded", "", no_types}};
+
+wl_interface const presentation_feedback_interface{
+    "wp_presentation_feedback", 1,
+    0, nullptr,
+    3, presentation_feedback_events};
+
+wl_interface const* feedback_types[] = {&wl_surface_interface, &presentation_feedback_interface};
+
+wl_message const presentation_requests[] = {
+    {"destroy", "", no_types},
+    {"feedback", "on", feedback_types}};
+
+wl_message const presentation_events[] = {
+    {"clock_id", "u", no_types}};
+
+wl_interface const presentation_interface{
+    "wp_presentation", 1,
+    2, presentation_requests,
+    1, presentation_events};
+
+uint32_t const presentation_feedback_opcode = 1;
+
+struct PresentationListener
+{
+    void (*clock_id)(void* data, wl_proxy* presentation, uint32_t clock_id);
+};
+
+struct PresentationFeedbackListener
+{
+    void (*sync_output)(void* data, wl_proxy* feedback, wl_proxy* output);
+    void (*presented)(
+        void* data, wl_proxy* feedback,
+        uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+        uint32_t refresh,
+        uint32_t seq_hi, uint32_t seq_lo,
+        uint32_t flags);
+    void (*discarded)(void* data, wl_proxy* feedback);
+};
+
+auto monotonic_now() -> nanoseconds
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return seconds{now.tv_sec} + nanoseconds{now.tv_nsec};
+}
+
+struct Rect
+{
+    int32_t x, y, width, height;
+};
+
+class SyntheticClient
+{
+public:
+    explicit SyntheticClient(SyntheticClientConfig const& config);
+    ~SyntheticClient();
+
+    auto run() -> SyntheticClientResults;
+
+private:
+    struct Buffer
+    {
+        wl_buffer* buffer;
+        uint32_t* pixels;
+        bool busy;
+    };
+
+    struct PendingFeedback
+    {
+        SyntheticClient* client;
+        wl_proxy* feedback;
+        nanoseconds commit_time;
+    };
+
+    void create_surface();
+    void create_buffers();
+
+    auto free_buffer(nanoseconds deadline) -> Buffer*;
+    auto draw(Buffer& buffer, uint64_t frame) -> Rect;
+    void commit(Buffer& buffer, Rect const& damage, nanoseconds commit_time);
+
+    /// Dispatch events until \a done, or returns false at \a deadline
+    bool dispatch_until(std::function<bool()> const& done, nanoseconds deadline);
+
+    void presented(PendingFeedback* pending, nanoseconds timestamp);
+    void discarded(PendingFeedback* pending);
+
+    static void handle_global(void* data, wl_registry* registry, uint32_t name, char const* interface, uint32_t version);
+    static void handle_global_remove(void* data, wl_registry* registry, uint32_t name);
+    static void handle_ping(void* data, wl_shell_surface* shell_surface, uint32_t serial);
+    static void handle_configure(void* data, wl_shell_surface* shell_surface, uint32_t edges, int32_t width, int32_t height);
+    static void handle_popup_done(void* data, wl_shell_surface* shell_surface);
+    static void handle_buffer_release(void* data, wl_buffer* buffer);
+    static void handle_frame_done(void* data, wl_callback* callback, uint32_t time);
+    static void handle_clock_id(void* data, wl_proxy* presentation, uint32_t clock_id);
+    static void handle_sync_output(void* data, wl_proxy* feedback, wl_proxy* output);
+    static void handle_presented(
+        void* data, wl_proxy* feedback,
+        uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+        uint32_t refresh,
+        uint32_t seq_hi, uint32_t seq_lo,
+        uint32_t flags);
+    static void handle_discarded(void* data, wl_proxy* feedback);
+
+    static wl_registry_listener const registry_listener;
+    static wl_shell_surface_listener const shell_surface_listener;
+    static wl_buffer_listener const buffer_listener;
+    static wl_callback_listener const frame_listener;
+    static PresentationListener const presentation_listener;
+    static PresentationFeedbackListener const presentation_feedback_listener;
+
+    SyntheticClientConfig const config;
+    int32_t const width;
+    int32_t const height;
+    int32_t const stride;
+
+    wl_display* const display;
+    wl_registry* registry{nullptr};
+    wl_compositor* compositor{nullptr};
+    wl_shm* shm{nullptr};
+    wl_shell* shell{nullptr};
+    wl_proxy* presentation{nullptr};
+    bool presentation_clock_is_monotonic{false};
+
+    wl_surface* surface{nullptr};
+    wl_shell_surface* shell_surface{nullptr};
+
+    std::unique_ptr<mir::AnonymousShmFile> shm_file;
+    wl_shm_pool* pool{nullptr};
+    std::array<Buffer, 3> buffers{};
+
+    bool frame_done{true};
+    nanoseconds measure_from{0};
+    nanoseconds last_presented{0};
+    uint64_t pending_feedback{0};
+
+    SyntheticClientResults results;
+};
+
+wl_registry_listener const SyntheticClient::registry_listener{
+    &SyntheticClient::handle_global,
+    &SyntheticClient::handle_global_remove};
+
+wl_shell_surface_listener const SyntheticClient::shell_surface_listener{
+    &SyntheticClient::handle_ping,
+    &SyntheticClient::handle_configure,
+    &SyntheticClient::handle_popup_done};
+
+wl_buffer_listener const SyntheticClient::buffer_listener{
+    &SyntheticClient::handle_buffer_release};
+
+wl_callback_listener const SyntheticClient::frame_listener{
+    &SyntheticClient::handle_frame_done};
+
+PresentationListener const SyntheticClient::presentation_listener{
+    &SyntheticClient::handle_clock_id};
+
+PresentationFeedbackListener const SyntheticClient::presentation_feedback_listener{
+    &SyntheticClient::handle_sync_output,
+    &SyntheticClient::handle_presented,
+    &SyntheticClient::handle_discarded};
+
+SyntheticClient::SyntheticClient(SyntheticClientConfig const& config) :
+    config{config},
+    width{config.size.width.as_int()},
+    height{config.size.height.as_int()},
+    stride{4 * config.size.width.as_int()},
+    display{wl_display_connect(nullptr)}
+{
+    if (!display)
+        BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to connect to Wayland server"));
+
+    registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &registry_listener, this);
+    wl_display_roundtrip(display);
+
+    if (!compositor || !shm || !shell)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Server lacks wl_compositor, wl_shm or wl_shell"));
+
+    // Collect the clock_id event
+    wl_display_roundtrip(display);
+
+    create_surface();
+    create_buffers();
+}
+
+SyntheticClient::~SyntheticClient()
+{
+    for (auto const& buffer : buffers)
+    {
+        if (buffer.buffer)
+            wl_buffer_destroy(buffer.buffer);
+    }
+
+    if (pool) wl_shm_pool_destroy(pool);
+    if (shell_surface) wl_shell_surface_destroy(shell_surface);
+    if (surface) wl_surface_destroy(surface);
+    if (presentation) wl_proxy_destroy(presentation);
+    if (shell) wl_shell_destroy(shell);
+    if (shm) wl_shm_destroy(shm);
+    if (compositor) wl_compositor_destroy(compositor);
+    if (registry) wl_registry_destroy(registry);
+
+    wl_display_disconnect(display);
+}
+
+void SyntheticClient::create_surface()
+{
+    surface = wl_compositor_create_surface(compositor);
+    shell_surface = wl_shell_get_shell_surface(shell, surface);
+    wl_shell_surface_add_listener(shell_surface, &shell_surface_listener, this);
+    wl_shell_surface_set_toplevel(shell_surface);
+}
+
+void SyntheticClient::create_buffers()
+{
+    auto const buffer_size = stride * height;
+
+    shm_file = std::make_unique<mir::AnonymousShmFile>(buffer_size * buffers.size());
+    pool = wl_shm_create_pool(shm, shm_file->fd(), buffer_size * buffers.size());
+
+    auto const base = static_cast<char*>(shm_file->base_ptr());
+
+    for (size_t i = 0; i != buffers.size(); ++i)
+    {
+        auto& buffer = buffers[i];
+        buffer.buffer = wl_shm_pool_create_buffer(
+            pool, i * buffer_size, width, height, stride, WL_SHM_FORMAT_XRGB8888);
+        buffer.pixels = reinterpret_cast<uint32_t*>(base + i * buffer_size);
+        buffer.busy = false;
+        wl_buffer_add_listener(buffer.buffer, &buffer_listener, &buffer);
+    }
+}
+
+auto SyntheticClient::run() -> SyntheticClientResults
+{
+    auto const start = monotonic_now();
+    measure_from = start + config.warm_up;
+    auto const end = measure_from + config.duration;
+
+    nanoseconds const period{config.update_rate > 0 ? nanoseconds{seconds{1}} / config.update_rate : nanoseconds{0}};
+    auto next_frame = start;
+
+    for (uint64_t frame = 0; monotonic_now() < end; ++frame)
+    {
+        auto const buffer = free_buffer(end);
+        if (!buffer)
+            break;
+
+        auto const damage = draw(*buffer, frame);
+        commit(*buffer, damage, monotonic_now());
+
+        if (!dispatch_until([this] { return frame_done; }, end))
+            break;
+
+        if (period != nanoseconds{0})
+        {
+            next_frame += period;
+
+            auto const now = monotonic_now();
+            if (next_frame > now)
+                std::this_thread::sleep_for(next_frame - now);
+            else
+                next_frame = now;   // Don't try to catch up on missed frames
+        }
+    }
+
+    // Give the compositor a chance to report on the last few frames
+    dispatch_until([this] { return pending_feedback == 0; }, monotonic_now() + milliseconds{500});
+
+    return std::move(results);
+}
+
+auto SyntheticClient::free_buffer(nanoseconds deadline) -> Buffer*
+{
+    Buffer* result{nullptr};
+
+    dispatch_until(
+        [this, &result]
+        {
+            auto const free = std::find_if(
+                buffers.begin(), buffers.end(), [](Buffer const& buffer) { return !buffer.busy; });
+
+            result = free != buffers.end() ? &*free : nullptr;
+            return result != nullptr;
+        },
+        deadline);
+
+    return result;
+}
+
+auto SyntheticClient::draw(Buffer& buffer, uint64_t frame) -> Rect
+{
+    // The first frame has to cover the whole surface (and the other buffers
+    // start out blank, which doesn't matter for our purposes)
+    auto const pattern = frame == 0 ? DamagePattern::full : config.damage;
+    auto const colour = static_cast<uint32_t>(0xff000000 | (frame * 0x010307));
+
+    Rect damage{0, 0, width, height};
+
+    switch (pattern)
+    {
+    case DamagePattern::full:
+        break;
+
+    case DamagePattern::strip:
+    {
+        auto const strip_height = std::max(height / 16, 1);
+        damage = Rect{0, static_cast<int32_t>((frame * strip_height) % height), width, strip_height};
+        break;
+    }
+
+    case DamagePattern::square:
+    {
+        auto const side = std::min({64, width, height});
+        damage = Rect{
+            static_cast<int32_t>((frame * 8) % (width - side + 1)),
+            static_cast<int32_t>((frame * 8) % (height - side + 1)),
+            side, side};
+        break;
+    }
+    }
+
+    damage.height = std::min(damage.height, height - damage.y);
+
+    for (auto y = damage.y; y != damage.y + damage.height; ++y)
+    {
+        auto const row = buffer.pixels + y * width;
+        std::fill(row + damage.x, row + damage.x + damage.width, colour);
+    }
+
+    return damage;
+}
+
+void SyntheticClient::commit(Buffer& buffer, Rect const& damage, nanoseconds commit_time)
+{
+    frame_done = false;
+    wl_callback_add_listener(wl_surface_frame(surface), &frame_listener, this);
+
+    if (presentation)
+    {
+        auto const feedback = wl_proxy_marshal_constructor(
+            presentation, presentation_feedback_opcode, &presentation_feedback_interface, surface, nullptr);
+
+        auto const pending = new PendingFeedback{this, feedback, commit_time};
+        wl_proxy_add_listener(
+            feedback,
+            reinterpret_cast<void(**)(void)>(const_cast<PresentationFeedbackListener*>(&presentation_feedback_listener)),
+            pending);
+        ++pending_feedback;
+    }
+
+    wl_surface_attach(surface, buffer.buffer, 0, 0);
+    wl_surface_damage(surface, damage.x, damage.y, damage.width, damage.height);
+    wl_surface_commit(surface);
+    buffer.busy = true;
+
+    if (commit_time >= measure_from)
+        ++results.commits;
+}
+
+bool SyntheticClient::dispatch_until(std::function<bool()> const& done, nanoseconds deadline)
+{
+    while (!done())
+    {
+        while (wl_display_prepare_read(display) != 0)
+            wl_display_dispatch_pending(display);
+
+        wl_display_flush(display);
+
+        auto const timeout = duration_cast<milliseconds>(deadline - monotonic_now());
+        if (timeout <= milliseconds{0})
+        {
+            wl_display_cancel_read(display);
+            return done();
+        }
+
+        pollfd fd{wl_display_get_fd(display), POLLIN, 0};
+        if (poll(&fd, 1, timeout.count()) > 0)
+            wl_display_read_events(display);
+        else
+            wl_display_cancel_read(display);
+
+        if (wl_display_dispatch_pending(display) < 0)
+            BOOST_THROW_EXCEPTION(std::system_error(wl_display_get_error(display), std::system_category(), "Lost connection to Wayland server"));
+    }
+
+    return true;
+}
+
+void SyntheticClient::presented(PendingFeedback* pending, nanoseconds timestamp)
+{
+    if (pending->commit_time >= measure_from)
+    {
+        ++results.presented;
+
+        if (presentation_clock_is_monotonic)
+            results.commit_to_present.push_back(timestamp - pending->commit_time);
+
+        if (last_presented != nanoseconds{0})
+            results.frame_intervals.push_back(timestamp - last_presented);
+    }
+
+    last_presented = timestamp;
+}
+
+void SyntheticClient::discarded(PendingFeedback* pending)
+{
+    if (pending->commit_time >= measure_from)
+        ++results.discarded;
+}
+
+void SyntheticClient::handle_global(
+    void* data, wl_registry* registry, uint32_t name, char const* interface, uint32_t /*version*/)
+{
+    auto const self = static_cast<SyntheticClient*>(data);
+
+    if (strcmp(interface, wl_compositor_interface.name) == 0)
+    {
+        self->compositor = static_cast<wl_compositor*>(wl_registry_bind(registry, name, &wl_compositor_interface, 1));
+    }
+    else if (strcmp(interface, wl_shm_interface.name) == 0)
+    {
+        self->shm = static_cast<wl_shm*>(wl_registry_bind(registry, name, &wl_shm_interface, 1));
+    }
+    else if (strcmp(interface, wl_shell_interface.name) == 0)
+    {
+        self->shell = static_cast<wl_shell*>(wl_registry_bind(registry, name, &wl_shell_interface, 1));
+    }
+    else if (strcmp(interface, presentation_interface.name) == 0)
+    {
+        self->presentation = static_cast<wl_proxy*>(wl_registry_bind(registry, name, &presentation_interface, 1));
+        wl_proxy_add_listener(
+            self->presentation,
+            reinterpret_cast<void(**)(void)>(const_cast<PresentationListener*>(&presentation_listener)),
+            self);
+    }
+}
+
+void SyntheticClient::handle_global_remove(void*, wl_registry*, uint32_t)
+{
+}
+
+void SyntheticClient::handle_ping(void*, wl_shell_surface* shell_surface, uint32_t serial)
+{
+    wl_shell_surface_pong(shell_surface, serial);
+}
+
+void SyntheticClient::handle_configure(void*, wl_shell_surface*, uint32_t, int32_t, int32_t)
+{
+}
+
+void SyntheticClient::handle_popup_done(void*, wl_shell_surface*)
+{
+}
+
+void SyntheticClient::handle_buffer_release(void* data, wl_buffer*)
+{
+    static_cast<Buffer*>(data)->busy = false;
+}
+
+void SyntheticClient::handle_frame_done(void* data, wl_callback* callback, uint32_t)
+{
+    static_cast<SyntheticClient*>(data)->frame_done = true;
+    wl_callback_destroy(callback);
+}
+
+void SyntheticClient::handle_clock_id(void* data, wl_proxy*, uint32_t clock_id)
+{
+    static_cast<SyntheticClient*>(data)->presentation_clock_is_monotonic = (clock_id == CLOCK_MONOTONIC);
+}
+
+void SyntheticClient::handle_sync_output(void*, wl_proxy*, wl_proxy*)
+{
+}
+
+void SyntheticClient::handle_presented(
+    void* data, wl_proxy* feedback,
+    uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+    uint32_t /*refresh*/,
+    uint32_t /*seq_hi*/, uint32_t /*seq_lo*/,
+    uint32_t /*flags*/)
+{
+    auto const pending = static_cast<PendingFeedback*>(data);
+    auto const tv_sec = (uint64_t{tv_sec_hi} << 32) | tv_sec_lo;
+
+    pending->client->presented(pending, seconds{tv_sec} + nanoseconds{tv_nsec});
+    --pending->client->pending_feedback;
+
+    wl_proxy_destroy(feedback);
+    delete pending;
+}
+
+void SyntheticClient::handle_discarded(void* data, wl_proxy* feedback)
+{
+    auto const pending = static_cast<PendingFeedback*>(data);
+
+    pending->client->discarded(pending);
+    --pending->client->pending_feedback;
+
+    wl_proxy_destroy(feedback);
+    delete pending;
+}
+
+void write_all(int fd, void const* data, size_t size)
+{
+    auto const bytes = static_cast<char const*>(data);
+
+    for (size_t written = 0; written != size;)
+    {
+        auto const result = ::write(fd, bytes + written, size - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to write results"));
+        }
+        written += result;
+    }
+}
+
+void read_all(int fd, void* data, size_t size)
+{
+    auto const bytes = static_cast<char*>(data);
+
+    for (size_t read = 0; read != size;)
+    {
+        auto const result = ::read(fd, bytes + read, size - read);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            BOOST_THROW_EXCEPTION(std::runtime_error("Failed to read client results"));
+        read += result;
+    }
+}
+
+void write_durations(int fd, std::vector<nanoseconds> const& durations)
+{
+    uint64_t const count = durations.size();
+    write_all(fd, &count, sizeof count);
+    write_all(fd, durations.data(), count * sizeof(nanoseconds));
+}
+
+auto read_durations(int fd) -> std::vector<nanoseconds>
+{
+    uint64_t count;
+    read_all(fd, &count, sizeof count);
+
+    std::vector<nanoseconds> durations(count);
+    read_all(fd, durations.data(), count * sizeof(nanoseconds));
+    return durations;
+}
+}
+
+void SyntheticClientResults::write_to(int fd) const
+{
+    uint64_t const counts[] = {commits, presented, discarded};
+    write_all(fd, counts, sizeof counts);
+    write_durations(fd, commit_to_present);
+    write_durations(fd, frame_intervals);
+}
+
+auto SyntheticClientResults::read_from(int fd) -> SyntheticClientResults
+{
+    SyntheticClientResults results;
+
+    uint64_t counts[3];
+    read_all(fd, counts, sizeof counts);
+    results.commits = counts[0];
+    results.presented = counts[1];
+    results.discarded = counts[2];
+    results.commit_to_present = read_durations(fd);
+    results.frame_intervals = read_durations(fd);
+
+    return results;
+}
+
+auto run_synthetic_client(SyntheticClientConfig const& config) -> SyntheticClientResults
+{
+    return SyntheticClient{config}.run();
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHETIC_CLIENT_H_
+#define SYNTHETIC_CLIENT_H_
+
+#include "mir/geometry/size.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/// What each frame of a synthetic client redraws (and damages)
+enum class DamagePattern
+{
+    full,   ///< The whole buffer
+    strip,  ///< A full width strip, 1/16th of the height, moving down
+    square  ///< A 64x64 square, moving diagonally
+};
+
+struct SyntheticClientConfig
+{
+    mir::geometry::Size size;
+    /// Frames per second to aim for; 0 draws as fast as frame callbacks allow
+    int update_rate;
+    DamagePattern damage;
+    /// Frames committed during the warm up are not measured
+    std::chrono::nanoseconds warm_up;
+    std::chrono::nanoseconds duration;
+};
+
+struct SyntheticClientResults
+{
+    uint64_t commits{0};
+    uint64_t presented{0};
+    uint64_t discarded{0};
+    /// From wl_surface.commit to the wp_presentation_feedback.presented timestamp
+    std::vector<std::chrono::nanoseconds> commit_to_present;
+    /// Between consecutive presented frames
+    std::vector<std::chrono::nanoseconds> frame_intervals;
+
+    void write_to(int fd) const;
+    static auto read_from(int fd) -> SyntheticClientResults;
+};
+
+/// Draws into wl_shm buffers on a wl_shell surface, connecting to $WAYLAND_DISPLAY
+auto run_synthetic_client(SyntheticClientConfig const& config) -> SyntheticClientResults;
+
+#endif // SYNTHETIC_CLIENT_H_
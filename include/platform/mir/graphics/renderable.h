@@ -21,6 +21,8 @@
 
 #include <experimental/optional>
 #include <mir/geometry/rectangle.h>
+#include <mir/geometry/rectangles.h>
+#include <mir/graphics/buffer_id.h>
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -73,6 +75,24 @@ public:
     virtual bool shaped() const = 0;  // meaning the pixel format has alpha
 
     virtual unsigned int swap_interval() const = 0;
+
+    /**
+     * Return the region of buffer() (in buffer coordinates) that differs
+     * from the buffer identified by \a previous.
+     *
+     * If the difference is not known (for example \a previous is too old, or
+     * the client did not supply damage) return nullopt and the whole
+     * renderable is treated as damaged.
+     */
+    virtual auto damage_since(BufferID previous) const
+        -> std::experimental::optional<geometry::Rectangles> = 0;
+
+    /**
+     * Return the parts of the renderable (in screen coordinates) that are
+     * known to be opaque even though shaped() is true, typically because the
+     * client said so. Empty if nothing is known to be opaque.
+     */
+    virtual auto opaque_region() const -> geometry::Rectangles = 0;
 protected:
     Renderable() = default;
     Renderable(Renderable const&) = delete;
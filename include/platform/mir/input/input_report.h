@@ -27,6 +27,15 @@ namespace mir
 namespace input
 {
 
+/// The points on its way from the kernel to a client at which an input event is reported
+enum class InputEventStage
+{
+    platform,   ///< Converted to a MirEvent by the input platform
+    seat,       ///< Dispatched by the seat
+    surface,    ///< Dispatched to a surface
+    client,     ///< Sent to the client
+};
+
 class InputReport
 {
 public:
@@ -41,6 +50,9 @@ public:
     virtual void opened_input_device(char const* device_name, char const* input_platform) = 0;
     virtual void failed_to_open_input_device(char const* device_name, char const* input_platform) = 0;
 
+    /// The event of \a device_id generated at \a event_time (CLOCK_MONOTONIC nanoseconds) has reached \a stage
+    virtual void input_event_reached(InputEventStage stage, int64_t device_id, int64_t event_time) = 0;
+
 protected:
     InputReport() = default;
     InputReport(InputReport const&) = delete;
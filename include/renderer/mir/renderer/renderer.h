@@ -20,6 +20,7 @@
 #define MIR_RENDERER_RENDERER_H_
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/graphics/renderable.h"
 #include "mir_toolkit/common.h"
 #include <glm/glm.hpp>
@@ -36,6 +37,13 @@ public:
 
     virtual void set_viewport(geometry::Rectangle const& rect) = 0;
     virtual void set_output_transform(glm::mat2 const&) = 0;
+    /**
+     * The area (in screen coordinates) that changed since the previous
+     * render(). Renderers may use this to avoid redrawing the rest of the
+     * viewport; it applies to the next render() only, after which the whole
+     * viewport is assumed damaged again.
+     */
+    virtual void set_damage(geometry::Rectangles const& damage) = 0;
     virtual void render(graphics::RenderableList const&) const = 0;
     virtual void suspend() = 0; // called when render() is skipped
 
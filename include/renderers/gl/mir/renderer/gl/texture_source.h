@@ -19,6 +19,8 @@
 #ifndef MIR_RENDERER_GL_TEXTURE_SOURCE_H_
 #define MIR_RENDERER_GL_TEXTURE_SOURCE_H_
 
+#include "mir/geometry/rectangles.h"
+
 namespace mir
 {
 namespace renderer
@@ -49,6 +51,28 @@ protected:
     TextureSource& operator=(TextureSource const&) = delete;
 };
 
+/**
+ * Implemented by TextureSources that can update a texture in place when only
+ * part of their content differs from what the texture already holds.
+ */
+class IncrementalTextureSource
+{
+public:
+    virtual ~IncrementalTextureSource() = default;
+
+    /**
+     * Update the currently bound texture, which holds the content of an
+     * earlier buffer of the same size and format, by uploading only the
+     * \a damage (in buffer coordinates).
+     */
+    virtual void update_texture(geometry::Rectangles const& damage) = 0;
+
+protected:
+    IncrementalTextureSource() = default;
+    IncrementalTextureSource(IncrementalTextureSource const&) = delete;
+    IncrementalTextureSource& operator=(IncrementalTextureSource const&) = delete;
+};
+
 }
 }
 }
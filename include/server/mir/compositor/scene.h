@@ -72,6 +72,14 @@ public:
     virtual void register_compositor(CompositorID id) = 0;
     virtual void unregister_compositor(CompositorID id) = 0;
 
+    /**
+     * Let the scene know that the registered compositor \a id only draws
+     * \a view_area (in screen coordinates), so that scene_elements_for() may
+     * leave out surfaces that are entirely outside it. Compositors that
+     * don't set a view area are given the whole scene.
+     */
+    virtual void set_view_area(CompositorID id, geometry::Rectangle const& view_area) = 0;
+
     virtual void add_observer(std::shared_ptr<scene::Observer> const& observer) = 0;
     virtual void remove_observer(std::weak_ptr<scene::Observer> const& observer) = 0;
 
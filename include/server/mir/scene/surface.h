@@ -41,6 +41,7 @@ struct StreamInfo
     std::shared_ptr<compositor::BufferStream> stream;
     geometry::Displacement displacement;
     optional_value<geometry::Size> size;
+    geometry::Rectangles opaque_region{}; ///< Relative to the stream's top left; empty if unknown
 };
 
 class SurfaceObserver;
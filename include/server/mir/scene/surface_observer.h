@@ -40,6 +40,10 @@ namespace graphics
 {
 class CursorImage;
 }
+namespace compositor
+{
+class BufferStream;
+}
 
 namespace scene
 {
@@ -74,6 +78,14 @@ public:
     virtual void start_drag_and_drop(Surface const* surf, std::vector<uint8_t> const& handle) = 0;
     virtual void depth_layer_set_to(Surface const* surf, MirDepthLayer depth_layer) = 0;
     virtual void application_id_set_to(Surface const* surf, std::string const& application_id) = 0;
+    /// Not pure, so that observers written before it was added still build
+    virtual void input_region_set_to(Surface const* /*surf*/, std::vector<geometry::Rectangle> const& /*region*/) {}
+    /// Which of the surface's streams posted the frame next notified to frame_posted()
+    /// Not pure, so that observers written before it was added still build
+    virtual void stream_frame_posted(
+        Surface const* /*surf*/,
+        compositor::BufferStream const* /*stream*/,
+        geometry::Size const& /*size*/) {}
 
 protected:
     SurfaceObserver() = default;
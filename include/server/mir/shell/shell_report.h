@@ -22,6 +22,8 @@
 #include "mir/frontend/surface_id.h"
 #include "mir_toolkit/common.h"
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <set>
 
@@ -83,6 +85,9 @@ public:
 
     virtual void surfaces_raised(SurfaceSet const& surfaces) = 0;
 
+    /// A thread waited \a wait for the window manager's lock, which has now been contended \a times in all
+    virtual void window_manager_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times) = 0;
+
     ShellReport() = default;
     virtual ~ShellReport() = default;
     ShellReport(ShellReport const&) = delete;
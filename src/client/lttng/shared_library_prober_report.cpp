@@ -48,3 +48,16 @@ void mcl::lttng::SharedLibraryProberReport::loading_failed(boost::filesystem::pa
     mir_tracepoint(mir_client_shared_library_prober, loading_failed,
                    filename.string().c_str(), error.what());
 }
+
+void mcl::lttng::SharedLibraryProberReport::loading_cached_library(boost::filesystem::path const& filename)
+{
+    mir_tracepoint(mir_client_shared_library_prober, loading_cached_library,
+                   filename.string().c_str());
+}
+
+void mcl::lttng::SharedLibraryProberReport::probing_finished(boost::filesystem::path const& path, std::chrono::steady_clock::duration elapsed)
+{
+    mir_tracepoint(mir_client_shared_library_prober, probing_finished,
+                   path.string().c_str(),
+                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
@@ -36,14 +36,88 @@
 
 #include <capnp/serialize.h>
 
+#include <mutex>
+#include <new>
+#include <vector>
 
 namespace ml = mir::logging;
 
+namespace
+{
+/// Keeps the storage of deleted events for reuse by the next ones
+class EventStoragePool
+{
+public:
+    EventStoragePool()
+    {
+        free_blocks.reserve(max_free_blocks);
+    }
+
+    auto allocate() -> void*
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!free_blocks.empty())
+            {
+                auto const block = free_blocks.back();
+                free_blocks.pop_back();
+                return block;
+            }
+        }
+
+        return ::operator new(sizeof(MirEvent));
+    }
+
+    void release(void* block)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (free_blocks.size() < max_free_blocks)
+            {
+                free_blocks.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block);
+    }
+
+private:
+    // Bounds what a burst of events (or a stalled client) leaves behind
+    static std::size_t const max_free_blocks = 256;
+
+    std::mutex mutex;
+    std::vector<void*> free_blocks;
+};
+
+auto storage_pool() -> EventStoragePool&
+{
+    // Never destroyed: events may be deleted by other static destructors
+    static auto const pool = new EventStoragePool;
+    return *pool;
+}
+}
+
+void* MirEvent::operator new(std::size_t size)
+{
+    // Every event type is a MirEvent with a different interface
+    if (size == sizeof(MirEvent))
+        return storage_pool().allocate();
+
+    return ::operator new(size);
+}
+
+void MirEvent::operator delete(void* event, std::size_t size)
+{
+    if (size == sizeof(MirEvent))
+        storage_pool().release(event);
+    else
+        ::operator delete(event);
+}
+
 MirEvent::MirEvent(MirEvent const& e)
+    : event{(message.setRoot(e.event.asReader()), message.getRoot<mir::capnp::Event>())}
 {
-    auto reader = e.event.asReader();
-    message.setRoot(reader);
-    event = message.getRoot<mir::capnp::Event>();
 }
 
 MirEvent& MirEvent::operator=(MirEvent const& e)
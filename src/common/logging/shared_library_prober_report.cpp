@@ -57,3 +57,21 @@ void ml::SharedLibraryProberReport::loading_failed(boost::filesystem::path const
                 " (error was:" + error.what() + ")",
                 MIR_LOG_COMPONENT);
 }
+
+void ml::SharedLibraryProberReport::loading_cached_library(boost::filesystem::path const& filename)
+{
+    logger->log(ml::Severity::informational,
+                std::string("Loading cached module: ") + filename.string(),
+                MIR_LOG_COMPONENT);
+}
+
+void ml::SharedLibraryProberReport::probing_finished(
+    boost::filesystem::path const& path, std::chrono::steady_clock::duration elapsed)
+{
+    auto const elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+
+    logger->log(ml::Severity::informational,
+                std::string("Selected module from: ") + path.string() +
+                " in " + std::to_string(elapsed_us) + "us",
+                MIR_LOG_COMPONENT);
+}
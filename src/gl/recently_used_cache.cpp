@@ -42,9 +42,31 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
 
     if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
     {
-        texture_source->bind();
+        auto const incremental_source =
+            dynamic_cast<mrgl::IncrementalTextureSource*>(buffer->native_buffer_base());
+
+        // If the texture holds an older buffer of the same shape we only need to upload what changed.
+        // That older buffer must have been uploaded too: we can't write into storage that an EGLImage owns.
+        std::experimental::optional<geom::Rectangles> damage;
+        if (incremental_source &&
+            texture.valid_binding &&
+            texture.last_bound_incrementally &&
+            texture.last_bound_size == buffer->size() &&
+            texture.last_bound_format == buffer->pixel_format())
+        {
+            damage = renderable.damage_since(texture.last_bound_buffer);
+        }
+
+        if (damage)
+            incremental_source->update_texture(damage.value());
+        else
+            texture_source->bind();
+
         texture.resource = buffer;
         texture.last_bound_buffer = buffer_id;
+        texture.last_bound_size = buffer->size();
+        texture.last_bound_format = buffer->pixel_format();
+        texture.last_bound_incrementally = incremental_source != nullptr;
     }
     texture_source->secure_for_render();
 
@@ -23,6 +23,8 @@
 #include "mir/gl/texture_cache.h"
 #include "mir/gl/texture.h"
 #include "mir/graphics/buffer_id.h"
+#include "mir/geometry/size.h"
+#include "mir_toolkit/common.h"
 #include "mir/graphics/renderable.h"
 #include <unordered_map>
 
@@ -46,6 +48,9 @@ private:
         {}
         std::shared_ptr<Texture> texture;
         graphics::BufferID last_bound_buffer;
+        geometry::Size last_bound_size;
+        MirPixelFormat last_bound_format{mir_pixel_format_invalid};
+        bool last_bound_incrementally{false}; ///< The texture's storage is ours, not an EGLImage's
         bool used{true};
         bool valid_binding{false};
         std::shared_ptr<graphics::Buffer> resource;
@@ -25,6 +25,7 @@
 
 #include <capnp/message.h>
 
+#include <cstddef>
 #include <cstring>
 
 struct MirEvent
@@ -73,10 +74,22 @@ struct MirEvent
     static mir::EventUPtr deserialize(std::string const& bytes);
     static std::string serialize(MirEvent const* event);
 
+    // Event storage is recycled rather than returned to the heap: input
+    // devices produce a steady stream of short lived events.
+    static void* operator new(std::size_t size);
+    static void operator delete(void* event, std::size_t size);
+
 protected:
     MirEvent() = default;
 
-    ::capnp::MallocMessageBuilder message;
+private:
+    // Enough for any input event, so that building one doesn't allocate a
+    // message segment. Larger events (e.g. keymaps) overflow onto the heap.
+    static std::size_t const inline_segment_words = 128;
+    ::capnp::word inline_segment[inline_segment_words]{};
+
+protected:
+    ::capnp::MallocMessageBuilder message{kj::arrayPtr(inline_segment, inline_segment_words)};
     mir::capnp::Event::Builder event{message.initRoot<mir::capnp::Event>()};
 };
 
@@ -37,6 +37,9 @@ public:
     void probing_failed(boost::filesystem::path const& path, std::exception const& error) override;
     void loading_library(boost::filesystem::path const& filename) override;
     void loading_failed(boost::filesystem::path const& filename, std::exception const& error) override;
+    void loading_cached_library(boost::filesystem::path const& filename) override;
+    void probing_finished(
+        boost::filesystem::path const& path, std::chrono::steady_clock::duration elapsed) override;
 
 private:
     std::shared_ptr<Logger> const logger;
@@ -21,6 +21,8 @@
 
 #include <boost/filesystem.hpp>
 
+#include <chrono>
+
 namespace mir
 {
 class SharedLibraryProberReport
@@ -32,6 +34,11 @@ public:
     virtual void probing_failed(boost::filesystem::path const& path, std::exception const& error) = 0;
     virtual void loading_library(boost::filesystem::path const& filename) = 0;
     virtual void loading_failed(boost::filesystem::path const& filename, std::exception const& error) = 0;
+    /// The library that was selected from the path last time is being loaded instead of probing the path
+    virtual void loading_cached_library(boost::filesystem::path const& filename) = 0;
+    /// A library has been selected from path, \a elapsed after loading from it started
+    virtual void probing_finished(
+        boost::filesystem::path const& path, std::chrono::steady_clock::duration elapsed) = 0;
 
 protected:
     SharedLibraryProberReport() = default;
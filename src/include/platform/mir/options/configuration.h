@@ -50,6 +50,7 @@ extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
+extern char const* const composite_before_vblank_opt;
 extern char const* const enable_key_repeat_opt;
 extern char const* const x11_display_opt;
 extern char const* const wayland_extensions_opt;
@@ -67,6 +68,8 @@ extern char const* const lttng_opt_value;
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
 extern char const* const platform_path;
+extern char const* const platform_probe_cache;
+extern char const* const startup_trace_opt;
 
 extern char const* const console_provider;
 extern char const* const logind_console;
@@ -21,10 +21,12 @@
 #define MIR_COMPOSITOR_BUFFER_STREAM_H_
 
 #include "mir/geometry/size.h"
+#include "mir/geometry/rectangles.h"
 #include "mir/frontend/buffer_stream.h"
 #include "mir_toolkit/common.h"
 #include "mir/graphics/buffer_id.h"
 
+#include <experimental/optional>
 #include <memory>
 
 namespace mir
@@ -42,6 +44,24 @@ class BufferStream : public frontend::BufferStream
 public:
     virtual ~BufferStream() = default;
 
+    using frontend::BufferStream::submit_buffer;
+
+    /**
+     * Submit a buffer along with the region (in buffer coordinates) that
+     * changed since the previously submitted buffer.
+     */
+    virtual void submit_buffer(
+        std::shared_ptr<graphics::Buffer> const& buffer,
+        geometry::Rectangles const& damage) = 0;
+
+    /**
+     * The region (in buffer coordinates) that changed between the submission
+     * of buffer \a since and the submission of buffer \a until, or nullopt
+     * if this is not known.
+     */
+    virtual auto damage_between(graphics::BufferID since, graphics::BufferID until) const
+        -> std::experimental::optional<geometry::Rectangles> = 0;
+
     virtual auto lock_compositor_buffer(void const* user_id) -> std::shared_ptr<graphics::Buffer> = 0;
     virtual auto stream_size() -> geometry::Size = 0;
     virtual auto buffers_ready_for_compositor(void const* user_id) const -> int = 0;
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_PRESENTATION_H_
+#define MIR_COMPOSITOR_FRAME_PRESENTATION_H_
+
+#include "mir/graphics/frame.h"
+#include "mir/graphics/display_configuration.h"
+
+#include <chrono>
+#include <experimental/optional>
+#include <functional>
+#include <vector>
+
+namespace mir
+{
+namespace compositor
+{
+/// When, and on which output, a composited frame reached the screen
+struct FramePresentation
+{
+    /// The (CLOCK_MONOTONIC) time the frame was shown, and its sequence number (if known)
+    graphics::Frame frame;
+    /// The refresh interval of the output, or zero if that is unknown
+    std::chrono::nanoseconds refresh_interval{0};
+    /// The output whose refresh the frame was synchronised to, if known
+    std::experimental::optional<graphics::DisplayConfigurationOutputId> output;
+    /// Whether the frame time came from the display hardware, rather than a clock read after posting
+    bool hardware_clock{false};
+};
+
+/**
+ * Runs \a work once the frame being composited on the calling thread reaches
+ * the screen.
+ *
+ * Buffers are consumed by a compositing thread while it renders a frame, some
+ * time before that frame is posted to the display. Buffer consumers (such as
+ * the frontend) use this to defer notifications until it has been. When the
+ * calling thread is not compositing (for example, when taking a screenshot)
+ * \a work runs straight away, with the current time.
+ */
+void on_frame_presented(std::function<void(FramePresentation const&)>&& work);
+
+/**
+ * Collects the on_frame_presented() work of a compositing thread while it
+ * exists. There can be only one per thread at a time.
+ */
+class FramePresentationScope
+{
+public:
+    FramePresentationScope();
+    /// Runs any outstanding work, with the current time
+    ~FramePresentationScope();
+
+    bool empty() const { return pending.empty(); }
+
+    /// Runs the work deferred while compositing the frame that has just been posted
+    void presented(FramePresentation const& presentation);
+
+private:
+    FramePresentationScope(FramePresentationScope const&) = delete;
+    FramePresentationScope& operator=(FramePresentationScope const&) = delete;
+
+    std::vector<std::function<void(FramePresentation const&)>> pending;
+};
+}
+}
+
+#endif /* MIR_COMPOSITOR_FRAME_PRESENTATION_H_ */
@@ -19,6 +19,7 @@
 #define MIR_DEFAULT_SERVER_CONFIGURATION_H_
 
 #include "mir/cached_ptr.h"
+#include "mir/startup_trace.h"
 #include "mir/extension_description.h"
 #include "mir/server_configuration.h"
 #include "mir/shell/window_manager_builder.h"
@@ -31,6 +32,7 @@ namespace mir
 class ServerActionQueue;
 class SharedLibrary;
 class SharedLibraryProberReport;
+class PlatformProbeCache;
 
 template<class Observer>
 class ObserverRegistrar;
@@ -362,6 +364,7 @@ public:
     virtual std::shared_ptr<time::Clock> the_clock();
     virtual std::shared_ptr<ServerActionQueue> the_server_action_queue();
     virtual std::shared_ptr<SharedLibraryProberReport>  the_shared_library_prober_report();
+    virtual std::shared_ptr<PlatformProbeCache> the_platform_probe_cache();
 
     virtual std::shared_ptr<ConsoleServices> the_console_services();
     auto default_reports() -> std::shared_ptr<void>;
@@ -373,6 +376,10 @@ private:
     std::shared_ptr<mir::SharedLibrary> platform_library;
 
 protected:
+    /// The components are cached in CachedPtrs that time their construction when tracing startup
+    template<typename Type>
+    using CachedPtr = startup_trace::CachedPtr<Type>;
+
     std::shared_ptr<options::Option> the_options() const;
     std::shared_ptr<graphics::nested::MirClientHostConnection>  the_mir_client_host_connection();
     std::shared_ptr<input::DefaultInputDeviceHub>  the_default_input_device_hub();
@@ -463,6 +470,7 @@ protected:
     CachedPtr<shell::HostLifecycleEventListener> host_lifecycle_event_listener;
     CachedPtr<shell::PersistentSurfaceStore> persistent_surface_store;
     CachedPtr<SharedLibraryProberReport> shared_library_prober_report;
+    CachedPtr<PlatformProbeCache> platform_probe_cache;
     CachedPtr<shell::Shell> shell;
     CachedPtr<shell::ShellReport> shell_report;
     CachedPtr<shell::decoration::Manager> decoration_manager;
@@ -21,6 +21,7 @@
 
 #include "mir/int_wrapper.h"
 #include "mir/graphics/display_configuration.h"
+#include "mir/geometry/rectangles.h"
 
 #include <memory>
 
@@ -33,6 +34,13 @@ namespace detail { struct ScreencastSessionIdTag; }
 
 typedef IntWrapper<detail::ScreencastSessionIdTag,uint32_t> ScreencastSessionId;
 
+struct ScreencastFrame
+{
+    std::shared_ptr<graphics::Buffer> buffer;
+    /// The parts of the captured region (in screen coordinates) that changed since the previous frame
+    geometry::Rectangles damage;
+};
+
 class Screencast
 {
 public:
@@ -46,6 +54,11 @@ public:
         MirMirrorMode mirror_mode) = 0;
     virtual void destroy_session(ScreencastSessionId id) = 0;
     virtual std::shared_ptr<graphics::Buffer> capture(ScreencastSessionId id) = 0;
+    /**
+     * Like capture(), but only composites if the captured region has changed since the previous
+     * capture of the session. If it hasn't, the previous buffer is returned again with no damage.
+     */
+    virtual ScreencastFrame capture_if_damaged(ScreencastSessionId id) = 0;
     virtual void capture(ScreencastSessionId id, std::shared_ptr<graphics::Buffer> const& buffer) = 0;
 
 protected:
@@ -0,0 +1,71 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_PLATFORM_PROBE_CACHE_H_
+#define MIR_PLATFORM_PROBE_CACHE_H_
+
+#include <experimental/optional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+/**
+ * Remembers, across server starts, which module was selected from the
+ * platform path for each role ("graphics", "input") and the priority it
+ * probed with, so that on a later start only that module needs probing.
+ *
+ * What is remembered is only valid while nothing that affects probing
+ * changes: the modules in the platform path (names, sizes and modification
+ * times), the graphics and input devices present, the kernel release and the
+ * MIR_SERVER_*, DISPLAY and WAYLAND_DISPLAY environment. If any of these has
+ * changed since it was stored, nothing is found.
+ *
+ * Users should still re-probe the module found and fall back to probing every
+ * module if it no longer gives the stored priority.
+ */
+class PlatformProbeCache
+{
+public:
+    struct Entry
+    {
+        std::string module;
+        int priority;
+    };
+
+    /// A cache stored in \a filename of modules selected from \a platform_path.
+    /// If \a filename is empty nothing is found and nothing is stored.
+    PlatformProbeCache(std::string const& filename, std::string const& platform_path);
+
+    /// The module stored for \a role, unless anything affecting the probe has changed
+    auto lookup(std::string const& role) const -> std::experimental::optional<Entry>;
+
+    /// Stores \a entry for \a role. (Failing to write the file is logged, not thrown.)
+    void store(std::string const& role, Entry const& entry);
+
+private:
+    void save() const;
+
+    std::string const filename;
+    std::string const fingerprint;
+
+    std::mutex mutable mutex;
+    std::map<std::string, Entry> entries;
+};
+}
+
+#endif /* MIR_PLATFORM_PROBE_CACHE_H_ */
@@ -60,6 +60,11 @@ public:
     void start_drag_and_drop(Surface const* surf, std::vector<uint8_t> const& handle) override;
     void depth_layer_set_to(Surface const* surf, MirDepthLayer depth_layer) override;
     void application_id_set_to(Surface const* surf, std::string const& application_id) override;
+    void input_region_set_to(Surface const* surf, std::vector<geometry::Rectangle> const& region) override;
+    void stream_frame_posted(
+        Surface const* surf,
+        compositor::BufferStream const* stream,
+        geometry::Size const& size) override;
 };
 
 }
@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_STARTUP_TRACE_H_
+#define MIR_STARTUP_TRACE_H_
+
+#include "mir/cached_ptr.h"
+
+#include <chrono>
+#include <string>
+#include <typeinfo>
+
+namespace mir
+{
+/**
+ * Records where the server spends its time starting up: constructing each
+ * component, running each init callback and starting each subsystem. The
+ * trace is written in the Chrome trace event format, which chrome://tracing
+ * and https://ui.perfetto.dev can display.
+ *
+ * Nothing is recorded unless start() has been called, and recording stops
+ * when finish() writes the trace.
+ */
+namespace startup_trace
+{
+using Clock = std::chrono::steady_clock;
+
+/// Starts recording a trace, which finish() will write to \a filename
+void start(std::string const& filename);
+
+/// Whether a trace is being recorded (so that nothing need be timed otherwise)
+auto recording() -> bool;
+
+/// Records that \a name (of \a category) ran from \a begin to \a end
+void record(std::string const& name, char const* category, Clock::time_point begin, Clock::time_point end);
+
+/// Writes the trace recorded since start() and stops recording
+void finish();
+
+/// The (demangled) name of the type \a pointer_type points to.
+/// (Taking the pointer type lets this name types that are incomplete where it's used.)
+auto name_of_pointee(std::type_info const& pointer_type) -> std::string;
+
+/// Records the time from its construction to its destruction
+class Span
+{
+public:
+    Span(std::string const& name, char const* category);
+    ~Span();
+
+private:
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+    bool const recording;
+    std::string const name;
+    char const* const category;
+    Clock::time_point const begin;
+};
+
+/// A mir::CachedPtr that records the construction of what it caches
+template<typename Type>
+class CachedPtr
+{
+    mir::CachedPtr<Type> cache;
+    CachedPtr(CachedPtr const&) = delete;
+    CachedPtr& operator=(CachedPtr const&) = delete;
+public:
+    CachedPtr() = default;
+
+    std::shared_ptr<Type> operator()(std::function<std::shared_ptr<Type>()> make)
+    {
+        return cache([&]
+            {
+                if (!recording())
+                    return make();
+
+                Span const span{name_of_pointee(typeid(Type*)), "component"};
+                return make();
+            });
+    }
+};
+}
+}
+
+#endif /* MIR_STARTUP_TRACE_H_ */
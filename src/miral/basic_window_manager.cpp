@@ -27,6 +27,7 @@
 #include <mir/scene/surface_creation_parameters.h>
 #include <mir/shell/display_layout.h>
 #include <mir/shell/persistent_surface_store.h>
+#include <mir/shell/shell_report.h>
 #include <mir/shell/surface_ready_observer.h>
 
 #include <boost/throw_exception.hpp>
@@ -36,6 +37,19 @@
 using namespace mir;
 using namespace mir::geometry;
 
+namespace
+{
+auto key_of(miral::Window const& window) -> scene::Surface const*
+{
+    return std::shared_ptr<scene::Surface>(window).get();
+}
+
+auto same_owner(std::weak_ptr<miral::Workspace> const& lhs, std::weak_ptr<miral::Workspace> const& rhs) -> bool
+{
+    return !lhs.owner_before(rhs) && !rhs.owner_before(lhs);
+}
+}
+
 struct miral::BasicWindowManager::Locker
 {
     explicit Locker(miral::BasicWindowManager* self);
@@ -45,23 +59,36 @@ struct miral::BasicWindowManager::Locker
         policy->advise_end();
     }
 
-    std::lock_guard<std::mutex> const lock;
+    std::unique_lock<std::mutex> lock;
     WindowManagementPolicy* const policy;
 };
 
 miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self) :
-    lock{self->mutex},
+    lock{self->mutex, std::try_to_lock},
     policy{self->policy.get()}
 {
+    if (!lock.owns_lock())
+    {
+        self->model_lock_report->model_lock_waiting();
+
+        auto const start = std::chrono::steady_clock::now();
+        lock.lock();
+        auto const wait = std::chrono::steady_clock::now() - start;
+        auto const times = ++self->model_lock_contentions;
+
+        self->shell_report->window_manager_lock_contended(wait, times);
+        self->model_lock_report->model_lock_contended(wait, times);
+    }
+
     policy->advise_begin();
-    std::vector<std::weak_ptr<Workspace>> workspaces;
+    std::vector<Workspace const*> workspaces;
     {
         std::lock_guard<std::mutex> const lock{self->dead_workspaces->dead_workspaces_mutex};
         workspaces.swap(self->dead_workspaces->workspaces);
     }
 
-    for (auto const& workspace : workspaces)
-        self->workspaces_to_windows.left.erase(workspace);
+    for (auto const workspace : workspaces)
+        self->erase_if_dead(workspace);
 }
 
 miral::BasicWindowManager::BasicWindowManager(
@@ -69,12 +96,15 @@ miral::BasicWindowManager::BasicWindowManager(
     std::shared_ptr<shell::DisplayLayout> const& display_layout,
     std::shared_ptr<mir::shell::PersistentSurfaceStore> const& persistent_surface_store,
     mir::ObserverRegistrar<mir::graphics::DisplayConfigurationObserver>& display_configuration_observers,
+    std::shared_ptr<mir::shell::ShellReport> const& shell_report,
     WindowManagementPolicyBuilder const& build) :
     focus_controller(focus_controller),
     display_layout(display_layout),
     persistent_surface_store{persistent_surface_store},
+    shell_report{shell_report},
     policy(build(WindowManagerTools{this})),
     policy_application_zone_addendum{WindowManagementPolicy::ApplicationZoneAddendum::from(policy.get())},
+    model_lock_report{ModelLockReport::from(policy.get())},
     display_config_monitor{std::make_shared<DisplayConfigurationListeners>()}
 {
     display_config_monitor->add_listener(this);
@@ -91,14 +121,16 @@ miral::BasicWindowManager::~BasicWindowManager()
 void miral::BasicWindowManager::add_session(std::shared_ptr<scene::Session> const& session)
 {
     Locker lock{this};
-    policy->advise_new_app(app_info[session] = ApplicationInfo(session));
+    auto& info = app_info[session] = ApplicationInfo(session);
+    app_info_index[session.get()] = &info;
+    policy->advise_new_app(info);
 }
 
 void miral::BasicWindowManager::remove_session(std::shared_ptr<scene::Session> const& session)
 {
     Locker lock{this};
-    auto info = app_info.find(session);
-    if (info == app_info.end())
+    auto info = app_info_index.find(session.get());
+    if (info == app_info_index.end())
     {
         log_debug(
             "BasicWindowManager::remove_session() called with unknown or already removed session %s (PID: %d)",
@@ -106,8 +138,9 @@ void miral::BasicWindowManager::remove_session(std::shared_ptr<scene::Session> c
             session->process_id());
         return;
     }
-    policy->advise_delete_app(info->second);
+    policy->advise_delete_app(*info->second);
     app_info.erase(session);
+    app_info_index.erase(info);
 }
 
 auto miral::BasicWindowManager::add_surface(
@@ -133,6 +166,7 @@ auto miral::BasicWindowManager::add_surface(
     auto const surface = build(session, parameters);
     Window const window{session, surface};
     auto& window_info = this->window_info.emplace(window, WindowInfo{window, spec}).first->second;
+    window_info_index[surface.get()] = &window_info;
 
     if (spec.parent().is_set() && spec.parent().value().lock())
         window_info.parent(info_for(spec.parent().value()).window());
@@ -196,7 +230,7 @@ void miral::BasicWindowManager::remove_surface(
     std::weak_ptr<scene::Surface> const& surface)
 {
     Locker lock{this};
-    if (app_info.find(session) == app_info.end())
+    if (app_info_index.find(session.get()) == app_info_index.end())
     {
         log_debug(
             "BasicWindowManager::remove_surface() called with unknown or already removed session %s (PID: %d)",
@@ -224,7 +258,10 @@ void miral::BasicWindowManager::remove_window(Application const& application, mi
             policy->advise_removing_from_workspace(workspace, windows_removed);
         }
 
-        workspaces_to_windows.right.erase(info.window());
+        for (auto const& workspace : workspaces_containing_window)
+            remove_from_workspace(info.window(), workspace);
+
+        windows_to_workspaces.erase(key_of(info.window()));
     }
 
     policy->advise_delete_window(info);
@@ -240,6 +277,8 @@ void miral::BasicWindowManager::remove_window(Application const& application, mi
         update_windows_for_outputs();
     }
 
+    // The surface (and so the key) may be gone once destroyed
+    window_info_index.erase(key_of(info.window()));
     application->destroy_surface(info.window());
 
     // NB erase() invalidates info, but we want to keep access to "parent".
@@ -516,12 +555,26 @@ auto miral::BasicWindowManager::find_application(std::function<bool(ApplicationI
 auto miral::BasicWindowManager::info_for(std::weak_ptr<scene::Session> const& session) const
 -> ApplicationInfo&
 {
+    if (auto const shared = session.lock())
+    {
+        auto const info = app_info_index.find(shared.get());
+        if (info != app_info_index.end())
+            return *info->second;
+    }
+
     return const_cast<ApplicationInfo&>(app_info.at(session));
 }
 
 auto miral::BasicWindowManager::info_for(std::weak_ptr<scene::Surface> const& surface) const
 -> WindowInfo&
 {
+    if (auto const shared = surface.lock())
+    {
+        auto const info = window_info_index.find(shared.get());
+        if (info != window_info_index.end())
+            return *info->second;
+    }
+
     return const_cast<WindowInfo&>(window_info.at(surface));
 }
 
@@ -653,14 +706,17 @@ void miral::BasicWindowManager::focus_prev_application()
 auto miral::BasicWindowManager::workspaces_containing(Window const& window) const
 -> std::vector<std::shared_ptr<Workspace>>
 {
-    auto const iter_pair = workspaces_to_windows.right.equal_range(window);
-
     std::vector<std::shared_ptr<Workspace>> workspaces_containing_window;
-    for (auto kv = iter_pair.first; kv != iter_pair.second; ++kv)
+
+    auto const workspaces = windows_to_workspaces.find(key_of(window));
+    if (workspaces != windows_to_workspaces.end())
     {
-        if (auto const workspace = kv->second.lock())
+        for (auto const& weak_workspace : workspaces->second)
         {
-            workspaces_containing_window.push_back(workspace);
+            if (auto const workspace = weak_workspace.lock())
+            {
+                workspaces_containing_window.push_back(workspace);
+            }
         }
     }
 
@@ -1658,7 +1714,8 @@ auto miral::BasicWindowManager::surface_known(
     std::weak_ptr<scene::Surface> const& surface,
     std::string const& action) -> bool
 {
-    if (window_info.find(surface) != window_info.end())
+    auto const shared = surface.lock();
+    if ((shared && window_info_index.count(shared.get())) || window_info.find(surface) != window_info.end())
     {
         return true;
     }
@@ -2263,12 +2320,10 @@ public:
     explicit Workspace(std::shared_ptr<miral::BasicWindowManager::DeadWorkspaces> const& dead_workspaces) :
         dead_workspaces{dead_workspaces} {}
 
-    std::weak_ptr<Workspace> self;
-
     ~Workspace()
     {
         std::lock_guard<std::mutex> lock {dead_workspaces->dead_workspaces_mutex};
-        dead_workspaces->workspaces.push_back(self);
+        dead_workspaces->workspaces.push_back(this);
     }
 
 private:
@@ -2277,9 +2332,7 @@ private:
 
 auto miral::BasicWindowManager::create_workspace() -> std::shared_ptr<Workspace>
 {
-    auto const result = std::make_shared<Workspace>(dead_workspaces);
-    result->self = result;
-    return result;
+    return std::make_shared<Workspace>(dead_workspaces);
 }
 
 void miral::BasicWindowManager::add_tree_to_workspace(
@@ -2311,18 +2364,12 @@ void miral::BasicWindowManager::add_tree_to_workspace(
     windows.push_back(root);
     add_children(*info);
 
-    auto const iter_pair = workspaces_to_windows.left.equal_range(workspace);
-
     std::vector<Window> windows_added;
 
     for (auto& w : windows)
     {
-        if (!std::count_if(iter_pair.first, iter_pair.second,
-                           [&w](wwbimap_t::left_value_type const& kv) { return kv.second == w; }))
-        {
-            workspaces_to_windows.left.insert(wwbimap_t::left_value_type{workspace, w});
+        if (add_to_workspace(w, workspace))
             windows_added.push_back(w);
-        }
     }
 
     if (!windows_added.empty())
@@ -2360,15 +2407,10 @@ void miral::BasicWindowManager::remove_tree_from_workspace(
 
     std::vector<Window> windows_removed;
 
-    auto const iter_pair = workspaces_to_windows.left.equal_range(workspace);
-    for (auto kv = iter_pair.first; kv != iter_pair.second;)
+    for (auto& w : windows)
     {
-        auto const current = kv++;
-        if (std::count(begin(windows), end(windows), current->second))
-        {
-            windows_removed.push_back(current->second);
-            workspaces_to_windows.left.erase(current);
-        }
+        if (remove_from_workspace(w, workspace))
+            windows_removed.push_back(w);
     }
 
     if (!windows_removed.empty())
@@ -2380,28 +2422,21 @@ void miral::BasicWindowManager::move_workspace_content_to_workspace(
 {
     std::vector<Window> windows_removed;
 
-    auto const iter_pair_from = workspaces_to_windows.left.equal_range(from_workspace);
-    for (auto kv = iter_pair_from.first; kv != iter_pair_from.second;)
-    {
-        auto const current = kv++;
-        windows_removed.push_back(current->second);
-        workspaces_to_windows.left.erase(current);
-    }
+    if (auto const from_windows = windows_in(from_workspace))
+        windows_removed.assign(from_windows->begin(), from_windows->end());
+
+    for (auto& w : windows_removed)
+        remove_from_workspace(w, from_workspace);
 
     if (!windows_removed.empty())
         policy->advise_removing_from_workspace(from_workspace, windows_removed);
 
     std::vector<Window> windows_added;
 
-    auto const iter_pair_to = workspaces_to_windows.left.equal_range(to_workspace);
     for (auto& w : windows_removed)
     {
-        if (!std::count_if(iter_pair_to.first, iter_pair_to.second,
-                           [&w](wwbimap_t::left_value_type const& kv) { return kv.second == w; }))
-        {
-            workspaces_to_windows.left.insert(wwbimap_t::left_value_type{to_workspace, w});
+        if (add_to_workspace(w, to_workspace))
             windows_added.push_back(w);
-        }
     }
 
     if (!windows_added.empty())
@@ -2411,20 +2446,88 @@ void miral::BasicWindowManager::move_workspace_content_to_workspace(
 void miral::BasicWindowManager::for_each_workspace_containing(
     miral::Window const& window, std::function<void(std::shared_ptr<miral::Workspace> const&)> const& callback)
 {
-    auto const iter_pair = workspaces_to_windows.right.equal_range(window);
-    for (auto kv = iter_pair.first; kv != iter_pair.second; ++kv)
-    {
-        if (auto const workspace = kv->second.lock())
-            callback(workspace);
-    }
+    for (auto const& workspace : workspaces_containing(window))
+        callback(workspace);
 }
 
 void miral::BasicWindowManager::for_each_window_in_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::function<void(miral::Window const&)> const& callback)
 {
-    auto const iter_pair = workspaces_to_windows.left.equal_range(workspace);
-    for (auto kv = iter_pair.first; kv != iter_pair.second; ++kv)
-        callback(kv->second);
+    if (auto const windows = windows_in(workspace))
+    {
+        for (auto const& window : *windows)
+            callback(window);
+    }
+}
+
+auto miral::BasicWindowManager::windows_in(std::shared_ptr<Workspace> const& workspace) const
+-> IndexedWindowList const*
+{
+    auto const entry = workspaces_to_windows.find(workspace.get());
+    if (entry == workspaces_to_windows.end() || entry->second.workspace.expired())
+        return nullptr;
+
+    return &entry->second.windows;
+}
+
+auto miral::BasicWindowManager::add_to_workspace(Window const& window, std::shared_ptr<Workspace> const& workspace)
+-> bool
+{
+    erase_if_dead(workspace.get());
+
+    auto& entry = workspaces_to_windows[workspace.get()];
+    entry.workspace = workspace;
+
+    if (!entry.windows.push_back(window))
+        return false;
+
+    windows_to_workspaces[key_of(window)].push_back(workspace);
+    return true;
+}
+
+auto miral::BasicWindowManager::remove_from_workspace(Window const& window, std::shared_ptr<Workspace> const& workspace)
+-> bool
+{
+    auto const entry = workspaces_to_windows.find(workspace.get());
+    if (entry == workspaces_to_windows.end() || entry->second.workspace.expired())
+        return false;
+
+    if (!entry->second.windows.erase(window))
+        return false;
+
+    unlink(window, workspace);
+
+    if (entry->second.windows.empty())
+        workspaces_to_windows.erase(entry);
+
+    return true;
+}
+
+void miral::BasicWindowManager::erase_if_dead(Workspace const* workspace)
+{
+    auto const entry = workspaces_to_windows.find(workspace);
+    if (entry == workspaces_to_windows.end() || !entry->second.workspace.expired())
+        return;
+
+    for (auto const& window : entry->second.windows)
+        unlink(window, entry->second.workspace);
+
+    workspaces_to_windows.erase(entry);
+}
+
+void miral::BasicWindowManager::unlink(Window const& window, std::weak_ptr<Workspace> const& workspace)
+{
+    auto const workspaces = windows_to_workspaces.find(key_of(window));
+    if (workspaces == windows_to_workspaces.end())
+        return;
+
+    auto& list = workspaces->second;
+    list.erase(
+        std::remove_if(begin(list), end(list), [&](auto const& w) { return same_owner(w, workspace); }),
+        end(list));
+
+    if (list.empty())
+        windows_to_workspaces.erase(workspaces);
 }
 
 auto miral::BasicWindowManager::apply_exclusive_rect_to_application_zone(
@@ -28,6 +28,8 @@
 #include "miral/application_info.h"
 #include "miral/zone.h"
 #include "miral/output.h"
+#include "indexed_window_list.h"
+#include "model_lock_report.h"
 #include "mru_window_list.h"
 
 #include <mir/geometry/rectangles.h>
@@ -35,16 +37,15 @@
 #include <mir/shell/abstract_shell.h>
 #include <mir/shell/window_manager.h>
 
-#include <boost/bimap.hpp>
-#include <boost/bimap/multiset_of.hpp>
 #include <experimental/optional>
 
 #include <map>
 #include <mutex>
+#include <unordered_map>
 
 namespace mir
 {
-namespace shell { class DisplayLayout; class PersistentSurfaceStore; }
+namespace shell { class DisplayLayout; class PersistentSurfaceStore; class ShellReport; }
 namespace graphics { class DisplayConfigurationObserver; }
 }
 
@@ -68,6 +69,7 @@ public:
         std::shared_ptr<mir::shell::DisplayLayout> const& display_layout,
         std::shared_ptr<mir::shell::PersistentSurfaceStore> const& persistent_surface_store,
         mir::ObserverRegistrar<mir::graphics::DisplayConfigurationObserver>& display_configuration_observers,
+        std::shared_ptr<mir::shell::ShellReport> const& shell_report,
         WindowManagementPolicyBuilder const& build);
     ~BasicWindowManager();
 
@@ -224,22 +226,27 @@ private:
     mir::shell::FocusController* const focus_controller;
     std::shared_ptr<mir::shell::DisplayLayout> const display_layout;
     std::shared_ptr<mir::shell::PersistentSurfaceStore> const persistent_surface_store;
+    std::shared_ptr<mir::shell::ShellReport> const shell_report;
 
     // Workspaces may die without any sync with the BWM mutex
     struct DeadWorkspaces
     {
         std::mutex mutable dead_workspaces_mutex;
-        std::vector<std::weak_ptr<Workspace>> workspaces;
+        std::vector<Workspace const*> workspaces;
     };
 
     std::shared_ptr<DeadWorkspaces> const dead_workspaces{std::make_shared<DeadWorkspaces>()};
 
     std::unique_ptr<WindowManagementPolicy> const policy;
     WindowManagementPolicy::ApplicationZoneAddendum* const policy_application_zone_addendum;
+    ModelLockReport* const model_lock_report;
 
     std::mutex mutex;
+    uint64_t model_lock_contentions{0};
     SessionInfoMap app_info;
     SurfaceInfoMap window_info;
+    std::unordered_map<mir::scene::Session const*, ApplicationInfo*> app_info_index;
+    std::unordered_map<mir::scene::Surface const*, WindowInfo*> window_info_index;
     mir::geometry::Rectangles outputs;
     mir::geometry::Point cursor;
     uint64_t last_input_event_timestamp{0};
@@ -250,11 +257,15 @@ private:
     std::vector<std::shared_ptr<DisplayArea>> display_areas; ///< For now these will map 1:1 to outputs, but this should not be assumed
 
     friend class Workspace;
-    using wwbimap_t = boost::bimap<
-        boost::bimaps::multiset_of<std::weak_ptr<Workspace>, std::owner_less<std::weak_ptr<Workspace>>>,
-        boost::bimaps::multiset_of<Window>>;
+    struct WorkspaceWindows
+    {
+        std::weak_ptr<Workspace> workspace;
+        IndexedWindowList windows;  ///< In the order they were added
+    };
 
-    wwbimap_t workspaces_to_windows;
+    std::unordered_map<Workspace const*, WorkspaceWindows> workspaces_to_windows;
+    /// The workspaces containing each window, in the order it was added to them
+    std::unordered_map<mir::scene::Surface const*, std::vector<std::weak_ptr<Workspace>>> windows_to_workspaces;
 
     std::shared_ptr<DisplayConfigurationListeners> const display_config_monitor;
 
@@ -291,6 +302,14 @@ private:
     void refocus(Application const& application, Window const& parent,
                  std::vector<std::shared_ptr<Workspace>> const& workspaces_containing_window);
     auto workspaces_containing(Window const& window) const -> std::vector<std::shared_ptr<Workspace>>;
+    /// The windows in workspace, or null if it has none
+    auto windows_in(std::shared_ptr<Workspace> const& workspace) const -> IndexedWindowList const*;
+    auto add_to_workspace(Window const& window, std::shared_ptr<Workspace> const& workspace) -> bool;
+    auto remove_from_workspace(Window const& window, std::shared_ptr<Workspace> const& workspace) -> bool;
+    /// Forgets the windows of workspace if it has died (its address may since have been reused)
+    void erase_if_dead(Workspace const* workspace);
+    /// Removes workspace from those containing window
+    void unlink(Window const& window, std::weak_ptr<Workspace> const& workspace);
     auto active_display_area() const -> std::shared_ptr<DisplayArea>;
     auto display_area_for(WindowInfo const& info) const -> std::shared_ptr<DisplayArea>;
     /// Returns the application zone area after shrinking it for the exclusive zone if needed
@@ -0,0 +1,129 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexed_window_list.h"
+
+#include <algorithm>
+
+namespace
+{
+auto key_of(miral::Window const& window) -> mir::scene::Surface const*
+{
+    return std::shared_ptr<mir::scene::Surface>(window).get();
+}
+}
+
+auto miral::IndexedWindowList::push_back(Window const& window) -> bool
+{
+    auto const key = key_of(window);
+
+    if (key)
+    {
+        auto const i = index.find(key);
+        if (i != index.end())
+        {
+            // The surface may have been given another Window handle (or reused the address of a lost one)
+            *i->second = window;
+            return false;
+        }
+    }
+    else if (find(window) != windows.end())
+    {
+        return false;
+    }
+
+    windows.push_back(window);
+    if (key)
+        index[key] = std::prev(windows.end());
+
+    return true;
+}
+
+void miral::IndexedWindowList::move_to_back(Window const& window)
+{
+    if (push_back(window))
+        return;
+
+    auto const i = find(window);
+    windows.splice(windows.end(), windows, i);
+}
+
+auto miral::IndexedWindowList::erase(Window const& window) -> bool
+{
+    if (auto const key = key_of(window))
+    {
+        auto const i = index.find(key);
+        if (i == index.end())
+            return false;
+
+        windows.erase(i->second);
+        index.erase(i);
+        return true;
+    }
+
+    auto const i = find(window);
+    if (i == windows.end())
+        return false;
+
+    // Without the surface the index entry can only be found by what it refers to
+    auto const entry = std::find_if(index.begin(), index.end(), [&](auto const& entry) { return entry.second == i; });
+    if (entry != index.end())
+        index.erase(entry);
+
+    windows.erase(i);
+    return true;
+}
+
+auto miral::IndexedWindowList::contains(Window const& window) const -> bool
+{
+    return find(window) != windows.end();
+}
+
+auto miral::IndexedWindowList::empty() const -> bool
+{
+    return windows.empty();
+}
+
+auto miral::IndexedWindowList::begin() const -> const_iterator
+{
+    return windows.begin();
+}
+
+auto miral::IndexedWindowList::end() const -> const_iterator
+{
+    return windows.end();
+}
+
+auto miral::IndexedWindowList::rbegin() const -> const_reverse_iterator
+{
+    return windows.rbegin();
+}
+
+auto miral::IndexedWindowList::rend() const -> const_reverse_iterator
+{
+    return windows.rend();
+}
+
+auto miral::IndexedWindowList::find(Window const& window) const -> const_iterator
+{
+    if (auto const key = key_of(window))
+    {
+        auto const i = index.find(key);
+        return i != index.end() ? const_iterator{i->second} : windows.end();
+    }
+
+    return std::find(windows.begin(), windows.end(), window);
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_INDEXED_WINDOW_LIST_H
+#define MIRAL_INDEXED_WINDOW_LIST_H
+
+#include <miral/window.h>
+
+#include <list>
+#include <unordered_map>
+
+namespace miral
+{
+/// An ordered list of distinct windows, with constant time lookup, insertion and removal.
+/// Windows are identified by their surface: a window whose surface is gone is found by a linear search.
+class IndexedWindowList
+{
+public:
+    using const_iterator = std::list<Window>::const_iterator;
+    using const_reverse_iterator = std::list<Window>::const_reverse_iterator;
+
+    /// Adds window at the back, unless it is already present.
+    /// \returns whether the window was added
+    auto push_back(Window const& window) -> bool;
+
+    /// Moves window to the back, adding it if it is not present
+    void move_to_back(Window const& window);
+
+    /// \returns whether the window was present
+    auto erase(Window const& window) -> bool;
+
+    auto contains(Window const& window) const -> bool;
+    auto empty() const -> bool;
+
+    auto begin() const -> const_iterator;
+    auto end() const -> const_iterator;
+    auto rbegin() const -> const_reverse_iterator;
+    auto rend() const -> const_reverse_iterator;
+
+private:
+    using Windows = std::list<Window>;
+
+    auto find(Window const& window) const -> const_iterator;
+
+    Windows windows;
+    std::unordered_map<mir::scene::Surface const*, Windows::iterator> index;
+};
+}
+
+#endif //MIRAL_INDEXED_WINDOW_LIST_H
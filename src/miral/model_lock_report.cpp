@@ -0,0 +1,32 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "model_lock_report.h"
+
+#include "miral/window_management_policy.h"
+
+auto miral::ModelLockReport::from(WindowManagementPolicy* policy) -> ModelLockReport*
+{
+    if (auto const result = dynamic_cast<ModelLockReport*>(policy))
+        return result;
+
+    static ModelLockReport null_model_lock_report;
+    return &null_model_lock_report;
+}
+
+void miral::ModelLockReport::model_lock_waiting() {}
+
+void miral::ModelLockReport::model_lock_contended(std::chrono::steady_clock::duration /*wait*/, uint64_t /*times*/) {}
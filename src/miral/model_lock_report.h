@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_MODEL_LOCK_REPORT_H
+#define MIRAL_MODEL_LOCK_REPORT_H
+
+#include <chrono>
+#include <cstdint>
+
+namespace miral
+{
+class WindowManagementPolicy;
+
+/// Reports threads waiting for the window management model lock.
+/// A policy that also implements this is told of each wait.
+class ModelLockReport
+{
+public:
+    ModelLockReport() = default;
+    virtual ~ModelLockReport() = default;
+    ModelLockReport(ModelLockReport const&) = delete;
+    ModelLockReport& operator=(ModelLockReport const&) = delete;
+
+    /// The report implemented by policy, or a report that ignores everything
+    static auto from(WindowManagementPolicy* policy) -> ModelLockReport*;
+
+    /// A thread found the lock held, and is about to wait for it (called without the lock held)
+    virtual void model_lock_waiting();
+
+    /// A thread waited for the lock, which has now been contended \a times in all (called with the lock held)
+    virtual void model_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times);
+};
+}
+
+#endif //MIRAL_MODEL_LOCK_REPORT_H
@@ -33,25 +33,35 @@ bool visible(miral::Window const& window)
 
 void miral::MRUWindowList::push(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
-    windows.push_back(window);
+    windows.move_to_back(window);
 }
 
 void miral::MRUWindowList::erase(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
+    windows.erase(window);
 }
 
 auto miral::MRUWindowList::top() const -> Window
 {
-    auto const& found = std::find_if(rbegin(windows), rend(windows), visible);
-    return (found != rend(windows)) ? *found: Window{};
+    auto const& found = std::find_if(windows.rbegin(), windows.rend(), visible);
+    return (found != windows.rend()) ? *found: Window{};
 }
 
 void miral::MRUWindowList::enumerate(Enumerator const& enumerator) const
 {
-    for (auto i = windows.rbegin(); i != windows.rend(); ++i)
-        if (visible(*i))
-            if (!enumerator(const_cast<Window&>(*i)))
+    if (windows.empty())
+        return;
+
+    // The enumerator may push the current window (moving it to the back), so step past it first
+    auto next = std::prev(windows.end());
+    for (bool more = true; more;)
+    {
+        auto const current = next;
+        if ((more = current != windows.begin()))
+            --next;
+
+        if (visible(*current))
+            if (!enumerator(const_cast<Window&>(*current)))
                 break;
+    }
 }
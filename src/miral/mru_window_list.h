@@ -19,10 +19,9 @@
 #ifndef MIRAL_MRU_WINDOW_LIST_H
 #define MIRAL_MRU_WINDOW_LIST_H
 
-#include <miral/window.h>
+#include "indexed_window_list.h"
 
 #include <functional>
-#include <vector>
 
 namespace miral
 {
@@ -39,7 +38,7 @@ public:
     void enumerate(Enumerator const& enumerator) const;
 
 private:
-    std::vector<Window> windows;
+    IndexedWindowList windows;
 };
 }
 
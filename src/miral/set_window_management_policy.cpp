@@ -60,6 +60,7 @@ void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
                     display_layout,
                     persistent_surface_store,
                     *server.the_display_configuration_observer_registrar(),
+                    server.the_shell_report(),
                     trace_builder);
             }
 
@@ -68,6 +69,7 @@ void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
                 display_layout,
                 persistent_surface_store,
                 *server.the_display_configuration_observer_registrar(),
+                server.the_shell_report(),
                 builder);
         });
 }
@@ -78,6 +78,7 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
                             display_layout,
                             persistent_surface_store,
                             *server.the_display_configuration_observer_registrar(),
+                            server.the_shell_report(),
                             trace_builder);
                     }
 
@@ -86,6 +87,7 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
                          display_layout,
                          persistent_surface_store,
                          *server.the_display_configuration_observer_registrar(),
+                         server.the_shell_report(),
                          option.build);
                 }
             }
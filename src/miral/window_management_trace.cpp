@@ -363,7 +363,8 @@ miral::WindowManagementTrace::WindowManagementTrace(
     WindowManagementPolicyBuilder const& builder) :
     wrapped{wrapped},
     policy(builder(WindowManagerTools{this})),
-    policy_application_zone_addendum{WindowManagementPolicy::ApplicationZoneAddendum::from(policy.get())}
+    policy_application_zone_addendum{WindowManagementPolicy::ApplicationZoneAddendum::from(policy.get())},
+    policy_model_lock_report{ModelLockReport::from(policy.get())}
 {
 }
 
@@ -927,3 +928,19 @@ try {
     return policy_application_zone_addendum->advise_application_zone_delete(application_zone);
 }
 MIRAL_TRACE_EXCEPTION
+
+void miral::WindowManagementTrace::model_lock_waiting()
+try {
+    // Not traced: this is called without the lock, and the wait is traced once it is over
+    return policy_model_lock_report->model_lock_waiting();
+}
+MIRAL_TRACE_EXCEPTION
+
+void miral::WindowManagementTrace::model_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times)
+try {
+    mir::log_info("%s wait=%lldus, times=%llu", __func__,
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(wait).count()),
+        static_cast<unsigned long long>(times));
+    return policy_model_lock_report->model_lock_contended(wait, times);
+}
+MIRAL_TRACE_EXCEPTION
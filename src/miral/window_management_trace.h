@@ -19,6 +19,7 @@
 #ifndef MIRAL_WINDOW_MANAGEMENT_TRACE_H
 #define MIRAL_WINDOW_MANAGEMENT_TRACE_H
 
+#include "model_lock_report.h"
 #include "window_manager_tools_implementation.h"
 
 #include "miral/window_manager_tools.h"
@@ -32,6 +33,7 @@ namespace miral
 class WindowManagementTrace
     : public WindowManagementPolicy,
       public WindowManagementPolicy::ApplicationZoneAddendum,
+      public ModelLockReport,
       WindowManagerToolsImplementation
 {
 public:
@@ -168,10 +170,14 @@ public:
 
     void advise_application_zone_delete(Zone const& application_zone) override;
 
+    void model_lock_waiting() override;
+    void model_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times) override;
+
 private:
     WindowManagerTools wrapped;
     std::unique_ptr<miral::WindowManagementPolicy> const policy;
     miral::WindowManagementPolicy::ApplicationZoneAddendum* const policy_application_zone_addendum;
+    ModelLockReport* const policy_model_lock_report;
     std::atomic<unsigned> mutable trace_count;
     std::function<void()> log_input;
 };
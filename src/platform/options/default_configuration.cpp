@@ -51,6 +51,7 @@ char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
+char const* const mo::composite_before_vblank_opt = "composite-before-vblank";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
 char const* const mo::x11_display_opt             = "enable-x11";
 char const* const mo::wayland_extensions_opt      = "wayland-extensions";
@@ -63,6 +64,8 @@ char const* const mo::lttng_opt_value = "lttng";
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
 char const* const mo::platform_path = "platform-path";
+char const* const mo::platform_probe_cache = "platform-probe-cache";
+char const* const mo::startup_trace_opt = "startup-trace";
 
 char const* const mo::console_provider = "console-provider";
 char const* const mo::logind_console = "logind";
@@ -162,6 +165,12 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Library to use for platform input support (default: input-stub.so)")
         (platform_path, po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
             "Directory to look for platform libraries (default: " MIR_SERVER_PLATFORM_PATH ")")
+        (platform_probe_cache, po::value<std::string>(),
+            "File in which to remember the platform libraries selected from the platform path, "
+            "so that later starts on an unchanged system only probe those (default: probe on every start)")
+        (startup_trace_opt, po::value<std::string>(),
+            "File to write a trace of server startup to (in Chrome trace event JSON), "
+            "timing the construction of each component, each init callback and the start of each subsystem")
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -191,6 +200,11 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "frames from clients before compositing). Higher values result in "
             "lower latency but risk causing frame skipping. "
             "Default: A negative value means decide automatically.")
+        (composite_before_vblank_opt, po::value<bool>()->default_value(false),
+            "Pace compositing of each output by its own refresh rate, starting "
+            "each frame just before the vblank it is due for, as predicted from "
+            "measured render times and timed from the last page flip. Overrides "
+            "--composite-delay on outputs whose platform reports page flips.")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
         (nested_passthrough_opt, po::value<bool>()->default_value(true),
@@ -147,19 +147,19 @@ void mie::LibInputDevice::process_event(libinput_event* event)
         switch(libinput_event_get_type(event))
         {
         case LIBINPUT_EVENT_KEYBOARD_KEY:
-            sink->handle_input(convert_event(libinput_event_get_keyboard_event(event)));
+            handle_input(convert_event(libinput_event_get_keyboard_event(event)));
             break;
         case LIBINPUT_EVENT_POINTER_MOTION:
-            sink->handle_input(convert_motion_event(libinput_event_get_pointer_event(event)));
+            handle_input(convert_motion_event(libinput_event_get_pointer_event(event)));
             break;
         case LIBINPUT_EVENT_POINTER_MOTION_ABSOLUTE:
-            sink->handle_input(convert_absolute_motion_event(libinput_event_get_pointer_event(event)));
+            handle_input(convert_absolute_motion_event(libinput_event_get_pointer_event(event)));
             break;
         case LIBINPUT_EVENT_POINTER_BUTTON:
-            sink->handle_input(convert_button_event(libinput_event_get_pointer_event(event)));
+            handle_input(convert_button_event(libinput_event_get_pointer_event(event)));
             break;
         case LIBINPUT_EVENT_POINTER_AXIS:
-            sink->handle_input(convert_axis_event(libinput_event_get_pointer_event(event)));
+            handle_input(convert_axis_event(libinput_event_get_pointer_event(event)));
             break;
         // touch events are processed as a batch of changes over all touch pointts
         case LIBINPUT_EVENT_TOUCH_DOWN:
@@ -179,7 +179,7 @@ void mie::LibInputDevice::process_event(libinput_event* event)
             {
                 if (auto input = convert_touch_frame(libinput_event_get_touch_event(event)))
                 {
-                    sink->handle_input(std::move(input));
+                    handle_input(std::move(input));
                 }
             }
             break;
@@ -193,6 +193,17 @@ void mie::LibInputDevice::process_event(libinput_event* event)
     }
 }
 
+void mie::LibInputDevice::handle_input(EventUPtr event)
+{
+    auto const input_event = mir_event_get_input_event(event.get());
+    report->input_event_reached(
+        mi::InputEventStage::platform,
+        mir_input_event_get_device_id(input_event),
+        mir_input_event_get_event_time(input_event));
+
+    sink->handle_input(std::move(event));
+}
+
 mir::EventUPtr mie::LibInputDevice::convert_event(libinput_event_keyboard* keyboard)
 {
     std::chrono::nanoseconds const time = std::chrono::microseconds(libinput_event_keyboard_get_time_usec(keyboard));
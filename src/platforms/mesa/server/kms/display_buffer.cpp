@@ -547,6 +547,9 @@ bool mgm::DisplayBuffer::overlay(RenderableList const& renderable_list)
                 }
             }
         }
+
+        if (assign_scanout_layers(renderable_list))
+            return true;
     }
 
     bypass_buf = nullptr;
@@ -554,6 +557,74 @@ bool mgm::DisplayBuffer::overlay(RenderableList const& renderable_list)
     return false;
 }
 
+bool mgm::DisplayBuffer::assign_scanout_layers(RenderableList const& renderable_list)
+{
+    layers.clear();
+    layer_bufs.clear();
+
+    if (outputs.size() != 1)
+        return false;
+
+    auto const& output = outputs.front();
+
+    // A single layer is just bypass, which has already been ruled out
+    auto const max_layers = output->max_scanout_layers();
+    if (max_layers < 2)
+        return false;
+
+    glm::mat4 static const identity(1);
+    std::vector<ScanoutLayer> candidate_layers;
+    std::vector<std::shared_ptr<Buffer>> candidate_bufs;
+
+    for (auto const& renderable : renderable_list)
+    {
+        auto const position = renderable->screen_position();
+
+        // Offscreen surfaces don't need a plane
+        if (!area.overlaps(position))
+            continue;
+
+        /*
+         * There's nothing to composite onto, so the bottom layer must cover
+         * the whole output, and every layer must be displayable as-is.
+         */
+        if (candidate_layers.empty() &&
+            (position != area || renderable->shaped()))
+            return false;
+
+        if (candidate_layers.size() == max_layers ||
+            !area.contains(position) ||
+            renderable->alpha() != 1.0f ||
+            renderable->transformation() != identity ||
+            renderable->clip_area())
+            return false;
+
+        auto const buffer = renderable->buffer();
+        auto const native = std::dynamic_pointer_cast<mgm::NativeBuffer>(buffer->native_buffer_handle());
+        if (!native || !(native->flags & mir_buffer_flag_can_scanout) ||
+            buffer->size() != position.size ||
+            needs_bounce_buffer(*output, native->bo))
+            return false;
+
+        auto const bufobj = output->fb_for(native->bo);
+        if (!bufobj)
+            return false;
+
+        candidate_layers.push_back(
+            {bufobj,
+             {{0, 0}, buffer->size()},
+             {position.top_left - as_displacement(area.top_left), position.size}});
+        candidate_bufs.push_back(buffer);
+    }
+
+    if (candidate_layers.size() < 2 || !output->test_scanout_layers(candidate_layers))
+        return false;
+
+    layers = std::move(candidate_layers);
+    layer_bufs = std::move(candidate_bufs);
+    return true;
+}
+
 void mgm::DisplayBuffer::for_each_display_buffer(
     std::function<void(graphics::DisplayBuffer&)> const& f)
 {
@@ -565,6 +636,8 @@ void mgm::DisplayBuffer::swap_buffers()
     surface.swap_buffers();
     bypass_buf = nullptr;
     bypass_bufobj = nullptr;
+    layers.clear();
+    layer_bufs.clear();
 }
 
 void mgm::DisplayBuffer::set_crtc(FBHandle const& forced_frame)
@@ -595,8 +668,12 @@ void mgm::DisplayBuffer::post()
      */
     wait_for_page_flip();
 
-    mgm::FBHandle *bufobj;
-    if (bypass_buf)
+    mgm::FBHandle const* bufobj;
+    if (!layers.empty())
+    {
+        bufobj = layers.front().fb;
+    }
+    else if (bypass_buf)
     {
         bufobj = bypass_bufobj;
     }
@@ -612,12 +689,14 @@ void mgm::DisplayBuffer::post()
      * Try to schedule a page flip as first preference to avoid tearing.
      * [will complete in a background thread]
      */
-    if (!needs_set_crtc && !schedule_page_flip(*bufobj))
+    if (!needs_set_crtc &&
+        !(layers.empty() ? schedule_page_flip(*bufobj) : schedule_scanout_layers_flip()))
         needs_set_crtc = true;
 
     /*
      * Fallback blitting: Not pretty, since it may tear. VirtualBox seems
      * to need to do this on every frame. [will complete in this thread]
+     * For a layered frame only the bottom layer makes it to the screen.
      */
     if (needs_set_crtc)
     {
@@ -630,7 +709,7 @@ void mgm::DisplayBuffer::post()
     // Predicted worst case render time for the next frame...
     auto predicted_render_time = 50ms;
 
-    if (bypass_buf)
+    if (bypass_buf || !layers.empty())
     {
         /*
          * For composited frames we defer wait_for_page_flip till just before
@@ -642,6 +721,7 @@ void mgm::DisplayBuffer::post()
          * no compositing/rendering step for which to save time for.
          */
         scheduled_bypass_frame = bypass_buf;
+        scheduled_layer_frames = std::move(layer_bufs);
         wait_for_page_flip();
 
         // It's very likely the next frame will be bypassed like this one so
@@ -670,6 +750,8 @@ void mgm::DisplayBuffer::post()
     // Buffer lifetimes are managed exclusively by scheduled*/visible* now
     bypass_buf = nullptr;
     bypass_bufobj = nullptr;
+    layers.clear();
+    layer_bufs.clear();
 
     recommend_sleep = 0ms;
     if (outputs.size() == 1)
@@ -701,6 +783,15 @@ bool mgm::DisplayBuffer::schedule_page_flip(FBHandle const& bufobj)
     return page_flips_pending;
 }
 
+bool mgm::DisplayBuffer::schedule_scanout_layers_flip()
+{
+    // Layers are only assigned when there is a single output
+    if (outputs.front()->schedule_scanout_layers_flip(layers))
+        page_flips_pending = true;
+
+    return page_flips_pending;
+}
+
 void mgm::DisplayBuffer::wait_for_page_flip()
 {
     if (page_flips_pending)
@@ -711,7 +802,7 @@ void mgm::DisplayBuffer::wait_for_page_flip()
         page_flips_pending = false;
     }
 
-    if (scheduled_bypass_frame || scheduled_composite_frame)
+    if (scheduled_bypass_frame || scheduled_composite_frame || !scheduled_layer_frames.empty())
     {
         // Why are both of these grouped into a single statement?
         // Because in either case both types of frame need releasing each time.
@@ -719,6 +810,9 @@ void mgm::DisplayBuffer::wait_for_page_flip()
         visible_bypass_frame = scheduled_bypass_frame;
         scheduled_bypass_frame = nullptr;
 
+        visible_layer_frames = std::move(scheduled_layer_frames);
+        scheduled_layer_frames.clear();
+
         visible_composite_frame = std::move(scheduled_composite_frame);
         scheduled_composite_frame = nullptr;
     }
@@ -24,6 +24,7 @@
 #include "mir/renderer/gl/render_target.h"
 #include "display_helpers.h"
 #include "egl_helper.h"
+#include "kms_output.h"
 #include "platform_common.h"
 
 #include <vector>
@@ -43,7 +44,6 @@ namespace mesa
 
 class Platform;
 class FBHandle;
-class KMSOutput;
 class NativeBuffer;
 
 class GBMOutputSurface : public renderer::gl::RenderTarget
@@ -128,11 +128,21 @@ public:
 
 private:
     bool schedule_page_flip(FBHandle const& bufobj);
+    bool schedule_scanout_layers_flip();
     void set_crtc(FBHandle const&);
+    bool assign_scanout_layers(RenderableList const& renderlist);
 
     std::shared_ptr<graphics::Buffer> visible_bypass_frame, scheduled_bypass_frame;
     std::shared_ptr<Buffer> bypass_buf{nullptr};
     FBHandle* bypass_bufobj{nullptr};
+
+    /*
+     * Renderables put straight onto hardware planes, bottom to top, and the
+     * buffers backing them; held like the bypass frame above.
+     */
+    std::vector<ScanoutLayer> layers;
+    std::vector<std::shared_ptr<Buffer>> layer_bufs;
+    std::vector<std::shared_ptr<Buffer>> visible_layer_frames, scheduled_layer_frames;
     std::shared_ptr<DisplayReport> const listener;
     BypassOption bypass_option;
 
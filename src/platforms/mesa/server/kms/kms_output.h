@@ -22,6 +22,7 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/point.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/rectangle.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/graphics/frame.h"
 #include "mir_toolkit/common.h"
@@ -29,6 +30,7 @@
 #include "kms-utils/drm_mode_resources.h"
 
 #include <gbm.h>
+#include <vector>
 
 namespace mir
 {
@@ -41,6 +43,19 @@ namespace mesa
 
 class FBHandle;
 
+/**
+ * A framebuffer to be scanned out on its own hardware plane.
+ *
+ * \p source is in framebuffer pixels; \p destination is relative to the
+ * top left of the output. No scaling is implied by either.
+ */
+struct ScanoutLayer
+{
+    FBHandle const* fb;
+    geometry::Rectangle source;
+    geometry::Rectangle destination;
+};
+
 class KMSOutput
 {
 public:
@@ -69,6 +84,25 @@ public:
     virtual bool schedule_page_flip(FBHandle const& fb) = 0;
     virtual void wait_for_page_flip() = 0;
 
+    /**
+     * The number of hardware planes that can be used for scanout layers.
+     *
+     * Zero if the driver does not support atomic modesetting.
+     */
+    virtual size_t max_scanout_layers() = 0;
+    /**
+     * Check (without touching the hardware state) whether the driver can scan
+     * out \p layers, stacked bottom to top, on this output.
+     */
+    virtual bool test_scanout_layers(std::vector<ScanoutLayer> const& layers) = 0;
+    /**
+     * Schedule \p layers for display at the next vblank; any planes previously
+     * used by this output and not covered by \p layers are disabled.
+     *
+     * Completion is waited for with wait_for_page_flip().
+     */
+    virtual bool schedule_scanout_layers_flip(std::vector<ScanoutLayer> const& layers) = 0;
+
     virtual bool set_cursor(gbm_bo* buffer) = 0;
     virtual void move_cursor(geometry::Point destination) = 0;
     virtual bool clear_cursor() = 0;
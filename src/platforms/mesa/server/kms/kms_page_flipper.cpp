@@ -88,6 +88,31 @@ bool mgm::KMSPageFlipper::schedule_flip(uint32_t crtc_id,
     return (ret == 0);
 }
 
+bool mgm::KMSPageFlipper::schedule_atomic_flip(uint32_t crtc_id,
+                                               uint32_t connector_id,
+                                               drmModeAtomicReq* request)
+{
+    std::unique_lock<std::mutex> lock{pf_mutex};
+
+    if (pending_page_flips.find(crtc_id) != pending_page_flips.end())
+        BOOST_THROW_EXCEPTION(std::logic_error("Page flip for crtc_id is already scheduled"));
+
+    pending_page_flips[crtc_id] = PageFlipEventData{crtc_id, connector_id, this};
+
+    /*
+     * Atomic commits deliver one event per CRTC in the request, through the
+     * same page_flip_handler as legacy page flips.
+     */
+    auto ret = drmModeAtomicCommit(drm_fd, request,
+                                   DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT,
+                                   &pending_page_flips[crtc_id]);
+
+    if (ret)
+        pending_page_flips.erase(crtc_id);
+
+    return (ret == 0);
+}
+
 mg::Frame mgm::KMSPageFlipper::wait_for_flip(uint32_t crtc_id)
 {
     drmEventContext evctx;
@@ -21,6 +21,7 @@
 
 #include "mir/graphics/frame.h"
 #include <cstdint>
+#include <xf86drmMode.h>
 
 namespace mir
 {
@@ -35,6 +36,11 @@ public:
     virtual ~PageFlipper() {}
 
     virtual bool schedule_flip(uint32_t crtc_id, uint32_t fb_id, uint32_t connector_id) = 0;
+    /**
+     * Commit an atomic request touching only \p crtc_id as a page flip;
+     * completion is waited for with wait_for_flip(crtc_id) as usual.
+     */
+    virtual bool schedule_atomic_flip(uint32_t crtc_id, uint32_t connector_id, drmModeAtomicReq* request) = 0;
     virtual Frame wait_for_flip(uint32_t crtc_id) = 0;
 
 protected:
@@ -26,6 +26,7 @@
 #include <sys/stat.h>
 
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 #include <system_error>
 #include <xf86drm.h>
 
@@ -69,6 +70,42 @@ void bo_user_data_destroy(gbm_bo* /*bo*/, void *data)
     delete bufobj;
 }
 
+void add_plane_properties(
+    drmModeAtomicReq* request,
+    uint32_t plane_id,
+    mgk::ObjectProperties const& props,
+    uint32_t crtc_id,
+    mgm::ScanoutLayer const& layer)
+{
+    /* Source viewport. Coordinates are 16.16 fixed point format */
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("SRC_X"),
+                             static_cast<uint64_t>(layer.source.top_left.x.as_int()) << 16);
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("SRC_Y"),
+                             static_cast<uint64_t>(layer.source.top_left.y.as_int()) << 16);
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("SRC_W"),
+                             static_cast<uint64_t>(layer.source.size.width.as_int()) << 16);
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("SRC_H"),
+                             static_cast<uint64_t>(layer.source.size.height.as_int()) << 16);
+
+    /* Destination viewport. Coordinates are *not* 16.16 */
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_X"),
+                             layer.destination.top_left.x.as_int());
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_Y"),
+                             layer.destination.top_left.y.as_int());
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_W"),
+                             layer.destination.size.width.as_int());
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_H"),
+                             layer.destination.size.height.as_int());
+
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("FB_ID"), layer.fb->get_drm_fb_id());
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_ID"), crtc_id);
+}
+
+void add_plane_disable(drmModeAtomicReq* request, uint32_t plane_id, mgk::ObjectProperties const& props)
+{
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("FB_ID"), 0);
+    drmModeAtomicAddProperty(request, plane_id, props.id_for("CRTC_ID"), 0);
+}
 }
 
 mgm::RealKMSOutput::RealKMSOutput(
@@ -101,6 +138,7 @@ mgm::RealKMSOutput::RealKMSOutput(
 
 mgm::RealKMSOutput::~RealKMSOutput()
 {
+    disable_overlay_planes();
     restore_saved_crtc();
 }
 
@@ -172,6 +210,9 @@ bool mgm::RealKMSOutput::set_crtc(FBHandle const& fb)
         return false;
     }
 
+    /* drmModeSetCrtc() only replaces the primary plane */
+    disable_overlay_planes();
+
     auto ret = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                               fb.get_drm_fb_id(), fb_offset.dx.as_int(), fb_offset.dy.as_int(),
                               &connector->connector_id, 1,
@@ -203,6 +244,8 @@ void mgm::RealKMSOutput::clear_crtc()
         return;
     }
 
+    disable_overlay_planes();
+
     auto result = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                                  0, 0, 0, nullptr, 0, nullptr);
     if (result)
@@ -242,6 +285,17 @@ bool mgm::RealKMSOutput::schedule_page_flip(FBHandle const& fb)
                        mgk::connector_name(connector).c_str());
         return false;
     }
+
+    /*
+     * A legacy page flip would leave any overlay planes from a previous
+     * layered frame on screen, so replace them all in one commit instead.
+     */
+    if (planes_in_use > 1)
+    {
+        geom::Point const fb_origin{fb_offset.dx.as_int(), fb_offset.dy.as_int()};
+        return flip_layers({{&fb, {fb_origin, size()}, {{0, 0}, size()}}});
+    }
+
     return page_flipper->schedule_flip(
         current_crtc->crtc_id,
         fb.get_drm_fb_id(),
@@ -262,6 +316,180 @@ void mgm::RealKMSOutput::wait_for_page_flip()
     last_frame_.store(page_flipper->wait_for_flip(current_crtc->crtc_id));
 }
 
+size_t mgm::RealKMSOutput::max_scanout_layers()
+{
+    if (!ensure_planes())
+        return 0;
+
+    return planes.size();
+}
+
+bool mgm::RealKMSOutput::test_scanout_layers(std::vector<ScanoutLayer> const& layers)
+{
+    if (!ensure_planes() || layers.empty() || layers.size() > planes.size())
+        return false;
+
+    auto const request = layers_request(layers);
+    return drmModeAtomicCommit(drm_fd_, request.get(), DRM_MODE_ATOMIC_TEST_ONLY, nullptr) == 0;
+}
+
+bool mgm::RealKMSOutput::schedule_scanout_layers_flip(std::vector<ScanoutLayer> const& layers)
+{
+    std::unique_lock<std::mutex> lg(power_mutex);
+    if (power_mode != mir_power_mode_on)
+        return true;
+    if (!current_crtc)
+    {
+        mir::log_error("Output %s has no associated CRTC to schedule page flips on",
+                       mgk::connector_name(connector).c_str());
+        return false;
+    }
+
+    return flip_layers(layers);
+}
+
+bool mgm::RealKMSOutput::flip_layers(std::vector<ScanoutLayer> const& layers)
+{
+    if (!ensure_planes() || layers.empty() || layers.size() > planes.size())
+        return false;
+
+    auto const request = layers_request(layers);
+    if (!page_flipper->schedule_atomic_flip(
+            current_crtc->crtc_id,
+            connector->connector_id,
+            request.get()))
+    {
+        return false;
+    }
+
+    planes_in_use = layers.size();
+    return true;
+}
+
+auto mgm::RealKMSOutput::layers_request(std::vector<ScanoutLayer> const& layers) const
+    -> AtomicRequestUPtr
+{
+    AtomicRequestUPtr request{drmModeAtomicAlloc(), &drmModeAtomicFree};
+
+    auto const in_request = std::max(layers.size(), planes_in_use);
+    for (size_t i = 0; i != in_request; ++i)
+    {
+        auto const plane_id = planes[i];
+        auto const& props = plane_properties.at(plane_id);
+
+        if (i < layers.size())
+            add_plane_properties(request.get(), plane_id, props, current_crtc->crtc_id, layers[i]);
+        else
+            add_plane_disable(request.get(), plane_id, props);
+    }
+
+    return request;
+}
+
+void mgm::RealKMSOutput::disable_overlay_planes()
+{
+    if (planes_in_use <= 1 || !current_crtc || planes_crtc_id != current_crtc->crtc_id)
+    {
+        planes_in_use = 0;
+        return;
+    }
+
+    AtomicRequestUPtr request{drmModeAtomicAlloc(), &drmModeAtomicFree};
+    for (size_t i = 1; i != planes_in_use; ++i)
+        add_plane_disable(request.get(), planes[i], plane_properties.at(planes[i]));
+
+    if (auto result = drmModeAtomicCommit(drm_fd_, request.get(), 0, nullptr))
+    {
+        mir::log_warning("Failed to disable overlay planes on output %s (%s)",
+                         mgk::connector_name(connector).c_str(),
+                         strerror(-result));
+    }
+
+    planes_in_use = 0;
+}
+
+bool mgm::RealKMSOutput::ensure_planes()
+{
+    if (!current_crtc)
+        return false;
+
+    if (planes_crtc_id == current_crtc->crtc_id)
+        return !planes.empty();
+
+    planes_crtc_id = current_crtc->crtc_id;
+    planes.clear();
+    plane_properties.clear();
+    planes_in_use = 0;
+
+    /* Plane assignment is only safe with atomic test commits */
+    if (drmSetClientCap(drm_fd_, DRM_CLIENT_CAP_ATOMIC, 1))
+        return false;
+
+    try
+    {
+        kms::DRMModeResources resources{drm_fd_};
+        uint32_t crtc_mask{0};
+        int crtc_index{0};
+        for (auto& crtc : resources.crtcs())
+        {
+            if (crtc->crtc_id == current_crtc->crtc_id)
+                crtc_mask = 1u << crtc_index;
+            ++crtc_index;
+        }
+
+        uint32_t primary{0};
+        std::vector<std::pair<uint64_t, uint32_t>> overlays;
+
+        mgk::PlaneResources plane_res{drm_fd_};
+        for (auto& plane : plane_res.planes())
+        {
+            if (!(plane->possible_crtcs & crtc_mask))
+                continue;
+
+            mgk::ObjectProperties props{drm_fd_, plane->plane_id, DRM_MODE_OBJECT_PLANE};
+            auto const type = props["type"];
+
+            /*
+             * Only take overlay planes that can't be moved to another CRTC;
+             * otherwise a test commit here could steal a plane some other
+             * output is scanning out of. The cursor plane stays with the
+             * legacy cursor API.
+             */
+            if (type == DRM_PLANE_TYPE_PRIMARY && !primary)
+            {
+                primary = plane->plane_id;
+            }
+            else if (type == DRM_PLANE_TYPE_OVERLAY && plane->possible_crtcs == crtc_mask)
+            {
+                overlays.emplace_back(props.has_property("zpos") ? props["zpos"] : 0, plane->plane_id);
+            }
+            else
+            {
+                continue;
+            }
+
+            plane_properties.emplace(plane->plane_id, std::move(props));
+        }
+
+        if (primary)
+        {
+            std::sort(overlays.begin(), overlays.end());
+
+            planes.push_back(primary);
+            for (auto const& overlay : overlays)
+                planes.push_back(overlay.second);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        mir::log_warning("Failed to probe planes of output %s: %s",
+                         mgk::connector_name(connector).c_str(), e.what());
+        planes.clear();
+    }
+
+    return !planes.empty();
+}
+
 mg::Frame mgm::RealKMSOutput::last_frame() const
 {
     return last_frame_.load();
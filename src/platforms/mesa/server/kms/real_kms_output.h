@@ -25,6 +25,8 @@
 
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace mir
 {
@@ -56,6 +58,10 @@ public:
     bool schedule_page_flip(FBHandle const& fb) override;
     void wait_for_page_flip() override;
 
+    size_t max_scanout_layers() override;
+    bool test_scanout_layers(std::vector<ScanoutLayer> const& layers) override;
+    bool schedule_scanout_layers_flip(std::vector<ScanoutLayer> const& layers) override;
+
     bool set_cursor(gbm_bo* buffer) override;
     void move_cursor(geometry::Point destination) override;
     bool clear_cursor() override;
@@ -74,8 +80,14 @@ public:
     bool buffer_requires_migration(gbm_bo* bo) const override;
     int drm_fd() const override;
 private:
+    typedef std::unique_ptr<drmModeAtomicReq, void(*)(drmModeAtomicReqPtr)> AtomicRequestUPtr;
+
     bool ensure_crtc();
     void restore_saved_crtc();
+    bool ensure_planes();
+    AtomicRequestUPtr layers_request(std::vector<ScanoutLayer> const& layers) const;
+    bool flip_layers(std::vector<ScanoutLayer> const& layers);
+    void disable_overlay_planes();
 
     int const drm_fd_;
     std::shared_ptr<PageFlipper> const page_flipper;
@@ -93,6 +105,15 @@ private:
 
     std::mutex power_mutex;
 
+    /*
+     * Planes usable by current_crtc: the primary plane followed by the
+     * overlay planes dedicated to it, bottom to top. Probed lazily.
+     */
+    uint32_t planes_crtc_id{0};
+    std::vector<uint32_t> planes;
+    std::unordered_map<uint32_t, kms::ObjectProperties> plane_properties;
+    size_t planes_in_use{0};
+
     AtomicFrame last_frame_;
 };
 
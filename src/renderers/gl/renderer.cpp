@@ -38,10 +38,14 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 
 namespace mg = mir::graphics;
@@ -159,6 +163,24 @@ private:
     GLuint id;
 };
 
+bool current_display_supports(char const* egl_extension)
+{
+    auto const display = eglGetCurrentDisplay();
+    if (display == EGL_NO_DISPLAY)
+        return false;
+
+    auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+    return extensions && strstr(extensions, egl_extension);
+}
+
+bool is_empty(mir::geometry::Rectangle const& rect)
+{
+    return rect.size.width.as_int() <= 0 || rect.size.height.as_int() <= 0;
+}
+
+// Frames older than this are redrawn in full; triple buffering is as deep as we go
+unsigned const max_buffer_age{3};
+
 using ProgramHandle = GLHandle<&glDeleteProgram>;
 using ShaderHandle = GLHandle<&glDeleteShader>;
 
@@ -357,7 +379,8 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
       alpha_program(family.add_program(vshader, alpha_fshader)),
       program_factory{std::make_unique<ProgramFactory>()},
       texture_cache(mgl::DefaultProgramFactory().create_texture_cache()),
-      display_transform(1)
+      display_transform(1),
+      has_buffer_age{current_display_supports("EGL_EXT_buffer_age")}
 {
     eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
     EGLDisplay disp = eglGetCurrentDisplay();
@@ -406,6 +429,7 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
     mir::log_info("GL framebuffer bits: RGBA=%d%d%d%d, depth=%d, stencil=%d",
                   rbits, gbits, bbits, abits, dbits, sbits);
 
+    glGenBuffers(1, &vertex_buffer);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     set_viewport(display_buffer.view_area());
@@ -414,6 +438,9 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
 mrg::Renderer::~Renderer()
 {
     render_target.ensure_current();
+
+    if (vertex_buffer)
+        glDeleteBuffers(1, &vertex_buffer);
 }
 
 void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
@@ -423,22 +450,114 @@ void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
     primitives[0] = mgl::tessellate_renderable_into_rectangle(renderable, geom::Displacement{0,0});
 }
 
+void mrg::Renderer::set_damage(geom::Rectangles const& damage)
+{
+    geom::Rectangles non_empty;
+    for (auto const& rect : damage)
+    {
+        if (!is_empty(rect))
+            non_empty.add(rect);
+    }
+
+    pending_damage = non_empty.bounding_rectangle();
+}
+
+auto mrg::Renderer::area_to_repaint() const -> std::experimental::optional<geom::Rectangle>
+{
+    if (!pending_damage || !partial_repaint_possible || !has_buffer_age || full_repaint_needed)
+        return std::experimental::nullopt;
+
+    // Buffer age describes the EGL surface; it tells us nothing about an FBO
+    GLint framebuffer{0};
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+    if (framebuffer != 0)
+        return std::experimental::nullopt;
+
+    EGLint age{0};
+    if (!eglQuerySurface(eglGetCurrentDisplay(), eglGetCurrentSurface(EGL_DRAW), EGL_BUFFER_AGE_EXT, &age))
+        return std::experimental::nullopt;
+
+    // An age of zero means the contents are undefined
+    if (age < 1 || static_cast<unsigned>(age) > damage_history.size() + 1)
+        return std::experimental::nullopt;
+
+    // The back buffer is missing the changes of the frames drawn since it was last used
+    geom::Rectangles area;
+    if (!is_empty(pending_damage.value()))
+        area.add(pending_damage.value());
+    for (auto frame = 0; frame != age - 1; ++frame)
+    {
+        if (!is_empty(damage_history[frame]))
+            area.add(damage_history[frame]);
+    }
+
+    return area.bounding_rectangle();
+}
+
+void mrg::Renderer::scissor_to(geom::Rectangle const& area) const
+{
+    glScissor(
+        area.top_left.x.as_int() - viewport.top_left.x.as_int(),
+        viewport.top_left.y.as_int() + viewport.size.height.as_int() -
+            area.top_left.y.as_int() - area.size.height.as_int(),
+        area.size.width.as_int(),
+        area.size.height.as_int());
+}
+
 void mrg::Renderer::render(mg::RenderableList const& renderables) const
 {
+    static glm::mat4 const identity(1);
+
     render_target.bind();
 
+    repaint_area = area_to_repaint();
+    if (repaint_area)
+    {
+        glEnable(GL_SCISSOR_TEST);
+        scissor_to(repaint_area.value());
+    }
+
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT);
 
     ++frameno;
+    batches.clear();
     for (auto const& r : renderables)
     {
-        draw(*r);
+        // Renderables wholly outside the repaint area can't change anything
+        if (repaint_area &&
+            r->transformation() == identity &&
+            !r->screen_position().overlaps(repaint_area.value()))
+        {
+            continue;
+        }
+
+        batches.push_back({r.get(), 0, 0});
     }
 
+    batch_vertices();
+
+    for (next_batch = 0; next_batch != batches.size(); ++next_batch)
+        draw(*batches[next_batch].renderable);
+
+    release_program();
+    current_blend = std::experimental::nullopt;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (repaint_area)
+        glDisable(GL_SCISSOR_TEST);
+
     render_target.swap_buffers();
 
+    // What changed since the previous frame is unknown if that frame wasn't ours
+    damage_history.push_front(full_repaint_needed ? viewport : pending_damage.value_or(viewport));
+    if (damage_history.size() > max_buffer_age)
+        damage_history.pop_back();
+    pending_damage = std::experimental::nullopt;
+    repaint_area = std::experimental::nullopt;
+    full_repaint_needed = false;
+
     // Deleting unused textures only requires the GL context. This clean-up
     // does not affect screen contents so can happen after swap_buffers...
     texture_cache->drop_unused();
@@ -447,22 +566,111 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
         mir::log_debug("GL error: %d", gl_error);
 }
 
+void mrg::Renderer::batch_vertices() const
+{
+    batched_vertices.clear();
+    batched_primitives.clear();
+
+    for (auto& batch : batches)
+    {
+        primitives.clear();
+        tessellate(primitives, *batch.renderable);
+
+        batch.first_primitive = batched_primitives.size();
+        batch.primitive_count = primitives.size();
+
+        for (auto const& p : primitives)
+        {
+            batched_primitives.push_back(
+                {p.type, static_cast<GLint>(batched_vertices.size()), static_cast<GLsizei>(p.nvertices)});
+            batched_vertices.insert(batched_vertices.end(), p.vertices, p.vertices + p.nvertices);
+        }
+    }
+
+    // One upload for the whole frame instead of client-side arrays for every draw
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    if (vertex_buffer)
+    {
+        glBufferData(GL_ARRAY_BUFFER,
+                     batched_vertices.size() * sizeof(mgl::Vertex),
+                     batched_vertices.data(),
+                     GL_STREAM_DRAW);
+    }
+}
+
+void mrg::Renderer::use_program(Program const& prog, bool point_at_batch) const
+{
+    if (&prog != current_program)
+    {
+        release_program();
+
+        glUseProgram(prog.id);
+        glEnableVertexAttribArray(prog.position_attr);
+        glEnableVertexAttribArray(prog.texcoord_attr);
+        current_program = &prog;
+    }
+
+    if (point_at_batch && !attribs_point_at_batch)
+    {
+        // Without a buffer object the frame's vertices are passed as a client-side array
+        auto const base = vertex_buffer ? 0 : reinterpret_cast<std::uintptr_t>(batched_vertices.data());
+
+        glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+        glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
+                              GL_FALSE, sizeof(mgl::Vertex),
+                              reinterpret_cast<GLvoid const*>(base + offsetof(mgl::Vertex, position)));
+        glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
+                              GL_FALSE, sizeof(mgl::Vertex),
+                              reinterpret_cast<GLvoid const*>(base + offsetof(mgl::Vertex, texcoord)));
+        attribs_point_at_batch = true;
+    }
+}
+
+void mrg::Renderer::release_program() const
+{
+    if (current_program)
+    {
+        glDisableVertexAttribArray(current_program->texcoord_attr);
+        glDisableVertexAttribArray(current_program->position_attr);
+    }
+
+    current_program = nullptr;
+    attribs_point_at_batch = false;
+}
+
+void mrg::Renderer::set_blend(BlendState const& blend) const
+{
+    if (blend.dst_rgb == GL_ZERO)
+    {
+        if (!current_blend || current_blend.value().dst_rgb != GL_ZERO)
+            glDisable(GL_BLEND);
+    }
+    else
+    {
+        if (!current_blend || current_blend.value().dst_rgb == GL_ZERO)
+            glEnable(GL_BLEND);
+
+        if (!current_blend ||
+            current_blend.value().src_rgb != blend.src_rgb ||
+            current_blend.value().dst_rgb != blend.dst_rgb ||
+            current_blend.value().src_alpha != blend.src_alpha ||
+            current_blend.value().dst_alpha != blend.dst_alpha)
+        {
+            glBlendFuncSeparate(blend.src_rgb,   blend.dst_rgb,
+                                blend.src_alpha, blend.dst_alpha);
+        }
+    }
+
+    current_blend = blend;
+}
+
 void mrg::Renderer::draw(mg::Renderable const& renderable) const
 {
     auto const clip_area = renderable.clip_area();
     if (clip_area)
     {
         glEnable(GL_SCISSOR_TEST);
-        glScissor(
-            clip_area.value().top_left.x.as_int() -
-                viewport.top_left.x.as_int(),
-            viewport.top_left.y.as_int() +
-                viewport.size.height.as_int() -
-                clip_area.value().top_left.y.as_int() -
-                clip_area.value().size.height.as_int(),
-            clip_area.value().size.width.as_int(), 
-            clip_area.value().size.height.as_int()
-        );
+        scissor_to(repaint_area ? clip_area.value().intersection_with(repaint_area.value()) : clip_area.value());
     }
 
     auto const texture = std::dynamic_pointer_cast<mg::gl::Texture>(renderable.buffer());
@@ -514,7 +722,12 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
 
     auto const& prog = *maybe_prog;
 
-    glUseProgram(prog.id);
+    // Normally we are drawing the renderables batched by render(); anything else gets
+    // tessellated here and drawn from client-side arrays
+    auto const batched =
+        next_batch < batches.size() && batches[next_batch].renderable == &renderable;
+
+    use_program(prog, batched);
     if (prog.last_used_frameno != frameno)
     {   // Avoid reloading the screen-global uniforms on every renderable
         // TODO: We actually only need to bind these *once*, right? Not once per frame?
@@ -560,21 +773,16 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
     if (prog.alpha_uniform >= 0)
         glUniform1f(prog.alpha_uniform, renderable.alpha());
 
-    glEnableVertexAttribArray(prog.position_attr);
-    glEnableVertexAttribArray(prog.texcoord_attr);
-
-    primitives.clear();
-    tessellate(primitives, renderable);
+    if (!batched)
+    {
+        primitives.clear();
+        tessellate(primitives, renderable);
+    }
 
     // if we fail to load the texture, we need to carry on (part of lp:1629275)
     try
     {
-        typedef struct  // Represents parameters of glBlendFuncSeparate()
-        {
-            GLenum src_rgb, dst_rgb, src_alpha, dst_alpha;
-        } BlendSeparate;
-
-        BlendSeparate client_blend;
+        BlendState client_blend;
 
         // These renderable method names could be better (see LP: #1236224)
         if (renderable.shaped())  // Client is RGBA:
@@ -596,57 +804,68 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
             glBlendColor(0.0f, 0.0f, 0.0f, renderable.alpha());
         }
 
-        for (auto const& p : primitives)
+        if (surface_tex)
         {
-            BlendSeparate blend;
-
-            blend = client_blend;
-            if (surface_tex)
-            {
-                surface_tex->bind();
-            }
-            else
-            {
-                texture->bind();
-            }
+            surface_tex->bind();
+        }
+        else
+        {
+            texture->bind();
+        }
 
-            glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
-                                  GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].position);
-            glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
-                                  GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].texcoord);
+        set_blend(client_blend);
 
-            if (blend.dst_rgb == GL_ZERO)
-            {
-                glDisable(GL_BLEND);
-            }
-            else
+        if (batched)
+        {
+            auto const& batch = batches[next_batch];
+            for (auto i = batch.first_primitive; i != batch.first_primitive + batch.primitive_count; ++i)
             {
-                glEnable(GL_BLEND);
-                glBlendFuncSeparate(blend.src_rgb,   blend.dst_rgb,
-                                    blend.src_alpha, blend.dst_alpha);
+                auto const& p = batched_primitives[i];
+                glDrawArrays(p.type, p.first_vertex, p.vertex_count);
             }
+        }
+        else
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            attribs_point_at_batch = false;
 
-            glDrawArrays(p.type, 0, p.nvertices);
-
-            if (texture)
+            for (auto const& p : primitives)
             {
-                // We're done with the texture for now
-                texture->add_syncpoint();
+                glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
+                                      GL_FALSE, sizeof(mgl::Vertex),
+                                      &p.vertices[0].position);
+                glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
+                                      GL_FALSE, sizeof(mgl::Vertex),
+                                      &p.vertices[0].texcoord);
+
+                glDrawArrays(p.type, 0, p.nvertices);
             }
         }
+
+        if (texture)
+        {
+            // We're done with the texture for now
+            texture->add_syncpoint();
+        }
     }
     catch (std::exception const& ex)
     {
         report_exception();
     }
 
-    glDisableVertexAttribArray(prog.texcoord_attr);
-    glDisableVertexAttribArray(prog.position_attr);
-    if (renderable.clip_area())
+    if (!batched)
     {
-        glDisable(GL_SCISSOR_TEST);
+        // We don't know what will be drawn next, so don't leave any state behind
+        release_program();
+        current_blend = std::experimental::nullopt;
+    }
+
+    if (clip_area)
+    {
+        if (repaint_area)
+            scissor_to(repaint_area.value());
+        else
+            glDisable(GL_SCISSOR_TEST);
     }
 }
 
@@ -702,6 +921,11 @@ void mrg::Renderer::update_gl_viewport()
      */
     render_target.ensure_current();
 
+    // What is on screen no longer matches our damage history
+    damage_history.clear();
+    full_repaint_needed = true;
+    partial_repaint_possible = false;
+
     auto transformed_viewport = display_transform *
                                 glm::vec4(viewport.size.width.as_int(),
                                           viewport.size.height.as_int(), 0, 1);
@@ -726,6 +950,12 @@ void mrg::Renderer::update_gl_viewport()
         GLint offset_y = (buf_height - reduced_height) / 2;
 
         glViewport(offset_x, offset_y, reduced_width, reduced_height);
+
+        partial_repaint_possible =
+            display_transform == glm::mat4(1) &&
+            offset_x == 0 && offset_y == 0 &&
+            reduced_width == viewport.size.width.as_int() &&
+            reduced_height == viewport.size.height.as_int();
     }
 }
 
@@ -742,5 +972,10 @@ void mrg::Renderer::set_output_transform(glm::mat2 const& t)
 void mrg::Renderer::suspend()
 {
     texture_cache->invalidate();
+
+    // Whatever replaced our rendering (e.g. overlays) didn't draw into our buffers, so
+    // they hold what was on screen before it, whatever their age
+    damage_history.clear();
+    full_repaint_needed = true;
 }
 
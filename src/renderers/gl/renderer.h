@@ -29,6 +29,8 @@
 #include "mir/renderer/gl/render_target.h"
 
 #include MIR_SERVER_GL_H
+#include <deque>
+#include <experimental/optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -65,6 +67,7 @@ public:
     // These are called with a valid GL context:
     void set_viewport(geometry::Rectangle const& rect) override;
     void set_output_transform(glm::mat2 const&) override;
+    void set_damage(geometry::Rectangles const& damage) override;
     void render(graphics::RenderableList const&) const override;
 
     // This is called _without_ a GL context:
@@ -127,6 +130,41 @@ protected:
 
 private:
     void update_gl_viewport();
+    auto area_to_repaint() const -> std::experimental::optional<geometry::Rectangle>;
+    void scissor_to(geometry::Rectangle const& area) const;
+
+    struct BlendState
+    {
+        GLenum src_rgb, dst_rgb, src_alpha, dst_alpha;
+    };
+
+    /// The primitives of one renderable, within the frame's vertex buffer
+    struct Batch
+    {
+        graphics::Renderable const* renderable;
+        std::size_t first_primitive;
+        std::size_t primitive_count;
+    };
+
+    struct BatchedPrimitive
+    {
+        GLenum type;
+        GLint first_vertex;
+        GLsizei vertex_count;
+    };
+
+    void batch_vertices() const;
+    void use_program(Program const& prog, bool point_at_batch) const;
+    void release_program() const;
+    void set_blend(BlendState const& blend) const;
+
+    /*
+     * GL state is only tracked within a frame; anything else sharing the
+     * context is free to change it between frames.
+     */
+    mutable Program const* current_program{nullptr};
+    bool mutable attribs_point_at_batch{false};
+    std::experimental::optional<BlendState> mutable current_blend;
 
     class ProgramFactory;
     std::unique_ptr<ProgramFactory> const program_factory;
@@ -135,6 +173,20 @@ private:
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
     std::vector<mir::gl::Primitive> mutable primitives;
+
+    // All the vertices of a frame go into one buffer object, uploaded once per frame
+    GLuint vertex_buffer{0};
+    std::vector<mir::gl::Vertex> mutable batched_vertices;
+    std::vector<BatchedPrimitive> mutable batched_primitives;
+    std::vector<Batch> mutable batches;
+    std::size_t mutable next_batch{0};
+
+    bool const has_buffer_age;
+    bool partial_repaint_possible{false}; // Screen coordinates map 1:1 onto the framebuffer
+    std::experimental::optional<geometry::Rectangle> mutable pending_damage;
+    std::experimental::optional<geometry::Rectangle> mutable repaint_area;
+    std::deque<geometry::Rectangle> mutable damage_history; // Most recent frame first
+    bool mutable full_repaint_needed{true}; // Our back buffers may not hold what we last drew
 };
 
 }
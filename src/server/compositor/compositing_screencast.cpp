@@ -18,6 +18,7 @@
 
 #include "compositing_screencast.h"
 #include "screencast_display_buffer.h"
+#include "damage_tracker.h"
 #include "queueing_schedule.h"
 #include "mir/graphics/buffer.h"
 #include "mir/graphics/buffer_properties.h"
@@ -28,6 +29,7 @@
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/graphics/transformation.h"
 #include "mir/compositor/display_buffer_compositor.h"
+#include "mir/compositor/scene_element.h"
 #include "mir/geometry/rectangles.h"
 #include "mir/raii.h"
 
@@ -99,18 +101,23 @@ public:
     std::shared_ptr<mg::Buffer> capture()
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
-        if (queue_size != display_buffer->renderbuffer_size())
-            display_buffer->set_renderbuffer_size(queue_size);
+        auto elements = scene->scene_elements_for(this);
+        damage_tracker.damage_for(renderables_of(elements), display_buffer->view_area());
 
-        //FIXME:: the client needs a better way to express it is no longer
-        //using the last captured buffer
-        if (last_captured_buffer)
-            free_queue.schedule(last_captured_buffer);
+        return composite(std::move(elements));
+    }
 
-        display_buffer_compositor->composite(scene->scene_elements_for(this));
+    mf::ScreencastFrame capture_if_damaged()
+    {
+        std::lock_guard<decltype(mutex)> lk(mutex);
+        auto elements = scene->scene_elements_for(this);
+        auto damage = damage_tracker.damage_for(renderables_of(elements), display_buffer->view_area());
 
-        last_captured_buffer = ready_queue.next_buffer();
-        return last_captured_buffer;
+        // Nothing changed, so the consumer already has the current contents
+        if (last_captured_buffer && damage.size() == 0)
+            return {last_captured_buffer, {}};
+
+        return {composite(std::move(elements)), std::move(damage)};
     }
 
     void capture(std::shared_ptr<mg::Buffer> const& buffer)
@@ -147,6 +154,32 @@ public:
     }
 
 private:
+    static auto renderables_of(SceneElementSequence const& elements) -> mg::RenderableList
+    {
+        mg::RenderableList renderables;
+        renderables.reserve(elements.size());
+        for (auto const& element : elements)
+            renderables.push_back(element->renderable());
+
+        return renderables;
+    }
+
+    std::shared_ptr<mg::Buffer> composite(SceneElementSequence&& elements)
+    {
+        if (queue_size != display_buffer->renderbuffer_size())
+            display_buffer->set_renderbuffer_size(queue_size);
+
+        //FIXME:: the client needs a better way to express it is no longer
+        //using the last captured buffer
+        if (last_captured_buffer)
+            free_queue.schedule(last_captured_buffer);
+
+        display_buffer_compositor->composite(std::move(elements));
+
+        last_captured_buffer = ready_queue.next_buffer();
+        return last_captured_buffer;
+    }
+
     std::mutex mutex;
     std::shared_ptr<Scene> const scene;
     QueueingSchedule free_queue;
@@ -156,6 +189,7 @@ private:
     std::unique_ptr<compositor::DisplayBufferCompositor> display_buffer_compositor;
     std::unique_ptr<graphics::VirtualOutput> virtual_output;
     std::shared_ptr<mg::Buffer> last_captured_buffer;
+    DamageTracker damage_tracker;
     geom::Size queue_size;
     MirMirrorMode mirror_mode;
 };
@@ -224,6 +258,11 @@ std::shared_ptr<mg::Buffer> mc::CompositingScreencast::capture(mf::ScreencastSes
     return session(id)->capture();
 }
 
+mf::ScreencastFrame mc::CompositingScreencast::capture_if_damaged(mf::ScreencastSessionId id)
+{
+    return session(id)->capture_if_damaged();
+}
+
 mf::ScreencastSessionId mc::CompositingScreencast::next_available_session_id()
 {
     for (uint32_t i = 1; i <= max_screencast_sessions; ++i)
@@ -0,0 +1,186 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "damage_tracker.h"
+#include "mir/graphics/buffer.h"
+#include "mir/geometry/displacement.h"
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+geom::Rectangle visible_area_of(
+    geom::Rectangle const& screen_position,
+    std::experimental::optional<geom::Rectangle> const& clip_area)
+{
+    return clip_area ? screen_position.intersection_with(clip_area.value()) : screen_position;
+}
+
+void add_clipped(geom::Rectangles& damage, geom::Rectangle const& rect, geom::Rectangle const& view_area)
+{
+    auto const clipped = rect.intersection_with(view_area);
+    if (clipped != geom::Rectangle{})
+        damage.add(clipped);
+}
+
+// Damage of the renderable's buffer translated into screen coordinates, if we can.
+bool add_buffer_damage(
+    geom::Rectangles& damage,
+    mg::Renderable const& renderable,
+    mg::BufferID previous_buffer,
+    geom::Size const& buffer_size,
+    geom::Rectangle const& view_area)
+{
+    auto const& position = renderable.screen_position();
+
+    // Scaled content smears damage across neighbouring pixels; don't try to be clever
+    if (position.size != buffer_size)
+        return false;
+
+    auto const buffer_damage = renderable.damage_since(previous_buffer);
+    if (!buffer_damage)
+        return false;
+
+    auto const visible_area = visible_area_of(position, renderable.clip_area());
+    geom::Rectangle const buffer_rect{{}, buffer_size};
+    auto const offset = position.top_left - geom::Point{};
+
+    for (auto const& rect : *buffer_damage)
+    {
+        auto screen_rect = rect.intersection_with(buffer_rect);
+        screen_rect.top_left = screen_rect.top_left + offset;
+        add_clipped(damage, screen_rect.intersection_with(visible_area), view_area);
+    }
+
+    return true;
+}
+}
+
+auto mc::DamageTracker::damage_for(mg::RenderableList const& renderables, geom::Rectangle const& view_area)
+    -> geom::Rectangles
+{
+    static glm::mat4 const identity(1);
+
+    std::unordered_map<mg::Renderable::ID, DrawnState> current_frame;
+    std::vector<mg::Renderable::ID> current_order;
+    current_order.reserve(renderables.size());
+
+    geom::Rectangles damage;
+    bool everything_damaged = !previous_view_area || previous_view_area.value() != view_area;
+
+    auto const damage_whole_of = [&](DrawnState const& state)
+        {
+            // We don't know where a transformed renderable ends up on screen
+            if (state.transformation != identity)
+                everything_damaged = true;
+            else
+                add_clipped(damage, visible_area_of(state.screen_position, state.clip_area), view_area);
+        };
+
+    for (auto const& renderable : renderables)
+    {
+        auto const buffer = renderable->buffer();
+        DrawnState const state{
+            renderable->screen_position(),
+            renderable->clip_area(),
+            renderable->transformation(),
+            renderable->alpha(),
+            renderable->shaped(),
+            buffer ? buffer->id() : mg::BufferID{}};
+
+        auto const id = renderable->id();
+        current_order.push_back(id);
+        current_frame.emplace(id, state);
+
+        if (everything_damaged)
+            continue;
+
+        auto const previous = previous_frame.find(id);
+        if (previous == previous_frame.end())
+        {
+            damage_whole_of(state);
+            continue;
+        }
+
+        auto const& old_state = previous->second;
+        if (old_state.screen_position != state.screen_position ||
+            old_state.clip_area != state.clip_area ||
+            old_state.transformation != state.transformation ||
+            old_state.alpha != state.alpha ||
+            old_state.shaped != state.shaped)
+        {
+            damage_whole_of(old_state);
+            damage_whole_of(state);
+        }
+        else if (old_state.buffer_id != state.buffer_id)
+        {
+            if (!buffer || state.transformation != identity ||
+                !add_buffer_damage(damage, *renderable, old_state.buffer_id, buffer->size(), view_area))
+            {
+                damage_whole_of(state);
+            }
+        }
+    }
+
+    if (!everything_damaged)
+    {
+        // Anything that went away exposes whatever was beneath it
+        for (auto const& previous : previous_frame)
+        {
+            if (current_frame.find(previous.first) == current_frame.end())
+                damage_whole_of(previous.second);
+        }
+    }
+
+    if (!everything_damaged)
+    {
+        // A change of stacking order between surviving renderables can change
+        // any pixel where they overlap. Restacking is rare, so keep this simple.
+        std::vector<mg::Renderable::ID> surviving_previous;
+        for (auto const id : previous_order)
+        {
+            if (current_frame.find(id) != current_frame.end())
+                surviving_previous.push_back(id);
+        }
+        std::vector<mg::Renderable::ID> surviving_current;
+        for (auto const id : current_order)
+        {
+            if (previous_frame.find(id) != previous_frame.end())
+                surviving_current.push_back(id);
+        }
+
+        if (surviving_previous != surviving_current)
+            everything_damaged = true;
+    }
+
+    previous_frame = std::move(current_frame);
+    previous_order = std::move(current_order);
+    previous_view_area = view_area;
+
+    if (everything_damaged)
+        return geom::Rectangles{view_area};
+
+    return damage;
+}
+
+void mc::DamageTracker::reset()
+{
+    previous_frame.clear();
+    previous_order.clear();
+    previous_view_area = std::experimental::nullopt;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+#define MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+
+#include "mir/graphics/renderable.h"
+#include "mir/graphics/buffer_id.h"
+#include "mir/geometry/rectangles.h"
+
+#include <experimental/optional>
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace compositor
+{
+
+/**
+ * Works out which parts of a display buffer changed between consecutive frames.
+ *
+ * One DamageTracker is used per display buffer; it remembers what was drawn in
+ * the previous frame and compares it against the renderables of the next one.
+ */
+class DamageTracker
+{
+public:
+    /**
+     * The area (in screen coordinates, clipped to \a view_area) that differs
+     * between the previous frame and \a renderables.
+     */
+    auto damage_for(graphics::RenderableList const& renderables, geometry::Rectangle const& view_area)
+        -> geometry::Rectangles;
+
+    /// Forget the previous frame so the next one is considered entirely damaged
+    void reset();
+
+private:
+    struct DrawnState
+    {
+        geometry::Rectangle screen_position;
+        std::experimental::optional<geometry::Rectangle> clip_area;
+        glm::mat4 transformation;
+        float alpha;
+        bool shaped;
+        graphics::BufferID buffer_id;
+    };
+
+    std::unordered_map<graphics::Renderable::ID, DrawnState> previous_frame;
+    std::vector<graphics::Renderable::ID> previous_order;
+    std::experimental::optional<geometry::Rectangle> previous_view_area;
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_DAMAGE_TRACKER_H_ */
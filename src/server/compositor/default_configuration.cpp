@@ -79,7 +79,8 @@ mir::DefaultServerConfiguration::the_compositor()
                 the_shell(),
                 the_compositor_report(),
                 composite_delay,
-                !the_options()->is_set(options::host_socket_opt));
+                !the_options()->is_set(options::host_socket_opt),
+                the_options()->get<bool>(options::composite_before_vblank_opt));
         });
 }
 
@@ -72,15 +72,21 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
      */
     scene_elements.clear();  // Those in use are still in renderable_list
 
+    auto const damage = damage_tracker.damage_for(renderable_list, view_area);
+
     if (display_buffer.overlay(renderable_list))
     {
         report->renderables_in_frame(this, renderable_list);
         renderer->suspend();
+
+        // The next frame we render is drawn over whatever we rendered last, not over this one
+        damage_tracker.reset();
     }
     else
     {
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
+        renderer->set_damage(damage);
         renderer->render(renderable_list);
 
         report->renderables_in_frame(this, renderable_list);
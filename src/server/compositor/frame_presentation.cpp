@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/compositor/frame_presentation.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+namespace mc = mir::compositor;
+
+namespace
+{
+thread_local std::vector<std::function<void(mc::FramePresentation const&)>>* pending_on_this_thread{nullptr};
+
+auto presented_now() -> mc::FramePresentation
+{
+    mc::FramePresentation presentation;
+    presentation.frame.ust = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+    return presentation;
+}
+}
+
+void mc::on_frame_presented(std::function<void(FramePresentation const&)>&& work)
+{
+    if (pending_on_this_thread)
+        pending_on_this_thread->push_back(std::move(work));
+    else
+        work(presented_now());
+}
+
+mc::FramePresentationScope::FramePresentationScope()
+{
+    if (pending_on_this_thread)
+        BOOST_THROW_EXCEPTION(std::logic_error{"Thread is already collecting frame presentation work"});
+
+    pending_on_this_thread = &pending;
+}
+
+mc::FramePresentationScope::~FramePresentationScope()
+{
+    pending_on_this_thread = nullptr;
+
+    // Don't leave anyone waiting on a frame that will never be posted
+    if (!pending.empty())
+        presented(presented_now());
+}
+
+void mc::FramePresentationScope::presented(FramePresentation const& presentation)
+{
+    decltype(pending) work;
+    work.swap(pending);
+
+    for (auto const& w : work)
+        w(presentation);
+}
@@ -19,11 +19,13 @@
 #include "multi_threaded_compositor.h"
 #include "mir/graphics/display.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/display_configuration.h"
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/compositor/display_listener.h"
 #include "mir/compositor/scene.h"
 #include "mir/compositor/compositor_report.h"
+#include "mir/compositor/frame_presentation.h"
 #include "mir/scene/legacy_scene_change_notification.h"
 #include "mir/scene/surface_observer.h"
 #include "mir/scene/surface.h"
@@ -35,6 +37,8 @@
 #include <thread>
 #include <chrono>
 #include <condition_variable>
+#include <algorithm>
+#include <array>
 #include <boost/throw_exception.hpp>
 
 using namespace std::literals::chrono_literals;
@@ -43,6 +47,94 @@ namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 
+namespace
+{
+/*
+ * Predicts how long the next frame will take to composite from the most
+ * recent ones. Taking the worst of them rather than an average means one
+ * slow frame in a run of fast ones doesn't make us miss the next vblank.
+ */
+class RenderTimePredictor
+{
+public:
+    void record(std::chrono::nanoseconds render_time)
+    {
+        history[next] = render_time;
+        next = (next + 1) % history.size();
+    }
+
+    std::chrono::nanoseconds predicted() const
+    {
+        return *std::max_element(history.begin(), history.end());
+    }
+
+private:
+    std::array<std::chrono::nanoseconds, 16> history{};
+    size_t next{0};
+};
+
+/*
+ * The refresh interval of the fastest output showing any of the group's
+ * display buffers, or zero if that's unknown.
+ */
+std::chrono::nanoseconds frame_interval_of(
+    mg::DisplaySyncGroup& group,
+    mg::DisplayConfiguration const& config)
+{
+    double max_refresh_hz{0};
+
+    group.for_each_display_buffer([&](mg::DisplayBuffer& buffer)
+        {
+            config.for_each_output([&](mg::DisplayConfigurationOutput const& output)
+                {
+                    if (output.used && output.connected &&
+                        output.current_mode_index < output.modes.size() &&
+                        output.extents().overlaps(buffer.view_area()))
+                    {
+                        max_refresh_hz = std::max(
+                            max_refresh_hz,
+                            output.modes[output.current_mode_index].vrefresh_hz);
+                    }
+                });
+        });
+
+    if (max_refresh_hz <= 0)
+        return std::chrono::nanoseconds::zero();
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>{1.0 / max_refresh_hz});
+}
+
+/*
+ * The fastest output showing any of the group's display buffers: the one
+ * whose vblank post() waits for.
+ */
+std::experimental::optional<mg::DisplayConfigurationOutputId> sync_output_of(
+    mg::DisplaySyncGroup& group,
+    mg::DisplayConfiguration const& config)
+{
+    std::experimental::optional<mg::DisplayConfigurationOutputId> sync_output;
+    double max_refresh_hz{-1};
+
+    group.for_each_display_buffer([&](mg::DisplayBuffer& buffer)
+        {
+            config.for_each_output([&](mg::DisplayConfigurationOutput const& output)
+                {
+                    if (output.used && output.connected &&
+                        output.current_mode_index < output.modes.size() &&
+                        output.extents().overlaps(buffer.view_area()) &&
+                        output.modes[output.current_mode_index].vrefresh_hz > max_refresh_hz)
+                    {
+                        max_refresh_hz = output.modes[output.current_mode_index].vrefresh_hz;
+                        sync_output = output.id;
+                    }
+                });
+        });
+
+    return sync_output;
+}
+}
+
 namespace mir
 {
 namespace compositor
@@ -53,17 +145,25 @@ class CompositingFunctor
 public:
     CompositingFunctor(
         std::shared_ptr<mc::DisplayBufferCompositorFactory> const& db_compositor_factory,
+        mg::Display const& display,
         mg::DisplaySyncGroup& group,
         std::shared_ptr<mc::Scene> const& scene,
         std::shared_ptr<DisplayListener> const& display_listener,
         std::chrono::milliseconds fixed_composite_delay,
+        std::chrono::nanoseconds frame_interval,
+        std::chrono::nanoseconds refresh_interval,
+        std::experimental::optional<mg::DisplayConfigurationOutputId> sync_output,
         std::shared_ptr<CompositorReport> const& report) :
         compositor_factory{db_compositor_factory},
+        display(display),
         group(group),
         scene(scene),
         running{true},
         frames_scheduled{0},
         force_sleep{fixed_composite_delay},
+        frame_interval{frame_interval},
+        refresh_interval{refresh_interval},
+        sync_output{sync_output},
         display_listener{display_listener},
         report{report},
         started_future{started.get_future()}
@@ -101,7 +201,11 @@ public:
             [this,&compositors]
             {
                 for (auto& compositor : compositors)
-                    scene->register_compositor(std::get<1>(compositor).get());
+                {
+                    auto const id = std::get<1>(compositor).get();
+                    scene->register_compositor(id);
+                    scene->set_view_area(id, std::get<0>(compositor)->view_area());
+                }
             },
             [this,&compositors]{
                 for (auto& compositor : compositors)
@@ -110,6 +214,9 @@ public:
 
         started.set_value();
 
+        // Collects the work buffers defer until the frame they are rendered in is shown
+        FramePresentationScope presentations;
+
         try
         {
             std::unique_lock<std::mutex> lock{run_mutex};
@@ -135,13 +242,27 @@ public:
                     not_posted_yet = false;
                     lock.unlock();
 
+                    auto const frame_start = std::chrono::steady_clock::now();
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
                         compositor->composite(scene->scene_elements_for(compositor.get()));
                     }
+                    render_times.record(std::chrono::steady_clock::now() - frame_start);
+
+                    // Not every platform waits in post() for the frame to be shown, so note the last frame before it
+                    bool const pacing = frame_interval > std::chrono::nanoseconds::zero();
+                    auto const frame_before_post =
+                        presentations.empty() && !pacing ? mg::Frame{} : last_synced_frame();
+
                     group.post();
 
+                    auto const posted = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+                    auto const flip = recent_flip(posted);
+
+                    if (!presentations.empty())
+                        presentations.presented(presentation_of_posted_frame(frame_before_post, flip, posted));
+
                     /*
                      * "Predictive bypass" optimization: If the last frame was
                      * bypassed/overlayed or you simply have a fast GPU, it is
@@ -149,9 +270,26 @@ public:
                      * the latency between snapshotting the scene and post()
                      * completing by almost a whole frame.
                      */
-                    auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
-                                 force_sleep : group.recommended_sleep();
-                    std::this_thread::sleep_for(delay);
+                    if (pacing && flip)
+                    {
+                        /*
+                         * Only some platforms' post() waits for the flip, so
+                         * time the next frame from the last flip. If that
+                         * wasn't ours, ours is shown at the next vblank and the
+                         * next frame can't be shown until the one after. Wake
+                         * up in time to finish it before then, and no earlier.
+                         */
+                        auto const vblanks_ahead = flip.value().msc > frame_before_post.msc ? 1 : 2;
+                        auto const next_vblank = flip.value().ust + vblanks_ahead * frame_interval;
+                        std::this_thread::sleep_for(
+                            next_vblank - posted - render_times.predicted() - render_safety_margin);
+                    }
+                    else
+                    {
+                        auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
+                                     force_sleep : group.recommended_sleep();
+                        std::this_thread::sleep_for(delay);
+                    }
 
                     lock.lock();
 
@@ -231,12 +369,67 @@ public:
     }
 
 private:
+    auto last_synced_frame() const -> mg::Frame
+    {
+        return sync_output ? display.last_frame_on(sync_output.value().as_value()) : mg::Frame{};
+    }
+
+    /*
+     * The last flip on the sync output, if the platform reports one we can use.
+     * Platforms that don't track frames (or haven't flipped yet) report frame zero,
+     * and a flip from longer ago than a couple of refreshes tells us nothing.
+     */
+    auto recent_flip(mir::time::PosixTimestamp const& now) const -> std::experimental::optional<mg::Frame>
+    {
+        auto const frame = last_synced_frame();
+
+        if (frame.msc != 0 &&
+            frame.ust.clock_id == CLOCK_MONOTONIC &&
+            !(frame.ust > now) &&
+            (refresh_interval == std::chrono::nanoseconds::zero() || now - frame.ust < 2 * refresh_interval))
+        {
+            return frame;
+        }
+
+        return std::experimental::nullopt;
+    }
+
+    FramePresentation presentation_of_posted_frame(
+        mg::Frame const& frame_before_post,
+        std::experimental::optional<mg::Frame> const& flip,
+        mir::time::PosixTimestamp const& posted) const
+    {
+        FramePresentation presentation;
+        presentation.refresh_interval = refresh_interval;
+        presentation.output = sync_output;
+
+        // If the frame count hasn't moved on since before post() then post() didn't wait for
+        // the flip (as with several outputs composited together) and it was an earlier frame.
+        if (flip && flip.value().msc > frame_before_post.msc)
+        {
+            presentation.frame = flip.value();
+            presentation.hardware_clock = true;
+            return presentation;
+        }
+
+        // Either post() waited for the frame to be shown, or it will be shown at an upcoming refresh;
+        // the time post() returned is the best estimate that isn't before the frame was submitted
+        presentation.frame.ust = posted;
+        return presentation;
+    }
+
     std::shared_ptr<mc::DisplayBufferCompositorFactory> const compositor_factory;
+    mg::Display const& display;
     mg::DisplaySyncGroup& group;
     std::shared_ptr<mc::Scene> const scene;
     bool running;
     int frames_scheduled;
     std::chrono::milliseconds force_sleep{-1};
+    std::chrono::nanoseconds const frame_interval;
+    std::chrono::nanoseconds const refresh_interval;
+    std::experimental::optional<mg::DisplayConfigurationOutputId> const sync_output;
+    RenderTimePredictor render_times;
+    std::chrono::nanoseconds const render_safety_margin{1ms};
     std::mutex run_mutex;
     std::condition_variable run_cv;
     std::shared_ptr<DisplayListener> const display_listener;
@@ -257,6 +450,27 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
     std::shared_ptr<CompositorReport> const& compositor_report,
     std::chrono::milliseconds fixed_composite_delay,
     bool compose_on_start)
+    : MultiThreadedCompositor(
+          display,
+          scene,
+          db_compositor_factory,
+          display_listener,
+          compositor_report,
+          fixed_composite_delay,
+          compose_on_start,
+          false)
+{
+}
+
+mc::MultiThreadedCompositor::MultiThreadedCompositor(
+    std::shared_ptr<mg::Display> const& display,
+    std::shared_ptr<mc::Scene> const& scene,
+    std::shared_ptr<DisplayBufferCompositorFactory> const& db_compositor_factory,
+    std::shared_ptr<DisplayListener> const& display_listener,
+    std::shared_ptr<CompositorReport> const& compositor_report,
+    std::chrono::milliseconds fixed_composite_delay,
+    bool compose_on_start,
+    bool compose_before_vblank)
     : display{display},
       scene{scene},
       display_buffer_compositor_factory{db_compositor_factory},
@@ -265,6 +479,7 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
       state{CompositorState::stopped},
       fixed_composite_delay{fixed_composite_delay},
       compose_on_start{compose_on_start},
+      compose_before_vblank{compose_before_vblank},
       thread_pool{1}
 {
     observer = std::make_shared<ms::LegacySceneChangeNotification>(
@@ -363,12 +578,22 @@ void mc::MultiThreadedCompositor::stop()
 
 void mc::MultiThreadedCompositor::create_compositing_threads()
 {
+    /*
+     * Query the configuration up front: platforms may hold their
+     * configuration lock while iterating over the sync groups.
+     */
+    std::shared_ptr<mg::DisplayConfiguration> const config{display->configuration()};
+
     /* Start the display buffer compositing threads */
-    display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
+    display->for_each_display_sync_group([this, &config](mg::DisplaySyncGroup& group)
     {
+        auto const refresh_interval = frame_interval_of(group, *config);
+        auto const frame_interval = compose_before_vblank ?
+            refresh_interval : std::chrono::nanoseconds::zero();
+
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
-            display_buffer_compositor_factory, group, scene, display_listener,
-            fixed_composite_delay, report);
+            display_buffer_compositor_factory, *display, group, scene, display_listener,
+            fixed_composite_delay, frame_interval, refresh_interval, sync_output_of(group, *config), report);
 
         futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
         thread_functors.push_back(std::move(thread_functor));
@@ -69,6 +69,25 @@ public:
         std::shared_ptr<CompositorReport> const& compositor_report,
         std::chrono::milliseconds fixed_composite_delay,  // -1 = automatic
         bool compose_on_start);
+    /**
+     * \param [in] compose_before_vblank  Pace each DisplaySyncGroup by its own
+     *                                    refresh rate, waking to composite just
+     *                                    before the next vblank (as predicted from
+     *                                    measured render times and timed from
+     *                                    the last page flip). Overrides
+     *                                    fixed_composite_delay for groups whose
+     *                                    refresh rate is known and whose
+     *                                    platform reports page flips.
+     */
+    MultiThreadedCompositor(
+        std::shared_ptr<graphics::Display> const& display,
+        std::shared_ptr<Scene> const& scene,
+        std::shared_ptr<DisplayBufferCompositorFactory> const& db_compositor_factory,
+        std::shared_ptr<DisplayListener> const& display_listener,
+        std::shared_ptr<CompositorReport> const& compositor_report,
+        std::chrono::milliseconds fixed_composite_delay,  // -1 = automatic
+        bool compose_on_start,
+        bool compose_before_vblank);
     ~MultiThreadedCompositor();
 
     void start();
@@ -90,6 +109,7 @@ private:
     std::atomic<CompositorState> state;
     std::chrono::milliseconds fixed_composite_delay;
     bool compose_on_start;
+    bool const compose_before_vblank;
 
     void schedule_compositing(int number_composites);
     void schedule_compositing(int number_composites, geometry::Rectangle const& damage) const;
@@ -29,6 +29,89 @@ using namespace mir::compositor;
 
 namespace
 {
+// Beyond this we stop splitting and just assume the renderable is visible
+auto const max_visible_fragments = 64u;
+
+/// Add the parts of \a rect not covered by \a hole (at most four rectangles) to \a remainder
+void subtract(Rectangle const& rect, Rectangle const& hole, std::vector<Rectangle>& remainder)
+{
+    auto const overlap = rect.intersection_with(hole);
+
+    if (overlap == Rectangle{})
+    {
+        remainder.push_back(rect);
+        return;
+    }
+
+    if (overlap.top() > rect.top())
+        remainder.push_back({rect.top_left,
+            {rect.size.width.as_int(), (overlap.top() - rect.top()).as_int()}});
+
+    if (overlap.bottom() < rect.bottom())
+        remainder.push_back({{rect.left(), overlap.bottom()},
+            {rect.size.width.as_int(), (rect.bottom() - overlap.bottom()).as_int()}});
+
+    if (overlap.left() > rect.left())
+        remainder.push_back({{rect.left(), overlap.top()},
+            {(overlap.left() - rect.left()).as_int(), overlap.size.height.as_int()}});
+
+    if (overlap.right() < rect.right())
+        remainder.push_back({{overlap.right(), overlap.top()},
+            {(rect.right() - overlap.right()).as_int(), overlap.size.height.as_int()}});
+}
+
+bool is_covered(Rectangle const& area, std::vector<Rectangle> const& coverage)
+{
+    std::vector<Rectangle> visible{area};
+    std::vector<Rectangle> remainder;
+
+    for (auto const& r : coverage)
+    {
+        remainder.clear();
+        for (auto const& v : visible)
+            subtract(v, r, remainder);
+
+        visible.swap(remainder);
+
+        if (visible.empty())
+            return true;
+
+        if (visible.size() > max_visible_fragments)
+            return false;
+    }
+
+    return visible.empty();
+}
+
+void add_opaque_parts(
+    Renderable const& renderable,
+    Rectangle const& clipped_window,
+    std::vector<Rectangle>& coverage)
+{
+    if (renderable.alpha() != 1.0f)
+        return;
+
+    auto drawn = clipped_window;
+    if (auto const clip = renderable.clip_area())
+        drawn = drawn.intersection_with(clip.value());
+
+    if (drawn == Rectangle{})
+        return;
+
+    if (!renderable.shaped())
+    {
+        coverage.push_back(drawn);
+        return;
+    }
+
+    for (auto const& r : renderable.opaque_region())
+    {
+        auto const opaque = r.intersection_with(drawn);
+        if (opaque != Rectangle{})
+            coverage.push_back(opaque);
+    }
+}
+
 bool renderable_is_occluded(
     Renderable const& renderable, 
     Rectangle const& area,
@@ -46,18 +129,10 @@ bool renderable_is_occluded(
     if (clipped_window == empty)
         return true;  // Not in the area; definitely occluded.
 
-    bool occluded = false;
-    for (auto const& r : coverage)
-    {
-        if (r.contains(clipped_window))
-        {
-            occluded = true;
-            break;
-        }
-    }
+    bool const occluded = is_covered(clipped_window, coverage);
 
-    if (!occluded && renderable.alpha() == 1.0f && !renderable.shaped())
-        coverage.push_back(clipped_window);
+    if (!occluded)
+        add_opaque_parts(renderable, clipped_window, coverage);
 
     return occluded;
 }
@@ -22,6 +22,7 @@
 #include "dropping_schedule.h"
 #include "mir/graphics/buffer.h"
 #include <boost/throw_exception.hpp>
+#include <algorithm>
 
 namespace mc = mir::compositor;
 namespace geom = mir::geometry;
@@ -29,6 +30,13 @@ namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
+namespace
+{
+// Enough history for a compositor that has missed a few frames
+// (e.g. while its output was blanked) to still get precise damage.
+std::size_t const max_damage_history{8};
+}
+
 enum class mc::Stream::ScheduleMode {
     Queueing,
     Dropping
@@ -49,12 +57,29 @@ mc::Stream::Stream(
 mc::Stream::~Stream() = default;
 
 void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
+{
+    submit(buffer, std::experimental::nullopt);
+}
+
+void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer, geom::Rectangles const& damage)
+{
+    submit(buffer, damage);
+}
+
+void mc::Stream::submit(
+    std::shared_ptr<mg::Buffer> const& buffer,
+    std::experimental::optional<geom::Rectangles> const& damage)
 {
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
     {
         std::lock_guard<decltype(mutex)> lk(mutex); 
+        if (size != buffer->size())
+            damage_history.clear(); // Old damage is meaningless after a resize
+        damage_history.push_back({buffer->id(), damage});
+        if (damage_history.size() > max_damage_history)
+            damage_history.pop_front();
         first_frame_posted = true;
         pf = buffer->pixel_format();
         size = buffer->size();
@@ -66,6 +91,34 @@ void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
     }
 }
 
+auto mc::Stream::damage_between(mg::BufferID since, mg::BufferID until) const
+    -> std::experimental::optional<geom::Rectangles>
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+
+    auto const since_entry = std::find_if(begin(damage_history), end(damage_history),
+        [since](SubmissionDamage const& entry) { return entry.id == since; });
+    if (since_entry == end(damage_history))
+        return std::experimental::nullopt;
+
+    auto const until_entry = std::find_if(since_entry, end(damage_history),
+        [until](SubmissionDamage const& entry) { return entry.id == until; });
+    if (until_entry == end(damage_history))
+        return std::experimental::nullopt;
+
+    geom::Rectangles damage;
+    for (auto entry = std::next(since_entry); entry != std::next(until_entry); ++entry)
+    {
+        if (!entry->damage)
+            return std::experimental::nullopt;
+
+        for (auto const& rect : *entry->damage)
+            damage.add(rect);
+    }
+
+    return damage;
+}
+
 void mc::Stream::with_most_recent_buffer_do(std::function<void(mg::Buffer&)> const& fn)
 {
     std::lock_guard<decltype(mutex)> lk(mutex); 
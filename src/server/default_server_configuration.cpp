@@ -45,6 +45,7 @@
 #include "mir/graphics/platform.h"
 #include "mir/scene/coordinate_translator.h"
 #include "mir/console_services.h"
+#include "mir/platform_probe_cache.h"
 
 #include <type_traits>
 
@@ -196,6 +197,20 @@ std::shared_ptr<mir::EmergencyCleanup> mir::DefaultServerConfiguration::the_emer
         });
 }
 
+auto mir::DefaultServerConfiguration::the_platform_probe_cache() -> std::shared_ptr<PlatformProbeCache>
+{
+    return platform_probe_cache(
+        [this]()
+        {
+            auto const options = the_options();
+
+            return std::make_shared<PlatformProbeCache>(
+                options->is_set(options::platform_probe_cache) ?
+                    options->get<std::string>(options::platform_probe_cache) : std::string{},
+                options->get<std::string>(options::platform_path));
+        });
+}
+
 std::shared_ptr<mir::cookie::Authority> mir::DefaultServerConfiguration::the_cookie_authority()
 {
     return cookie_authority(
@@ -31,6 +31,7 @@
 #include "mir/input/input_manager.h"
 #include "mir/input/input_dispatcher.h"
 #include "mir/log.h"
+#include "mir/startup_trace.h"
 #include "mir/unwind_helpers.h"
 
 #include <boost/exception/diagnostic_information.hpp>
@@ -224,16 +225,25 @@ void mir::DisplayServer::run()
 
     auto const& server = *p.load();
 
-    server.compositor->start();
-    server.input_manager->start();
-    server.input_dispatcher->start();
-    server.prompt_connector->start();
-    server.connector->start();
-    server.wayland_connector->start();
-    server.xwayland_connector->start();
+    auto const start = [](char const* name, auto const& subsystem)
+        {
+            startup_trace::Span const span{name, "start"};
+            subsystem->start();
+        };
+
+    start("compositor", server.compositor);
+    start("input manager", server.input_manager);
+    start("input dispatcher", server.input_dispatcher);
+    start("prompt connector", server.prompt_connector);
+    start("connector", server.connector);
+    start("wayland connector", server.wayland_connector);
+    start("xwayland connector", server.xwayland_connector);
 
     server.server_status_listener->started();
 
+    // Anything deferred until after startup happens once the main loop runs, so isn't part of the trace
+    startup_trace::finish();
+
     server.main_loop->run();
 
     server.xwayland_connector->stop();
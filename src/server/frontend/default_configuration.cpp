@@ -20,6 +20,7 @@
 #include "mir/emergency_cleanup.h"
 
 #include "default_ipc_factory.h"
+#include "deferred_ipc_factory.h"
 #include "published_socket_connector.h"
 #include "session_mediator_observer_multiplexer.h"
 
@@ -30,6 +31,7 @@
 #include "mir/frontend/session_authorizer.h"
 #include "mir/options/configuration.h"
 #include "mir/options/option.h"
+#include "mir/server_action_queue.h"
 
 namespace mf = mir::frontend;
 namespace mg = mir::graphics;
@@ -60,6 +62,25 @@ public:
         return mir::optional_value<std::string>{};
     }
 };
+
+// Nothing the mirclient frontend needs (screencast, input configuration, ...) is needed for the first frame, so it
+// is made on the main loop once that runs (or, if sooner, when the first client connects) instead of during startup
+auto deferred(
+    std::function<std::shared_ptr<mf::ProtobufIpcFactory>()> const& make,
+    std::shared_ptr<mir::ServerActionQueue> const& action_queue) -> std::shared_ptr<mf::ProtobufIpcFactory>
+{
+    auto const result = std::make_shared<mf::DeferredIpcFactory>(make, action_queue);
+
+    action_queue->enqueue(
+        result.get(),
+        [weak_result = std::weak_ptr<mf::DeferredIpcFactory>{result}]
+        {
+            if (auto const result = weak_result.lock())
+                result->create();
+        });
+
+    return result;
+}
 }
 
 std::shared_ptr<mf::ConnectionCreator>
@@ -69,7 +90,8 @@ mir::DefaultServerConfiguration::the_connection_creator()
         {
             auto const session_authorizer = the_session_authorizer();
             return std::make_shared<mf::ProtobufConnectionCreator>(
-                new_ipc_factory(session_authorizer),
+                deferred([this, session_authorizer] { return new_ipc_factory(session_authorizer); },
+                    the_server_action_queue()),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
                 the_message_processor_report());
@@ -153,7 +175,8 @@ mir::DefaultServerConfiguration::the_prompt_connection_creator()
         {
             auto const session_authorizer = std::make_shared<PromptSessionAuthorizer>();
             return std::make_shared<mf::ProtobufConnectionCreator>(
-                new_ipc_factory(session_authorizer),
+                deferred([this, session_authorizer] { return new_ipc_factory(session_authorizer); },
+                    the_server_action_queue()),
                 session_authorizer,
                 the_graphics_platform()->make_ipc_operations(),
                 the_message_processor_report());
@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "deferred_ipc_factory.h"
+
+#include "mir/server_action_queue.h"
+
+namespace mf = mir::frontend;
+
+std::mutex mf::DeferredIpcFactory::making;
+
+mf::DeferredIpcFactory::DeferredIpcFactory(
+    std::function<std::shared_ptr<ProtobufIpcFactory>()> const& make,
+    std::shared_ptr<ServerActionQueue> const& action_queue) :
+    action_queue{action_queue},
+    make{make}
+{
+}
+
+void mf::DeferredIpcFactory::create()
+{
+    std::lock_guard<std::mutex> making_lock{making};
+
+    std::unique_lock<std::mutex> lock{mutex};
+    if (made || failure)
+        return;
+
+    // Only this function uses make, and it holds making
+    lock.unlock();
+
+    std::shared_ptr<ProtobufIpcFactory> result;
+    try
+    {
+        result = make();
+    }
+    catch (...)
+    {
+        lock.lock();
+        failure = std::current_exception();
+        made_or_failed.notify_all();
+        throw;
+    }
+
+    lock.lock();
+    made = result;
+    make = nullptr;
+    made_or_failed.notify_all();
+}
+
+std::shared_ptr<mf::detail::DisplayServer> mf::DeferredIpcFactory::make_ipc_server(
+    SessionCredentials const &creds,
+    std::shared_ptr<EventSinkFactory> const& sink_factory,
+    std::shared_ptr<MessageSender> const& message_sender,
+    ConnectionContext const &connection_context)
+{
+    return factory()->make_ipc_server(creds, sink_factory, message_sender, connection_context);
+}
+
+std::shared_ptr<mf::ResourceCache> mf::DeferredIpcFactory::resource_cache()
+{
+    return factory()->resource_cache();
+}
+
+auto mf::DeferredIpcFactory::factory() -> std::shared_ptr<ProtobufIpcFactory>
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        if (made)
+            return made;
+    }
+
+    // Ask the main loop to make it now, in case it hasn't got to the create() queued at startup
+    action_queue->enqueue_with_guaranteed_execution(
+        [weak_this = std::weak_ptr<DeferredIpcFactory>{shared_from_this()}]
+        {
+            if (auto const self = weak_this.lock())
+                self->create();
+        });
+
+    std::unique_lock<std::mutex> lock{mutex};
+    made_or_failed.wait(lock, [this] { return made || failure; });
+
+    if (failure)
+        std::rethrow_exception(failure);
+
+    return made;
+}
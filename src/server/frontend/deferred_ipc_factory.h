@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_DEFERRED_IPC_FACTORY_H_
+#define MIR_FRONTEND_DEFERRED_IPC_FACTORY_H_
+
+#include "protobuf_ipc_factory.h"
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace mir
+{
+class ServerActionQueue;
+
+namespace frontend
+{
+/**
+ * Makes the ProtobufIpcFactory it forwards to when create() is called or it is first used,
+ * so that what that factory depends on needn't be constructed until then.
+ *
+ * The server configuration's accessors aren't threadsafe, so the factory is only made on
+ * the main loop (or, while the main loop isn't running, on the thread using it), and only
+ * one DeferredIpcFactory makes its factory at a time. A connection that arrives first waits
+ * for the main loop to make it.
+ */
+class DeferredIpcFactory : public ProtobufIpcFactory, public std::enable_shared_from_this<DeferredIpcFactory>
+{
+public:
+    DeferredIpcFactory(
+        std::function<std::shared_ptr<ProtobufIpcFactory>()> const& make,
+        std::shared_ptr<ServerActionQueue> const& action_queue);
+
+    /// Makes the factory, unless that has been done already. Called on the main loop.
+    void create();
+
+    std::shared_ptr<detail::DisplayServer> make_ipc_server(
+        SessionCredentials const &creds,
+        std::shared_ptr<EventSinkFactory> const& sink_factory,
+        std::shared_ptr<MessageSender> const& message_sender,
+        ConnectionContext const &connection_context) override;
+
+    std::shared_ptr<ResourceCache> resource_cache() override;
+
+private:
+    auto factory() -> std::shared_ptr<ProtobufIpcFactory>;
+
+    std::shared_ptr<ServerActionQueue> const action_queue;
+
+    std::mutex mutex;
+    std::condition_variable made_or_failed;
+    std::function<std::shared_ptr<ProtobufIpcFactory>()> make;
+    std::shared_ptr<ProtobufIpcFactory> made;
+    std::exception_ptr failure;
+
+    /// Held while making any factory, so no two are made at once
+    static std::mutex making;
+};
+}
+}
+
+#endif // MIR_FRONTEND_DEFERRED_IPC_FACTORY_H_
@@ -974,7 +974,8 @@ void mf::SessionMediator::screencast_buffer(
     ScreencastSessionId const screencast_session_id{
         protobuf_screencast_id->value()};
 
-    auto buffer = screencast->capture(screencast_session_id);
+    // The client gets the previous buffer back if nothing has changed since it was captured
+    auto buffer = screencast->capture_if_damaged(screencast_session_id).buffer;
     bool const already_tracked = screencast_buffer_tracker.track_buffer(screencast_session_id, buffer.get());
     auto const msg_type = already_tracked ?
         mg::BufferIpcMsgType::update_msg : mg::BufferIpcMsgType::full_msg;
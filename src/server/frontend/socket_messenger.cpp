@@ -17,7 +17,6 @@
  */
 
 #include "socket_messenger.h"
-#include "mir/frontend/client_constants.h"
 #include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
 #include "mir/raii.h"
@@ -26,23 +25,203 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
+#include <deque>
 #include <stdexcept>
+#include <system_error>
 
 namespace mf = mir::frontend;
 namespace mfd = mf::detail;
 namespace bs = boost::system;
 namespace ba = boost::asio;
 
+namespace
+{
+size_t const header_size{2};
+
+/// How far (beyond the socket's send buffer) a client may fall behind before it is disconnected
+size_t const max_pending_bytes{1024 * 1024};
+
+/// Enough to batch a good number of queued messages into one syscall
+size_t const max_batched_chunks{64};
+
+// Sends without blocking; returns the number of bytes sent, which is 0 if the client isn't ready
+auto send_without_blocking(int socket, msghdr const& message) -> size_t
+{
+    for (;;)
+    {
+        auto const sent = sendmsg(socket, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (sent >= 0)
+            return sent;
+
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+
+        if (!mir::socket_error_is_transient(errno))
+            BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to send message"));
+    }
+}
+
+auto send_data(int socket, iovec* iov, size_t iov_count) -> size_t
+{
+    msghdr message{};
+    message.msg_iov = iov;
+    message.msg_iovlen = iov_count;
+
+    return send_without_blocking(socket, message);
+}
+
+// Clients receive each set of fds along with a byte of dummy data, as sent by mir::send_fds()
+bool send_fds_without_blocking(int socket, std::vector<mir::Fd> const& fds)
+{
+    char dummy_data = 'M';
+    iovec iov{&dummy_data, 1};
+
+    static auto const builtin_n_fds = 5;
+    static auto const builtin_cmsg_space = CMSG_SPACE(builtin_n_fds * sizeof(int));
+    auto const fds_bytes = fds.size() * sizeof(int);
+    mir::VariableLengthArray<builtin_cmsg_space> control{CMSG_SPACE(fds_bytes)};
+    memset(control.data(), 0, control.size());
+
+    msghdr message{};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto const cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_len = CMSG_LEN(fds_bytes);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+
+    int* data = reinterpret_cast<int*>(CMSG_DATA(cmsg));
+    for (auto const& fd : fds)
+        *data++ = fd;
+
+    return send_without_blocking(socket, message) == 1;
+}
+}
+
+/// Output the client wasn't ready for, written in order as the socket becomes writable
+struct mfd::SocketMessenger::PendingOutput : std::enable_shared_from_this<PendingOutput>
+{
+    /// Either message data or a set of fds
+    struct Chunk
+    {
+        std::vector<char> data;
+        std::vector<Fd> fds;
+    };
+
+    std::mutex mutex;
+    std::deque<Chunk> chunks;
+    size_t front_sent{0};   ///< Bytes of the first chunk's data already sent
+    size_t bytes{0};        ///< Data queued in total
+    bool waiting{false};
+    bool disconnected{false};
+
+    // Returns true if everything has been sent
+    bool flush(int socket)
+    {
+        while (!chunks.empty())
+        {
+            if (chunks.front().data.empty())
+            {
+                if (!send_fds_without_blocking(socket, chunks.front().fds))
+                    return false;
+
+                chunks.pop_front();
+                continue;
+            }
+
+            // Batch the data of consecutive messages up to the next set of fds
+            iovec iov[max_batched_chunks];
+            size_t iov_count{0};
+            for (auto chunk = chunks.begin();
+                 chunk != chunks.end() && !chunk->data.empty() && iov_count != max_batched_chunks;
+                 ++chunk)
+            {
+                auto const offset = iov_count ? 0 : front_sent;
+                iov[iov_count++] = {chunk->data.data() + offset, chunk->data.size() - offset};
+            }
+
+            auto sent = send_data(socket, iov, iov_count);
+            if (!sent)
+                return false;
+
+            bytes -= sent;
+            while (sent)
+            {
+                auto const remaining = chunks.front().data.size() - front_sent;
+                if (sent < remaining)
+                {
+                    front_sent += sent;
+                    break;
+                }
+
+                sent -= remaining;
+                front_sent = 0;
+                chunks.pop_front();
+            }
+        }
+
+        return true;
+    }
+
+    // Requires mutex to be held
+    void flush_when_writable(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
+    {
+        waiting = true;
+
+        // Don't keep the socket alive just to wait on it
+        std::weak_ptr<ba::local::stream_protocol::socket> const weak_socket{socket};
+        socket->async_write_some(
+            ba::null_buffers(),
+            [self = shared_from_this(), weak_socket](bs::error_code const& error, size_t)
+            {
+                std::lock_guard<std::mutex> lock{self->mutex};
+                self->waiting = false;
+
+                auto const socket = weak_socket.lock();
+                if (!socket || self->disconnected)
+                    return;
+
+                try
+                {
+                    if (error)
+                        BOOST_THROW_EXCEPTION(bs::system_error(error));
+
+                    if (!self->flush(socket->native_handle()))
+                        self->flush_when_writable(socket);
+                }
+                catch (std::exception const&)
+                {
+                    self->disconnect(socket->native_handle());
+                }
+            });
+    }
+
+    void disconnect(int socket)
+    {
+        // The connection notices the client hanging up and cleans up after it
+        disconnected = true;
+        chunks.clear();
+        bytes = 0;
+        shutdown(socket, SHUT_RDWR);
+    }
+};
+
 mfd::SocketMessenger::SocketMessenger(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
     : socket(socket),
-      socket_fd{IntOwnedFd{socket->native_handle()}}
+      socket_fd{IntOwnedFd{socket->native_handle()}},
+      pending_output{std::make_shared<PendingOutput>()}
 {
     // Make the socket non-blocking to avoid hanging the server when a client
     // is unresponsive. Also increase the send buffer size to 64KiB to allow
-    // more leeway for transient client freezes.
+    // more leeway for transient client freezes; beyond that messages wait
+    // in pending_output until the client catches up.
     // See https://bugs.launchpad.net/mir/+bug/1350207
-    // TODO: Rework the messenger to support asynchronous sends
     socket->non_blocking(true);
     boost::asio::socket_base::send_buffer_size option(64*1024);
     socket->set_option(option);
@@ -73,24 +252,60 @@ mf::SessionCredentials mfd::SocketMessenger::client_creds()
 
 void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& fd_set)
 {
-    static size_t const header_size{2};
-    mir::VariableLengthArray<mf::serialization_buffer_size> whole_message{header_size + length};
+    char header[header_size]{
+        static_cast<char>((length >> 8) & 0xff),
+        static_cast<char>((length >> 0) & 0xff)};
+
+    std::lock_guard<std::mutex> lock{pending_output->mutex};
+    auto& output = *pending_output;
+
+    if (output.disconnected)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to send message: client was disconnected"));
+
+    // NOTE: messages (and their fds) reach the client in the order they are sent,
+    // which mf::SessionMediator relies on
+    size_t sent{0};
+    auto fds = fd_set.begin();
 
-    whole_message.data()[0] = static_cast<unsigned char>((length >> 8) & 0xff);
-    whole_message.data()[1] = static_cast<unsigned char>((length >> 0) & 0xff);
-    std::copy(data, data + length, whole_message.data() + header_size);
+    if (output.chunks.empty())
+    {
+        iovec iov[]{{header, header_size}, {const_cast<char*>(data), length}};
+        sent = send_data(socket_fd, iov, length ? 2 : 1);
+
+        if (sent == header_size + length)
+        {
+            while (fds != fd_set.end() && (fds->empty() || send_fds_without_blocking(socket_fd, *fds)))
+                ++fds;
+        }
+    }
 
-    std::unique_lock<std::mutex> lg(message_lock);
+    if (sent < header_size + length)
+    {
+        PendingOutput::Chunk chunk;
+        chunk.data.reserve(header_size + length - sent);
+        if (sent < header_size)
+            chunk.data.insert(chunk.data.end(), header + sent, header + header_size);
+        auto const data_sent = sent > header_size ? sent - header_size : 0;
+        chunk.data.insert(chunk.data.end(), data + data_sent, data + length);
 
-    // TODO: This should be asynchronous, but we are not making sure
-    // that a potential call to send_fds is executed _after_ this
-    // function has completed (if it would be executed asynchronously.
-    // NOTE: we rely on this synchronous behavior as per the comment in
-    // mf::SessionMediator::create_surface
-    ba::write(*socket, ba::buffer(whole_message.data(), whole_message.size()));
+        output.bytes += chunk.data.size();
+        output.chunks.push_back(std::move(chunk));
+    }
+
+    for (; fds != fd_set.end(); ++fds)
+    {
+        if (!fds->empty())
+            output.chunks.push_back(PendingOutput::Chunk{{}, *fds});
+    }
+
+    if (output.bytes > max_pending_bytes)
+    {
+        output.disconnect(socket_fd);
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to send message: client is not reading its messages"));
+    }
 
-    for (auto const& fds : fd_set)
-        mir::send_fds(socket_fd, fds);
+    if (!output.chunks.empty() && !output.waiting)
+        output.flush_when_writable(socket);
 }
 
 void mfd::SocketMessenger::async_receive_msg(
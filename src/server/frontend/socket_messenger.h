@@ -44,6 +44,8 @@ public:
     void receive_fds(std::vector<Fd>& fds) override;
 
 private:
+    struct PendingOutput;
+
     void set_passcred(int opt);
     void update_session_creds();
     SessionCredentials creator_creds() const;
@@ -51,7 +53,7 @@ private:
     std::shared_ptr<boost::asio::local::stream_protocol::socket> socket;
     mir::Fd socket_fd;
 
-    std::mutex message_lock;
+    std::shared_ptr<PendingOutput> const pending_output;
     SessionCredentials session_creds{0, 0, 0};
 };
 }
@@ -45,6 +45,12 @@ std::shared_ptr<mir::graphics::Buffer> mf::UnauthorizedScreencast::capture(
         std::runtime_error("Process is not authorized to capture screencasts"));
 }
 
+mf::ScreencastFrame mf::UnauthorizedScreencast::capture_if_damaged(mf::ScreencastSessionId)
+{
+    BOOST_THROW_EXCEPTION(
+        std::runtime_error("Process is not authorized to capture screencasts"));
+}
+
 void mf::UnauthorizedScreencast::capture(mf::ScreencastSessionId, std::shared_ptr<mir::graphics::Buffer> const&)
 {
     BOOST_THROW_EXCEPTION(
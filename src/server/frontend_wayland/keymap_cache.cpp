@@ -0,0 +1,185 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keymap_cache.h"
+
+#include "mir/anonymous_shm_file.h"
+#include "mir/input/keymap.h"
+#include "mir/log.h"
+
+#include <xkbcommon/xkbcommon.h>
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mf = mir::frontend;
+namespace mi = mir::input;
+
+namespace
+{
+/// Compiled keymaps no keyboard is using are dropped once there are more than this
+size_t const max_idle_keymaps = 8;
+
+int memfd_create(char const* name, unsigned int flags)
+{
+    return static_cast<int>(syscall(SYS_memfd_create, name, flags));
+}
+
+/// Returns an invalid Fd if the kernel doesn't support sealed memfds
+auto create_sealed_file(std::string const& text) -> mir::Fd
+{
+    mir::Fd fd{memfd_create("mir-keymap", MFD_CLOEXEC | MFD_ALLOW_SEALING)};
+    if (fd == mir::Fd::invalid)
+        return {};
+
+    // Include the terminating NUL, so that clients can use the mapping as a string
+    auto const size = text.size() + 1;
+    auto remaining = size;
+    auto data = text.c_str();
+    while (remaining > 0)
+    {
+        auto const written = write(fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return {};
+        }
+        data += written;
+        remaining -= written;
+    }
+
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+        return {};
+
+    return fd;
+}
+
+std::weak_ptr<mf::KeymapCache> singleton;
+std::mutex static_mutex;
+}
+
+mf::KeymapCache::CompiledKeymap::CompiledKeymap(xkb_keymap* keymap, std::string&& text)
+    : keymap_{keymap, &xkb_keymap_unref},
+      text{std::move(text)},
+      sealed_fd{create_sealed_file(this->text)}
+{
+    if (sealed_fd == Fd::invalid)
+        log_info("Sealed files are not supported: sending each client a copy of the keymap");
+}
+
+auto mf::KeymapCache::CompiledKeymap::fd_for_client() const -> Fd
+{
+    if (sealed_fd != Fd::invalid)
+        return sealed_fd;
+
+    AnonymousShmFile shm_buffer{size()};
+    memcpy(shm_buffer.base_ptr(), text.c_str(), size());
+
+    auto const fd = dup(shm_buffer.fd());
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to dup keymap file"}));
+    }
+    return Fd{fd};
+}
+
+auto mf::KeymapCache::instance() -> std::shared_ptr<KeymapCache>
+{
+    std::lock_guard<std::mutex> lock{static_mutex};
+    auto shared = singleton.lock();
+    if (!shared)
+    {
+        shared = std::make_shared<KeymapCache>();
+        singleton = shared;
+    }
+    return shared;
+}
+
+mf::KeymapCache::KeymapCache()
+    : context{xkb_context_new(XKB_CONTEXT_NO_FLAGS), &xkb_context_unref}
+{
+    if (!context)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to create XKB context"});
+}
+
+mf::KeymapCache::~KeymapCache() = default;
+
+auto mf::KeymapCache::keymap_for(mi::Keymap const& names) -> std::shared_ptr<CompiledKeymap const>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    Names const key{names.model, names.layout, names.variant, names.options};
+    auto const cached = keymaps.find(key);
+    if (cached != keymaps.end())
+        return cached->second;
+
+    xkb_rule_names const rule_names = {
+        "evdev",
+        names.model.c_str(),
+        names.layout.c_str(),
+        names.variant.c_str(),
+        names.options.c_str()
+    };
+
+    auto const keymap = xkb_keymap_new_from_names(context.get(), &rule_names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (!keymap)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to compile keymap"});
+
+    std::unique_ptr<char, void(*)(void*)> const text{
+        xkb_keymap_get_as_string(keymap, XKB_KEYMAP_FORMAT_TEXT_V1),
+        free};
+
+    auto const compiled = std::make_shared<CompiledKeymap const>(keymap, std::string{text.get()});
+
+    if (keymaps.size() >= max_idle_keymaps)
+    {
+        for (auto i = keymaps.begin(); i != keymaps.end();)
+        {
+            if (i->second.use_count() == 1)
+                i = keymaps.erase(i);
+            else
+                ++i;
+        }
+    }
+
+    keymaps.emplace(key, compiled);
+    return compiled;
+}
+
+auto mf::KeymapCache::keymap_from(char const* buffer, size_t length) -> std::shared_ptr<CompiledKeymap const>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const keymap = xkb_keymap_new_from_buffer(
+        context.get(),
+        buffer,
+        length,
+        XKB_KEYMAP_FORMAT_TEXT_V1,
+        XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (!keymap)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to compile keymap"});
+
+    // The buffer may or may not include a terminating NUL
+    return std::make_shared<CompiledKeymap const>(keymap, std::string{buffer, strnlen(buffer, length)});
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_KEYMAP_CACHE_H_
+#define MIR_FRONTEND_KEYMAP_CACHE_H_
+
+#include "mir/fd.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+// from <xkbcommon/xkbcommon.h>
+struct xkb_keymap;
+struct xkb_context;
+
+namespace mir
+{
+namespace input
+{
+class Keymap;
+}
+
+namespace frontend
+{
+/**
+ * Compiles each keymap once for all the wl_keyboards in the process.
+ *
+ * Alongside the compiled keymap, the cache keeps its text in a sealed memfd
+ * that every client is sent (the seals stop any of them modifying it). Where
+ * the kernel can't seal files, each client gets its own copy instead.
+ *
+ * The xkb_keymap reference count is not thread safe, so compiled keymaps
+ * should only be used on the Wayland thread.
+ */
+class KeymapCache
+{
+public:
+    class CompiledKeymap
+    {
+    public:
+        CompiledKeymap(xkb_keymap* keymap, std::string&& text);
+
+        auto keymap() const -> xkb_keymap* { return keymap_.get(); }
+
+        /// A file holding the keymap text (including the terminating NUL) to send to a client
+        auto fd_for_client() const -> Fd;
+        auto size() const -> size_t { return text.size() + 1; }
+
+    private:
+        std::unique_ptr<xkb_keymap, void(*)(xkb_keymap*)> const keymap_;
+        std::string const text;
+        /// Shared by all clients, if sealing is supported
+        Fd const sealed_fd;
+    };
+
+    static auto instance() -> std::shared_ptr<KeymapCache>;
+
+    KeymapCache();
+    ~KeymapCache();
+
+    /// Compiles the keymap for \a names the first time it is asked for
+    auto keymap_for(input::Keymap const& names) -> std::shared_ptr<CompiledKeymap const>;
+
+    /// Compiles a keymap from its text (these are not cached)
+    auto keymap_from(char const* buffer, size_t length) -> std::shared_ptr<CompiledKeymap const>;
+
+private:
+    using Names = std::tuple<std::string, std::string, std::string, std::string>;
+
+    std::mutex mutex;
+    std::unique_ptr<xkb_context, void(*)(xkb_context*)> const context;
+    std::map<Names, std::shared_ptr<CompiledKeymap const>> keymaps;
+};
+}
+}
+
+#endif /* MIR_FRONTEND_KEYMAP_CACHE_H_ */
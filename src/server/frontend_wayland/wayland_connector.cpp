@@ -644,6 +644,7 @@ mf::WaylandConnector::WaylandConnector(
     std::shared_ptr<MirDisplay> const& display_config,
     std::shared_ptr<mi::InputDeviceHub> const& input_hub,
     std::shared_ptr<mi::Seat> const& seat,
+    std::shared_ptr<mi::InputReport> const& input_report,
     std::shared_ptr<mg::GraphicBufferAllocator> const& allocator,
     std::shared_ptr<mf::SessionAuthorizer> const& session_authorizer,
     bool arw_socket,
@@ -697,7 +698,7 @@ mf::WaylandConnector::WaylandConnector(
         executor,
         this->allocator);
     subcompositor_global = std::make_unique<mf::WlSubcompositor>(display.get());
-    seat_global = std::make_unique<mf::WlSeat>(display.get(), input_hub, seat, executor);
+    seat_global = std::make_unique<mf::WlSeat>(display.get(), input_hub, seat, input_report, executor);
     output_manager = std::make_unique<mf::OutputManager>(
         display.get(),
         display_config,
@@ -36,6 +36,7 @@ class Executor;
 namespace input
 {
 class InputDeviceHub;
+class InputReport;
 class Seat;
 }
 namespace graphics
@@ -100,6 +101,7 @@ public:
         std::shared_ptr<MirDisplay> const& display_config,
         std::shared_ptr<input::InputDeviceHub> const& input_hub,
         std::shared_ptr<input::Seat> const& seat,
+        std::shared_ptr<input::InputReport> const& input_report,
         std::shared_ptr<graphics::GraphicBufferAllocator> const& allocator,
         std::shared_ptr<SessionAuthorizer> const& session_authorizer,
         bool arw_socket,
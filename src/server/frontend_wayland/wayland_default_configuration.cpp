@@ -23,11 +23,13 @@
 #include "xdg_shell_v6.h"
 #include "xdg_shell_stable.h"
 #include "xdg_output_v1.h"
+#include "wp_presentation.h"
 #include "layer_shell_v1.h"
 #include "xwayland_wm_shell.h"
 #include "mir_display.h"
 #include "wl_seat.h"
 #include "xdg-output-unstable-v1_wrapper.h"
+#include "presentation-time_wrapper.h"
 
 #include "mir/graphics/platform.h"
 #include "mir/options/default_configuration.h"
@@ -44,7 +46,8 @@ auto mf::get_standard_extensions() -> std::vector<std::string>
     return std::vector<std::string>{
         mw::Shell::interface_name,
         mw::XdgWmBase::interface_name,
-        mw::XdgShellV6::interface_name};
+        mw::XdgShellV6::interface_name,
+        mw::Presentation::interface_name};
 }
 
 auto mf::get_supported_extensions() -> std::vector<std::string>
@@ -58,7 +61,8 @@ auto mf::get_supported_extensions() -> std::vector<std::string>
         mw::XdgWmBase::interface_name,
         mw::XdgShellV6::interface_name,
         mw::LayerShellV1::interface_name,
-        mw::XdgOutputManagerV1::interface_name};
+        mw::XdgOutputManagerV1::interface_name,
+        mw::Presentation::interface_name};
 }
 
 namespace
@@ -110,6 +114,11 @@ auto configure_wayland_extensions(
                     mw::XdgOutputManagerV1::interface_name,
                     create_xdg_output_manager_v1(display, output_manager));
 
+            if (extension.find(mw::Presentation::interface_name) != extension.end())
+                add_extension(
+                    mw::Presentation::interface_name,
+                    mf::create_wp_presentation(display, output_manager));
+
             if (x11_enabled)
                 add_extension("x11-support", std::make_shared<mf::XWaylandWMShell>(shell, *seat, output_manager));
         }
@@ -156,6 +165,7 @@ std::shared_ptr<mf::Connector>
                 display_config,
                 the_input_device_hub(),
                 the_seat(),
+                the_input_report(),
                 the_buffer_allocator(),
                 the_session_authorizer(),
                 arw_socket,
@@ -25,11 +25,12 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <mutex>
 #include <system_error>
+#include <thread>
 
 namespace mf = mir::frontend;
 
@@ -55,32 +56,64 @@ private:
         TerminationRequested,
         Stopped
     };
+
+    struct Task
+    {
+        Task() = default;
+        explicit Task(std::function<void()>&& work)
+            : work{std::move(work)}
+        {
+        }
+
+        std::atomic<Task*> next{nullptr};
+        std::function<void()> work;
+    };
+
 public:
     explicit State(wl_event_loop* loop)
-        : loop{loop}
+        : loop{loop},
+          head{&stub},
+          tail{&stub}
     {
-        enqueue(
+        push(new Task{
             []()
             {
                 on_wayland_thread = true;
-            });
+            }});
+    }
+
+    ~State()
+    {
+        // Work that arrived after we stopped is dropped, letting the
+        // std::function destructor clean up any necessary state.
+        while (auto const task = pop())
+            delete task;
     }
 
-    void enqueue(std::function<void()>&& work)
+    /**
+     * Queue work for the Wayland thread (or run it, if called from there)
+     *
+     * \return whether the event loop needs waking to process it
+     */
+    bool enqueue(std::function<void()>&& work)
     {
         if (on_wayland_thread)
         {
             work();
-            return;
+            return false;
         }
 
-        std::lock_guard<std::mutex> lock{mutex};
-        if (state == ExecutionState::Running)
+        if (state != ExecutionState::Running)
         {
-            workqueue.emplace_back(std::move(work));
+            // If we've been terminated then drop the work on the floor
+            return false;
         }
-        // If we've been terminated then drop the work on the floor, letting the
-        // std::function destructor clean up any necessary state.
+
+        push(new Task{std::move(work)});
+
+        // Only the first task since the Wayland thread last started processing
+        // needs to wake it; it will drain everything queued by then.
+        return !wakeup_pending.exchange(true);
     }
 
     void enqueue_termination(std::function<void()>&& terminator)
@@ -88,7 +121,7 @@ public:
         std::lock_guard<std::mutex> lock{mutex};
         if (state == ExecutionState::Running)
         {
-            workqueue.emplace_front(std::move(terminator));
+            termination_work = std::move(terminator);
             on_wayland_thread = false;
             state = ExecutionState::TerminationRequested;
         }
@@ -96,11 +129,22 @@ public:
 
     std::function<void()> get_work()
     {
-        std::lock_guard<std::mutex> lock{mutex};
-        if (!workqueue.empty())
+        if (state != ExecutionState::Running)
+        {
+            // The termination request is processed ahead of any other work
+            std::lock_guard<std::mutex> lock{mutex};
+            if (termination_work)
+            {
+                auto work = std::move(termination_work);
+                termination_work = nullptr;
+                return work;
+            }
+        }
+
+        if (auto const task = pop())
         {
-            auto const work = std::move(workqueue.front());
-            workqueue.pop_front();
+            auto work = std::move(task->work);
+            delete task;
             return work;
         }
         return {};
@@ -112,31 +156,95 @@ public:
 
         if (state == ExecutionState::TerminationRequested)
         {
-            // If we've been asked to terminate then the front of the workqueue
-            // will contain the termination request.
+            // If we've been asked to terminate then the termination request
+            // is processed ahead of any other work.
             {
-                std::function<void()> const work = std::move(workqueue.front());
+                std::function<void()> const work = std::move(termination_work);
+                termination_work = nullptr;
                 lock.unlock();
 
-                work();
+                if (work)
+                    work();
             }
             lock.lock();
         }
 
         on_wayland_thread = false;
         state = ExecutionState::Stopped;
-        workqueue.empty();
 
         return lock;
     }
 
     static int on_notify(int fd, uint32_t, void* data);
 private:
+    /*
+     * The workqueue is a multi-producer, single-consumer linked list (as
+     * described by Dmitry Vyukov): producers only exchange the head pointer,
+     * and only the Wayland thread touches the tail.
+     */
+    void push(Task* task)
+    {
+        // The stub is pushed again each time the queue empties, still linked to the task that followed it
+        task->next.store(nullptr, std::memory_order_relaxed);
+        auto const previous = head.exchange(task, std::memory_order_acq_rel);
+        previous->next.store(task, std::memory_order_release);
+    }
+
+    Task* pop()
+    {
+        for (;;)
+        {
+            auto current = tail;
+            auto next = current->next.load(std::memory_order_acquire);
+
+            if (current == &stub)
+            {
+                if (!next)
+                    return nullptr;
+
+                tail = next;
+                current = next;
+                next = next->next.load(std::memory_order_acquire);
+            }
+
+            if (next)
+            {
+                tail = next;
+                return current;
+            }
+
+            if (current == head.load(std::memory_order_acquire))
+            {
+                // current is the last task: put the stub behind it, so that we
+                // can hand it out without leaving the list empty
+                push(&stub);
+
+                next = current->next.load(std::memory_order_acquire);
+                if (next)
+                {
+                    tail = next;
+                    return current;
+                }
+            }
+
+            // A producer has claimed the head but not yet linked its task;
+            // it will within a few instructions.
+            std::this_thread::yield();
+        }
+    }
+
     static thread_local bool on_wayland_thread;
     std::mutex mutex;
-    ExecutionState state{ExecutionState::Running};
+    std::atomic<ExecutionState> state{ExecutionState::Running};
+    std::function<void()> termination_work;
     wl_event_loop* const loop;
-    std::deque<std::function<void()>> workqueue;
+
+    Task stub;
+    std::atomic<Task*> head;
+    Task* tail;
+
+    /// Set when the event loop has been woken and has yet to start processing the queue
+    std::atomic<bool> wakeup_pending{false};
 };
 
 thread_local bool mf::WaylandExecutor::State::on_wayland_thread{false};
@@ -233,6 +341,10 @@ int mf::WaylandExecutor::State::on_notify(int fd, uint32_t, void* data)
             err);
     }
 
+    // Tasks queued from here on need another wakeup, unless we get to them now.
+    // (An exchange, rather than a store, so we see everything queued before it.)
+    state->wakeup_pending.exchange(false);
+
     while (auto work = state->get_work())
     {
         try
@@ -319,7 +431,8 @@ mf::WaylandExecutor::~WaylandExecutor()
 
 void mf::WaylandExecutor::spawn (std::function<void()>&& work)
 {
-    state->enqueue(std::move(work));
+    if (!state->enqueue(std::move(work)))
+        return;
 
     if (auto err = eventfd_write(notify_fd, 1))
     {
@@ -25,6 +25,7 @@
 
 #include <mir/input/xkb_mapper.h>
 #include <mir/input/keymap.h>
+#include <mir/input/input_report.h>
 #include <mir/log.h>
 
 #include <linux/input-event-codes.h>
@@ -108,8 +109,13 @@ void mf::WaylandInputDispatcher::handle_input_event(MirInputEvent const* event)
         handle_touch_event(ms, mir_input_event_get_touch_event(event));
         break;
     default:
-        break;
+        return;
     }
+
+    seat->input_report().input_event_reached(
+        mi::InputEventStage::client,
+        mir_input_event_get_device_id(event),
+        mir_input_event_get_event_time(event));
 }
 
 void mf::WaylandInputDispatcher::handle_keyboard_event(std::chrono::milliseconds const& ms, MirKeyboardEvent const* event)
@@ -22,7 +22,6 @@
 #include "wl_surface.h"
 
 #include "mir/executor.h"
-#include "mir/anonymous_shm_file.h"
 #include "mir/input/keymap.h"
 #include "mir/log.h"
 
@@ -41,9 +40,8 @@ mf::WlKeyboard::WlKeyboard(
     std::function<void(WlKeyboard*)> const& on_destroy,
     std::function<std::vector<uint32_t>()> const& acquire_current_keyboard_state)
     : Keyboard(new_resource, Version<6>()),
-      keymap{nullptr, &xkb_keymap_unref},
+      keymap_cache{KeymapCache::instance()},
       state{nullptr, &xkb_state_unref},
-      context{xkb_context_new(XKB_CONTEXT_NO_FLAGS), &xkb_context_unref},
       on_destroy{on_destroy},
       acquire_current_keyboard_state{acquire_current_keyboard_state}
 {
@@ -150,7 +148,7 @@ void mf::WlKeyboard::focussed(WlSurface* surface, bool should_be_focused)
 void mf::WlKeyboard::update_keyboard_state(std::vector<uint32_t> const& keyboard_state)
 {
     // Rebuild xkb state
-    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
+    state = decltype(state)(xkb_state_new(keymap->keymap()), &xkb_state_unref);
     for (auto scancode : keyboard_state)
     {
         xkb_state_update_key(state.get(), scancode + 8, XKB_KEY_DOWN);
@@ -161,52 +159,22 @@ void mf::WlKeyboard::update_keyboard_state(std::vector<uint32_t> const& keyboard
 
 void mf::WlKeyboard::set_keymap(char const* const buffer, size_t length)
 {
-    mir::AnonymousShmFile shm_buffer{length};
-    memcpy(shm_buffer.base_ptr(), buffer, length);
-
-    send_keymap_event(KeymapFormat::xkb_v1,
-                      Fd{IntOwnedFd{shm_buffer.fd()}},
-                      length);
-
-    keymap = decltype(keymap)(xkb_keymap_new_from_buffer(
-        context.get(),
-        buffer,
-        length,
-        XKB_KEYMAP_FORMAT_TEXT_V1,
-        XKB_KEYMAP_COMPILE_NO_FLAGS),
-        &xkb_keymap_unref);
-
-    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
+    set_keymap(keymap_cache->keymap_from(buffer, length));
 }
 
 void mf::WlKeyboard::set_keymap(mi::Keymap const& new_keymap)
 {
-    xkb_rule_names const names = {
-        "evdev",
-        new_keymap.model.c_str(),
-        new_keymap.layout.c_str(),
-        new_keymap.variant.c_str(),
-        new_keymap.options.c_str()
-    };
-    keymap = decltype(keymap){
-        xkb_keymap_new_from_names(
-            context.get(),
-            &names,
-            XKB_KEYMAP_COMPILE_NO_FLAGS),
-        &xkb_keymap_unref};
-
-    // TODO: We might need to copy across the existing depressed keys?
-    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
+    set_keymap(keymap_cache->keymap_for(new_keymap));
+}
 
-    std::unique_ptr<char, void(*)(void*)> buffer{xkb_keymap_get_as_string(keymap.get(), XKB_KEYMAP_FORMAT_TEXT_V1), free};
-    auto length = strlen(buffer.get());
+void mf::WlKeyboard::set_keymap(std::shared_ptr<KeymapCache::CompiledKeymap const> const& new_keymap)
+{
+    keymap = new_keymap;
 
-    mir::AnonymousShmFile shm_buffer{length};
-    memcpy(shm_buffer.base_ptr(), buffer.get(), length);
+    // TODO: We might need to copy across the existing depressed keys?
+    state = decltype(state)(xkb_state_new(keymap->keymap()), &xkb_state_unref);
 
-    send_keymap_event(KeymapFormat::xkb_v1,
-                      Fd{IntOwnedFd{shm_buffer.fd()}},
-                      length);
+    send_keymap_event(KeymapFormat::xkb_v1, keymap->fd_for_client(), keymap->size());
 }
 
 void mf::WlKeyboard::update_modifier_state()
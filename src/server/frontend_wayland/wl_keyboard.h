@@ -20,15 +20,14 @@
 #define MIR_FRONTEND_WL_KEYBOARD_H
 
 #include "wayland_wrapper.h"
+#include "keymap_cache.h"
 
 #include <vector>
 #include <functional>
 #include <chrono>
 
 // from <xkbcommon/xkbcommon.h>
-struct xkb_keymap;
 struct xkb_state;
-struct xkb_context;
 
 namespace mir
 {
@@ -64,10 +63,11 @@ public:
 private:
     void update_modifier_state();
     void update_keyboard_state(std::vector<uint32_t> const& keyboard_state);
+    void set_keymap(std::shared_ptr<KeymapCache::CompiledKeymap const> const& new_keymap);
 
-    std::unique_ptr<xkb_keymap, void (*)(xkb_keymap *)> keymap;
+    std::shared_ptr<KeymapCache> const keymap_cache;
+    std::shared_ptr<KeymapCache::CompiledKeymap const> keymap;
     std::unique_ptr<xkb_state, void (*)(xkb_state *)> state;
-    std::unique_ptr<xkb_context, void (*)(xkb_context *)> const context;
 
     std::function<void(WlKeyboard*)> on_destroy;
     std::function<std::vector<uint32_t>()> const acquire_current_keyboard_state;
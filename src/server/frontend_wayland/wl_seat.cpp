@@ -158,6 +158,7 @@ mf::WlSeat::WlSeat(
     wl_display* display,
     std::shared_ptr<mi::InputDeviceHub> const& input_hub,
     std::shared_ptr<mi::Seat> const& seat,
+    std::shared_ptr<mi::InputReport> const& input_report,
     std::shared_ptr<mir::Executor> const& executor)
     :   Global(display, Version<6>()),
         keymap{std::make_unique<input::Keymap>()},
@@ -173,6 +174,7 @@ mf::WlSeat::WlSeat(
         touch_listeners{std::make_shared<ListenerList<WlTouch>>()},
         input_hub{input_hub},
         seat{seat},
+        input_report_{input_report},
         executor{executor}
 {
     input_hub->add_observer(config_observer);
@@ -38,6 +38,7 @@ class Executor;
 namespace input
 {
 class InputDeviceHub;
+class InputReport;
 class Seat;
 class Keymap;
 }
@@ -54,6 +55,7 @@ public:
         wl_display* display,
         std::shared_ptr<mir::input::InputDeviceHub> const& input_hub,
         std::shared_ptr<mir::input::Seat> const& seat,
+        std::shared_ptr<mir::input::InputReport> const& input_report,
         std::shared_ptr<mir::Executor> const& executor);
 
     ~WlSeat();
@@ -66,6 +68,8 @@ public:
 
     void spawn(std::function<void()>&& work);
 
+    auto input_report() const -> mir::input::InputReport& { return *input_report_; }
+
     class ListenerTracker
     {
     public:
@@ -113,6 +117,7 @@ private:
 
     std::shared_ptr<input::InputDeviceHub> const input_hub;
     std::shared_ptr<input::Seat> const seat;
+    std::shared_ptr<input::InputReport> const input_report_;
 
     std::shared_ptr<mir::Executor> const executor;
 
@@ -23,6 +23,7 @@
 #include "wl_subcompositor.h"
 #include "wl_region.h"
 #include "wlshmbuffer.h"
+#include "wp_presentation.h"
 #include "deleted_for_resource.h"
 
 #include "wayland_wrapper.h"
@@ -33,18 +34,41 @@
 #include "mir/scene/session.h"
 #include "mir/frontend/wayland.h"
 #include "mir/compositor/buffer_stream.h"
+#include "mir/compositor/frame_presentation.h"
 #include "mir/executor.h"
 #include "mir/graphics/wayland_allocator.h"
 #include "mir/shell/surface_specification.h"
+#include "mir/time/posix_timestamp.h"
 #include "mir/log.h"
 
 #include <algorithm>
+#include <limits>
 #include <boost/throw_exception.hpp>
 
 namespace mf = mir::frontend;
 namespace geom = mir::geometry;
 namespace mw = mir::wayland;
 namespace msh = mir::shell;
+namespace mc = mir::compositor;
+
+namespace
+{
+/// Frame callback times share the presentation clock, but have no particular base
+auto frame_time_now() -> std::chrono::milliseconds
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        mir::time::PosixTimestamp::now(CLOCK_MONOTONIC).nanoseconds);
+}
+
+void discard(std::vector<std::shared_ptr<mf::WpPresentationFeedback>> const& feedback)
+{
+    for (auto const& f : feedback)
+    {
+        if (!*f->destroyed)
+            f->discarded();
+    }
+}
+}
 
 mf::WlSurfaceState::Callback::Callback(wl_resource* new_resource)
     : mw::Callback{new_resource, Version<1>()},
@@ -63,10 +87,20 @@ void mf::WlSurfaceState::update_from(WlSurfaceState const& source)
     if (source.input_shape)
         input_shape = source.input_shape;
 
+    if (source.opaque_region)
+        opaque_region = source.opaque_region;
+
     frame_callbacks.insert(end(frame_callbacks),
                            begin(source.frame_callbacks),
                            end(source.frame_callbacks));
 
+    presentation_feedback.insert(end(presentation_feedback),
+                                 begin(source.presentation_feedback),
+                                 end(source.presentation_feedback));
+
+    for (auto const& rect : source.damage)
+        damage.add(rect);
+
     if (source.surface_data_invalidated)
         surface_data_invalidated = true;
 }
@@ -75,6 +109,7 @@ bool mf::WlSurfaceState::surface_data_needs_refresh() const
 {
     return offset ||
            input_shape ||
+           opaque_region ||
            surface_data_invalidated;
 }
 
@@ -108,6 +143,9 @@ mf::WlSurface::~WlSurface()
         listener.second();
     }
 
+    // Content that was never committed won't be presented
+    discard(pending.presentation_feedback);
+
     role->destroy();
     session->destroy_buffer_stream(stream);
 }
@@ -187,7 +225,15 @@ void mf::WlSurface::populate_surface_data(std::vector<shell::StreamSpecification
 {
     geometry::Displacement offset = parent_offset + offset_;
 
-    buffer_streams.push_back(msh::StreamSpecification{stream, offset, {}});
+    geom::Rectangles opaque;
+    for (auto const& rect : opaque_region)
+    {
+        auto const clipped = rect.intersection_with({{}, buffer_size_.value_or(geom::Size{})});
+        if (clipped.size != geom::Size{})
+            opaque.add(clipped);
+    }
+
+    buffer_streams.push_back(msh::StreamSpecification{stream, offset, {}, opaque});
     geom::Rectangle surface_rect = {geom::Point{} + offset, buffer_size_.value_or(geom::Size{})};
     if (input_shape)
     {
@@ -306,14 +352,13 @@ mf::WlSurface* mf::WlSurface::from(wl_resource* resource)
     return static_cast<WlSurface*>(static_cast<wayland::Surface*>(raw_surface));
 }
 
-void mf::WlSurface::send_frame_callbacks()
+void mf::WlSurface::send_frame_callbacks(std::chrono::milliseconds timestamp)
 {
     for (auto const& frame : frame_callbacks)
     {
         if (!*frame->destroyed)
         {
-            // TODO: argument should be a timestamp
-            frame->send_done_event(0);
+            frame->send_done_event(timestamp.count());
             frame->destroy_wayland_object();
         }
     }
@@ -340,20 +385,22 @@ void mf::WlSurface::attach(std::experimental::optional<wl_resource*> const& buff
 
 void mf::WlSurface::damage(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    // Without buffer scale or transform surface coordinates are buffer coordinates
+    damage_buffer(x, y, width, height);
 }
 
 void mf::WlSurface::damage_buffer(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Clients commonly damage {0, 0, INT32_MAX, INT32_MAX}; keep the far edges representable
+    if (x > 0)
+        width = std::min(width, std::numeric_limits<int32_t>::max() - x);
+    if (y > 0)
+        height = std::min(height, std::numeric_limits<int32_t>::max() - y);
+
+    pending.damage.add({{x, y}, {width, height}});
 }
 
 void mf::WlSurface::frame(wl_resource* new_callback)
@@ -361,10 +408,18 @@ void mf::WlSurface::frame(wl_resource* new_callback)
     pending.frame_callbacks.push_back(std::make_shared<WlSurfaceState::Callback>(new_callback));
 }
 
+void mf::WlSurface::add_presentation_feedback(std::shared_ptr<WpPresentationFeedback> const& feedback)
+{
+    pending.presentation_feedback.push_back(feedback);
+}
+
 void mf::WlSurface::set_opaque_region(std::experimental::optional<wl_resource*> const& region)
 {
-    (void)region;
-    // This isn't essential, but could enable optimizations
+    // A null region means nothing is known to be opaque
+    if (region)
+        pending.opaque_region = WlRegion::from(region.value())->rectangle_vector();
+    else
+        pending.opaque_region = std::vector<geom::Rectangle>{};
 }
 
 void mf::WlSurface::set_input_region(std::experimental::optional<wl_resource*> const& region)
@@ -395,6 +450,9 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
     if (state.input_shape)
         input_shape = state.input_shape.value();
 
+    if (state.opaque_region)
+        opaque_region = state.opaque_region.value();
+
     if (state.buffer)
     {
         wl_resource * buffer = *state.buffer;
@@ -403,18 +461,37 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
         {
             // TODO: unmap surface, and unmap all subsurfaces
             buffer_size_ = std::experimental::nullopt;
-            send_frame_callbacks();
+            send_frame_callbacks(frame_time_now());
+            discard(state.presentation_feedback);
         }
         else
         {
-            auto const executor_send_frame_callbacks = [this, executor = executor, destroyed = destroyed]()
+            // If the buffer is dropped without being shown, the feedback is discarded along with it
+            std::shared_ptr<CommitPresentationFeedback> const feedback{
+                state.presentation_feedback.empty() ? nullptr :
+                std::make_shared<CommitPresentationFeedback>(state.presentation_feedback, executor)};
+
+            // The compositor consumes the buffer while rendering a frame, but clients should
+            // be told to draw their next frame as the one they've just drawn is shown.
+            auto const executor_send_frame_callbacks =
+                [this, executor = executor, destroyed = destroyed, feedback]()
                 {
-                    executor->spawn(run_unless(
-                        destroyed,
-                        [this]()
+                    mc::on_frame_presented(
+                        [this, executor, destroyed, feedback](mc::FramePresentation const& presentation)
                         {
-                            send_frame_callbacks();
-                        }));
+                            if (feedback)
+                                feedback->presented(presentation);
+
+                            auto const timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                presentation.frame.ust.nanoseconds);
+
+                            executor->spawn(run_unless(
+                                destroyed,
+                                [this, timestamp]()
+                                {
+                                    send_frame_callbacks(timestamp);
+                                }));
+                        });
                 };
 
             std::shared_ptr<graphics::Buffer> mir_buffer;
@@ -458,12 +535,21 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
                 state.invalidate_surface_data(); // input shape needs to be recalculated for the new size
             }
             buffer_size_ = mir_buffer->size();
-            stream->submit_buffer(mir_buffer);
+
+            // Clients are supposed to damage what they change, but some don't bother
+            // with damage at all. Treat those as having damaged the whole buffer.
+            if (state.damage.size())
+                stream->submit_buffer(mir_buffer, state.damage);
+            else
+                stream->submit_buffer(mir_buffer);
         }
     }
     else
     {
-        send_frame_callbacks();
+        send_frame_callbacks(frame_time_now());
+
+        // There's no new content to present
+        discard(state.presentation_feedback);
     }
 
     for (WlSubsurface* child: children)
@@ -26,7 +26,9 @@
 #include "mir/geometry/displacement.h"
 #include "mir/geometry/size.h"
 #include "mir/geometry/point.h"
+#include "mir/geometry/rectangles.h"
 
+#include <chrono>
 #include <vector>
 #include <map>
 
@@ -58,6 +60,7 @@ namespace frontend
 {
 class WlSurface;
 class WlSubsurface;
+class WpPresentationFeedback;
 
 struct WlSurfaceState
 {
@@ -82,7 +85,13 @@ struct WlSurfaceState
 
     std::experimental::optional<geometry::Displacement> offset;
     std::experimental::optional<std::experimental::optional<std::vector<geometry::Rectangle>>> input_shape;
+    std::experimental::optional<std::vector<geometry::Rectangle>> opaque_region;
     std::vector<std::shared_ptr<Callback>> frame_callbacks;
+    std::vector<std::shared_ptr<WpPresentationFeedback>> presentation_feedback;
+
+    // Damage in buffer coordinates. As we don't (yet) support buffer scale or
+    // transform, surface and buffer coordinates are the same.
+    geometry::Rectangles damage;
 
 private:
     // only set to true if invalidate_surface_data() is called
@@ -141,6 +150,7 @@ public:
                                std::vector<mir::geometry::Rectangle>& input_shape_accumulator,
                                geometry::Displacement const& parent_offset) const;
     void commit(WlSurfaceState const& state);
+    void add_presentation_feedback(std::shared_ptr<WpPresentationFeedback> const& feedback);
     void add_destroy_listener(void const* key, std::function<void()> listener);
     void remove_destroy_listener(void const* key);
 
@@ -168,10 +178,11 @@ private:
     std::experimental::optional<geometry::Size> buffer_size_;
     std::vector<std::shared_ptr<WlSurfaceState::Callback>> frame_callbacks;
     std::experimental::optional<std::vector<mir::geometry::Rectangle>> input_shape;
+    std::vector<mir::geometry::Rectangle> opaque_region;
     std::map<void const*, std::function<void()>> destroy_listeners;
     std::shared_ptr<bool> const destroyed;
 
-    void send_frame_callbacks();
+    void send_frame_callbacks(std::chrono::milliseconds timestamp);
 
     void destroy() override;
     void attach(std::experimental::optional<wl_resource*> const& buffer, int32_t x, int32_t y) override;
@@ -129,12 +129,17 @@ using namespace mir::geometry;
 
 mf::WlShmBuffer::~WlShmBuffer()
 {
-    executor->spawn([wayland = wayland]()
+    executor->spawn([wayland = wayland, pool = pool]()
         {
-            std::lock_guard <std::mutex> lock{wayland->mutex};
-            if (wayland->resource) {
-                wl_resource_queue_event(wayland->resource.value(), WL_BUFFER_RELEASE);
+            {
+                std::lock_guard <std::mutex> lock{wayland->mutex};
+                if (wayland->resource) {
+                    wl_resource_queue_event(wayland->resource.value(), WL_BUFFER_RELEASE);
+                }
             }
+
+            // The pool's reference count isn't threadsafe, so we drop it on the Wayland thread
+            wl_shm_pool_unref(pool);
         });
 }
 
@@ -154,6 +159,7 @@ std::shared_ptr<mg::Buffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
         {
             // There's already a Mir buffer for this wl_buffer
             // Add the new on_consumed, and we're ready to go
+            std::lock_guard <std::mutex> lock{mir_buffer->wayland->mutex};
             mir_buffer->on_consumed = [a = mir_buffer->on_consumed, b = on_consumed]()
                 {
                     a();
@@ -231,6 +237,40 @@ void mf::WlShmBuffer::gl_bind_to_texture()
     }
 }
 
+void mf::WlShmBuffer::update_texture(Rectangles const& damage)
+{
+    GLenum format, type;
+
+    // Without GL_UNPACK_ROW_LENGTH (not in GLES2) we can only upload whole rows
+    // straight out of the pool when they are tightly packed
+    auto const row_bytes = size_.width.as_int() * MIR_BYTES_PER_PIXEL(format_);
+    if (stride_.as_int() != row_bytes || !get_gl_pixel_format(format_, format, type))
+    {
+        gl_bind_to_texture();
+        return;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    read(
+        [this, &damage, format, type](unsigned char const *pixels)
+        {
+            Rectangle const buffer_area{{0, 0}, size_};
+            for (auto const& rect : damage)
+            {
+                auto const band = rect.intersection_with(buffer_area);
+                if (band.size.height == Height{0} || band.size.width == Width{0})
+                    continue;
+
+                auto const top = band.top_left.y.as_int();
+                glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                0, top,
+                                size_.width.as_int(), band.size.height.as_int(),
+                                format, type, pixels + top * stride_.as_int());
+            }
+        });
+}
+
 void mf::WlShmBuffer::bind()
 {
     gl_bind_to_texture();
@@ -263,7 +303,35 @@ void mf::WlShmBuffer::read(std::function<void(unsigned char const *)> const &do_
         consumed = true;
     }
 
-    do_with_pixels(static_cast<unsigned char const *>(data.get()));
+    if (copy)
+    {
+        do_with_pixels(copy.get());
+        return;
+    }
+
+    if (!wayland->buffer) {
+        log_warning("Attempt to read from WlShmBuffer after the wl_buffer has been destroyed");
+        return;
+    }
+
+    // If the client truncates the pool under us, libwayland maps zeros over it instead of SIGBUSing
+    wl_shm_buffer_begin_access(wayland->buffer.value());
+    do_with_pixels(data);
+    wl_shm_buffer_end_access(wayland->buffer.value());
+}
+
+void mf::WlShmBuffer::copy_client_pixels()
+{
+    std::lock_guard <std::mutex> lock{wayland->mutex};
+    if (copy || !wayland->buffer)
+        return;
+
+    auto const length = size_.height.as_int() * stride_.as_int();
+    copy = std::make_unique<unsigned char[]>(length);
+
+    wl_shm_buffer_begin_access(wayland->buffer.value());
+    std::memcpy(copy.get(), data, length);
+    wl_shm_buffer_end_access(wayland->buffer.value());
 }
 
 Stride mf::WlShmBuffer::stride() const
@@ -294,7 +362,8 @@ mf::WlShmBuffer::WlShmBuffer(
         wl_shm_buffer_get_height(wayland->buffer.value())},
     stride_{wl_shm_buffer_get_stride(wayland->buffer.value())},
     format_{wl_format_to_mir_format(wl_shm_buffer_get_format(wayland->buffer.value()))},
-    data{std::make_unique<uint8_t[]>(size_.height.as_int() * stride_.as_int())},
+    pool{nullptr},
+    data{nullptr},
     consumed{false},
     on_consumed{std::move(on_consumed)},
     executor{executor}
@@ -311,9 +380,8 @@ mf::WlShmBuffer::WlShmBuffer(
                                   std::runtime_error{"Buffer has invalid stride"}));
     }
 
-    wl_shm_buffer_begin_access(wayland->buffer.value());
-    std::memcpy(data.get(), wl_shm_buffer_get_data(wayland->buffer.value()), size_.height.as_int() * stride_.as_int());
-    wl_shm_buffer_end_access(wayland->buffer.value());
+    pool = wl_shm_buffer_ref_pool(wayland->buffer.value());
+    data = static_cast<unsigned char const*>(wl_shm_buffer_get_data(wayland->buffer.value()));
 }
 
 void mf::WlShmBuffer::on_buffer_destroyed(wl_listener *listener, void *)
@@ -325,6 +393,11 @@ void mf::WlShmBuffer::on_buffer_destroyed(wl_listener *listener, void *)
     DestructionShim *shim;
     shim = wl_container_of(listener, shim, destruction_listener);
 
+    if (auto const mir_buffer = shim->mir_buffer.lock())
+    {
+        mir_buffer->copy_client_pixels();
+    }
+
     {
         if (auto resources = shim->resources.lock())
         {
@@ -27,6 +27,7 @@
 #include <wayland-server-core.h>
 
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <experimental/optional>
@@ -42,6 +43,7 @@ class WlShmBuffer :
     public graphics::BufferBasic,
     public graphics::NativeBufferBase,
     public renderer::gl::TextureSource,
+    public renderer::gl::IncrementalTextureSource,
     public renderer::software::PixelSource
 {
 public:
@@ -68,6 +70,8 @@ public:
 
     void bind() override;
 
+    void update_texture(geometry::Rectangles const& damage) override;
+
     void secure_for_render() override;
 
     void write(unsigned char const *pixels, size_t size) override;
@@ -82,6 +86,9 @@ private:
 
     static void on_buffer_destroyed(wl_listener *listener, void *);
 
+    /// Keep the pixels for when the client may reuse the pool's memory while we still need them
+    void copy_client_pixels();
+
     struct WaylandResources
     {
         WaylandResources(wl_resource *resource);
@@ -106,7 +113,19 @@ private:
     geometry::Stride const stride_;
     MirPixelFormat const format_;
 
-    std::unique_ptr<uint8_t[]> const data;
+    /*
+     * Rather than copy the client's pixels we read them straight from the
+     * client's shm pool. Holding a reference to the pool keeps it mapped
+     * (and stops a resize from moving it) until we are destroyed.
+     *
+     * The client doesn't get the wl_buffer back until we are destroyed, as
+     * we may be read again (by another output, or for a snapshot) at any
+     * time until then. If the client destroys the wl_buffer before that,
+     * we take a copy of its pixels.
+     */
+    wl_shm_pool* pool;
+    unsigned char const* data;
+    std::unique_ptr<unsigned char[]> copy;
 
     bool consumed;
     std::function<void()> on_consumed;
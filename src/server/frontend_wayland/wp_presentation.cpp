@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "wp_presentation.h"
+
+#include "wl_surface.h"
+#include "output_manager.h"
+#include "deleted_for_resource.h"
+
+#include "mir/compositor/frame_presentation.h"
+#include "mir/executor.h"
+
+#include <time.h>
+
+namespace mf = mir::frontend;
+namespace mc = mir::compositor;
+namespace mw = mir::wayland;
+
+namespace mir
+{
+namespace frontend
+{
+class WpPresentation : public wayland::Presentation::Global
+{
+public:
+    WpPresentation(wl_display* display, OutputManager* const output_manager);
+
+private:
+    class Instance : public wayland::Presentation
+    {
+    public:
+        Instance(wl_resource* new_resource, OutputManager* const output_manager);
+
+    private:
+        void destroy() override;
+        void feedback(wl_resource* surface, wl_resource* callback) override;
+
+        OutputManager* const output_manager;
+    };
+
+    void bind(wl_resource* new_resource) override;
+
+    OutputManager* const output_manager;
+};
+}
+}
+
+auto mf::create_wp_presentation(wl_display* display, OutputManager* const output_manager)
+    -> std::shared_ptr<WpPresentation>
+{
+    return std::make_shared<WpPresentation>(display, output_manager);
+}
+
+mf::WpPresentation::WpPresentation(wl_display* display, OutputManager* const output_manager)
+    : Global(display, Version<1>()),
+      output_manager{output_manager}
+{
+}
+
+void mf::WpPresentation::bind(wl_resource* new_resource)
+{
+    new Instance{new_resource, output_manager};
+}
+
+mf::WpPresentation::Instance::Instance(wl_resource* new_resource, OutputManager* const output_manager)
+    : Presentation{new_resource, Version<1>()},
+      output_manager{output_manager}
+{
+    // The compositor reports frame times (and DRM page flips) with CLOCK_MONOTONIC
+    send_clock_id_event(CLOCK_MONOTONIC);
+}
+
+void mf::WpPresentation::Instance::destroy()
+{
+    destroy_wayland_object();
+}
+
+void mf::WpPresentation::Instance::feedback(wl_resource* surface, wl_resource* callback)
+{
+    WlSurface::from(surface)->add_presentation_feedback(
+        std::make_shared<WpPresentationFeedback>(callback, output_manager));
+}
+
+mf::WpPresentationFeedback::WpPresentationFeedback(wl_resource* new_resource, OutputManager* const output_manager)
+    : PresentationFeedback{new_resource, Version<1>()},
+      destroyed{deleted_flag_for_resource(resource)},
+      output_manager{output_manager}
+{
+}
+
+void mf::WpPresentationFeedback::presented(mc::FramePresentation const& presentation)
+{
+    if (presentation.output)
+    {
+        if (auto const output = output_manager->output_for(presentation.output.value()))
+        {
+            output.value()->for_each_output_resource_bound_by(
+                client,
+                [this](wl_resource* output_resource) { send_sync_output_event(output_resource); });
+        }
+    }
+
+    auto const time = presentation.frame.ust.nanoseconds.count();
+    uint64_t const seconds = time / 1000000000;
+    uint32_t const nanoseconds = time % 1000000000;
+    uint64_t const sequence = presentation.frame.msc;
+
+    // We only know the frame was synchronised to the output's vblank when the display told us
+    uint32_t const flags = presentation.hardware_clock ?
+        Kind::vsync | Kind::hw_clock | Kind::hw_completion : 0;
+
+    send_presented_event(
+        seconds >> 32, seconds & 0xffffffff,
+        nanoseconds,
+        presentation.refresh_interval.count(),
+        sequence >> 32, sequence & 0xffffffff,
+        flags);
+    destroy_wayland_object();
+}
+
+void mf::WpPresentationFeedback::discarded()
+{
+    send_discarded_event();
+    destroy_wayland_object();
+}
+
+mf::CommitPresentationFeedback::CommitPresentationFeedback(
+    std::vector<std::shared_ptr<WpPresentationFeedback>> const& feedback,
+    std::shared_ptr<Executor> const& executor)
+    : executor{executor},
+      feedback{feedback}
+{
+}
+
+mf::CommitPresentationFeedback::~CommitPresentationFeedback()
+{
+    if (feedback.empty())
+        return;
+
+    executor->spawn(
+        [feedback = std::move(feedback)]()
+        {
+            for (auto const& f : feedback)
+            {
+                if (!*f->destroyed)
+                    f->discarded();
+            }
+        });
+}
+
+void mf::CommitPresentationFeedback::presented(mc::FramePresentation const& presentation)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (feedback.empty())
+        return;
+
+    executor->spawn(
+        [feedback = std::move(feedback), presentation]()
+        {
+            for (auto const& f : feedback)
+            {
+                if (!*f->destroyed)
+                    f->presented(presentation);
+            }
+        });
+    feedback.clear();
+}
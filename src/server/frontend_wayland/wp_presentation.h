@@ -0,0 +1,91 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_WP_PRESENTATION_H
+#define MIR_FRONTEND_WP_PRESENTATION_H
+
+#include "presentation-time_wrapper.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct wl_display;
+
+namespace mir
+{
+class Executor;
+
+namespace compositor
+{
+struct FramePresentation;
+}
+
+namespace frontend
+{
+class OutputManager;
+class WpPresentation;
+
+auto create_wp_presentation(wl_display* display, OutputManager* const output_manager)
+    -> std::shared_ptr<WpPresentation>;
+
+class WpPresentationFeedback : public wayland::PresentationFeedback
+{
+public:
+    WpPresentationFeedback(wl_resource* new_resource, OutputManager* const output_manager);
+
+    /// Sends the sync_output and presented events, and destroys the feedback
+    void presented(compositor::FramePresentation const& presentation);
+    /// Sends the discarded event, and destroys the feedback
+    void discarded();
+
+    std::shared_ptr<bool> const destroyed;
+
+private:
+    OutputManager* const output_manager;
+};
+
+/**
+ * The presentation feedback requested for a single wl_surface commit.
+ *
+ * This can be handed to the compositor along with the commit's buffer. If it
+ * is released (on any thread) without having been presented, the feedback is
+ * discarded.
+ */
+class CommitPresentationFeedback
+{
+public:
+    CommitPresentationFeedback(
+        std::vector<std::shared_ptr<WpPresentationFeedback>> const& feedback,
+        std::shared_ptr<Executor> const& executor);
+    ~CommitPresentationFeedback();
+
+    /// Can be called from any thread; the events are sent from the Wayland thread
+    void presented(compositor::FramePresentation const& presentation);
+
+private:
+    CommitPresentationFeedback(CommitPresentationFeedback const&) = delete;
+    CommitPresentationFeedback& operator=(CommitPresentationFeedback const&) = delete;
+
+    std::shared_ptr<Executor> const executor;
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<WpPresentationFeedback>> feedback;
+};
+}
+}
+
+#endif // MIR_FRONTEND_WP_PRESENTATION_H
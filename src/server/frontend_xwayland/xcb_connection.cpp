@@ -45,6 +45,37 @@ auto data_buffer_to_debug_string(
     ss << "]";
     return ss.str();
 }
+
+/// A property request, the reply to which is discarded if never waited for
+class PropertyCookie
+{
+public:
+    PropertyCookie(xcb_connection_t* connection, xcb_get_property_cookie_t cookie)
+        : connection{connection},
+          cookie{cookie}
+    {
+    }
+
+    ~PropertyCookie()
+    {
+        if (!waited)
+            xcb_discard_reply(connection, cookie.sequence);
+    }
+
+    auto wait_for_reply() -> xcb_get_property_reply_t*
+    {
+        waited = true;
+        return xcb_get_property_reply(connection, cookie, nullptr);
+    }
+
+private:
+    PropertyCookie(PropertyCookie const&) = delete;
+    PropertyCookie& operator=(PropertyCookie const&) = delete;
+
+    xcb_connection_t* const connection;
+    xcb_get_property_cookie_t const cookie;
+    bool waited{false};
+};
 }
 
 mf::XCBConnection::Atom::Atom(std::string const& name, XCBConnection* connection)
@@ -209,18 +240,20 @@ auto mf::XCBConnection::read_property(
     std::function<void(xcb_get_property_reply_t*)> action,
     std::function<void()> on_error) -> std::function<void()>
 {
-    xcb_get_property_cookie_t cookie = xcb_get_property(
+    auto const cookie = std::make_shared<PropertyCookie>(
         xcb_connection,
-        0, // don't delete
-        window,
-        prop,
-        XCB_ATOM_ANY,
-        0, // no offset
-        2048); // big buffer
-
-    return [xcb_connection = xcb_connection, cookie, action, on_error]()
+        xcb_get_property(
+            xcb_connection,
+            0, // don't delete
+            window,
+            prop,
+            XCB_ATOM_ANY,
+            0, // no offset
+            2048)); // big buffer
+
+    return [cookie, action, on_error]()
         {
-            xcb_get_property_reply_t *reply = xcb_get_property_reply(xcb_connection, cookie, nullptr);
+            xcb_get_property_reply_t *reply = cookie->wait_for_reply();
             if (reply && reply->type != XCB_ATOM_NONE)
             {
                 try
@@ -106,6 +106,8 @@ public:
 
     /// Read a single property of various types from the window
     /// Returns a function that will wait on the reply before calling action()
+    /// If the function is destroyed without being called the reply is discarded, so a property can be requested
+    /// ahead of knowing whether it will be needed
     /// @{
     auto read_property(
         xcb_window_t window,
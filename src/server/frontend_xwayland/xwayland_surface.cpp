@@ -203,6 +203,15 @@ mf::XWaylandSurface::XWaylandSurface(
 
     uint32_t const value = XCB_EVENT_MASK_PROPERTY_CHANGE | XCB_EVENT_MASK_FOCUS_CHANGE;
     xcb_change_window_attributes(*connection, window, XCB_CW_EVENT_MASK, &value);
+
+    // Request all the properties we handle in one batch now, so the replies are waiting when the window is first
+    // attached to a wl_surface. Later changes are picked up by property_notify().
+    prefetched_properties = std::map<xcb_atom_t, std::function<void()>>{};
+    for (auto const& handler : property_handlers)
+    {
+        prefetched_properties.value()[handler.first] = handler.second();
+    }
+    connection->flush();
 }
 
 mf::XWaylandSurface::~XWaylandSurface()
@@ -490,35 +499,67 @@ void mf::XWaylandSurface::property_notify(xcb_atom_t property)
     auto const handler = property_handlers.find(property);
     if (handler != property_handlers.end())
     {
-        auto completion = handler->second();
-        completion();
+        {
+            // Serialised with attach_wl_surface() processing the prefetched replies, so a newer value is never
+            // overwritten by an older one
+            std::lock_guard<std::mutex> property_lock{property_mutex};
+            std::function<void()> prefetched;
 
-        std::shared_ptr<scene::Surface> scene_surface;
-        std::experimental::optional<std::unique_ptr<shell::SurfaceSpecification>> spec;
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                if (prefetched_properties)
+                {
+                    auto const reply = prefetched_properties.value().find(property);
+                    if (reply != prefetched_properties.value().end())
+                    {
+                        prefetched = move(reply->second);
+                        prefetched_properties.value().erase(reply);
+                    }
+                }
+            }
 
-        {
-            std::lock_guard<std::mutex> lock{mutex};
-            scene_surface = weak_scene_surface.lock();
-            spec = consume_pending_spec(lock);
+            // The prefetched value is out of date, but processing it first keeps the updates in order
+            if (prefetched)
+                prefetched();
+
+            auto completion = handler->second();
+            completion();
         }
 
-        if (spec && scene_surface)
-        {
-            if (spec.value()->application_id.is_set() &&
-                spec.value()->application_id.value() == scene_surface->application_id())
-                spec.value()->application_id.consume();
+        apply_any_pending_spec();
+    }
+}
 
-            if (spec.value()->name.is_set() &&
-                spec.value()->name.value() == scene_surface->name())
-                spec.value()->name.consume();
+void mf::XWaylandSurface::apply_any_pending_spec()
+{
+    std::shared_ptr<scene::Surface> scene_surface;
+    std::experimental::optional<std::unique_ptr<shell::SurfaceSpecification>> spec;
 
-            if (spec.value()->parent.is_set() &&
-                spec.value()->parent.value().lock() == scene_surface->parent())
-                spec.value()->parent.consume();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        scene_surface = weak_scene_surface.lock();
 
-            if (!spec.value()->is_empty())
-                shell->modify_surface(scene_surface->session().lock(), scene_surface, *spec.value());
-        }
+        // Until there is a scene surface the pending spec is left for attach_wl_surface() to use
+        if (scene_surface)
+            spec = consume_pending_spec(lock);
+    }
+
+    if (spec && scene_surface)
+    {
+        if (spec.value()->application_id.is_set() &&
+            spec.value()->application_id.value() == scene_surface->application_id())
+            spec.value()->application_id.consume();
+
+        if (spec.value()->name.is_set() &&
+            spec.value()->name.value() == scene_surface->name())
+            spec.value()->name.consume();
+
+        if (spec.value()->parent.is_set() &&
+            spec.value()->parent.value().lock() == scene_surface->parent())
+            spec.value()->parent.consume();
+
+        if (!spec.value()->is_empty())
+            shell->modify_surface(scene_surface->session().lock(), scene_surface, *spec.value());
     }
 }
 
@@ -567,18 +608,42 @@ void mf::XWaylandSurface::attach_wl_surface(WlSurface* wl_surface)
         params.server_side_decorated = !cached.override_redirect;
     }
 
-    std::vector<std::function<void()>> reply_functions;
-
-    // Read all properties
-    for (auto const& handler : property_handlers)
     {
-        reply_functions.push_back(handler.second());
-    }
+        // Held while the replies are processed, so that property_notify() either processes a property's prefetched
+        // reply itself or applies its newer value after this one
+        std::lock_guard<std::mutex> property_lock{property_mutex};
+        std::experimental::optional<std::map<xcb_atom_t, std::function<void()>>> prefetched;
 
-    // Wait for and process all the XCB replies
-    for (auto const& reply_function : reply_functions)
-    {
-        reply_function();
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            prefetched.swap(prefetched_properties);
+        }
+
+        if (prefetched)
+        {
+            // Use the replies to the properties requested on creation that property_notify() has not already used
+            for (auto const& reply : prefetched.value())
+            {
+                reply.second();
+            }
+        }
+        else
+        {
+            // The window has been attached before, so its properties all need reading again
+            std::vector<std::function<void()>> reply_functions;
+
+            // Read all properties
+            for (auto const& handler : property_handlers)
+            {
+                reply_functions.push_back(handler.second());
+            }
+
+            // Wait for and process all the XCB replies
+            for (auto const& reply_function : reply_functions)
+            {
+                reply_function();
+            }
+        }
     }
 
     // property_handlers will have updated the pending spec. Use it.
@@ -603,6 +668,9 @@ void mf::XWaylandSurface::attach_wl_surface(WlSurface* wl_surface)
         std::lock_guard<std::mutex> lock{mutex};
         weak_scene_surface = surface;
     }
+
+    // Pick up anything property_notify() left in the pending spec while the scene surface was being created
+    apply_any_pending_spec();
 }
 
 void mf::XWaylandSurface::move_resize(uint32_t detail)
@@ -123,6 +123,10 @@ private:
 
     auto latest_input_timestamp(std::lock_guard<std::mutex> const&) -> std::chrono::nanoseconds;
 
+    /// Applies the pending spec to the scene surface, if there is one
+    /// Should NOT be called under lock
+    void apply_any_pending_spec();
+
     XWaylandWM* const xwm;
     std::shared_ptr<XCBConnection> const connection;
     WlSeat& seat;
@@ -132,6 +136,10 @@ private:
 
     std::mutex mutable mutex;
 
+    /// Held while property replies are processed, so they are applied in the order they were read
+    /// Always locked before mutex
+    std::mutex property_mutex;
+
     /// Cached version of properties on the X server
     struct
     {
@@ -153,6 +161,10 @@ private:
     std::weak_ptr<scene::Session> weak_session;
     std::unique_ptr<shell::SurfaceSpecification> nullable_pending_spec;
     std::weak_ptr<scene::Surface> weak_scene_surface;
+
+    /// Replies to the property requests made on creation that are yet to be processed
+    /// Cleared when the window is first attached to a wl_surface
+    std::experimental::optional<std::map<xcb_atom_t, std::function<void()>>> prefetched_properties;
 };
 } /* frontend */
 } /* mir */
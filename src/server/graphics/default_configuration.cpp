@@ -37,7 +37,6 @@
 #include "display_configuration_observer_multiplexer.h"
 
 #include "mir/shared_library.h"
-#include "mir/shared_library_prober.h"
 #include "mir/abnormal_exit.h"
 #include "mir/emergency_cleanup.h"
 #include "mir/log.h"
@@ -113,14 +112,12 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                 }
                 else
                 {
-                    auto const& path = the_options()->get<std::string>(options::platform_path);
-                    auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
-                    if (platforms.empty())
-                    {
-                        auto msg = "Failed to find any platform plugins in: " + path;
-                        throw std::runtime_error(msg.c_str());
-                    }
-                    platform_library = mir::graphics::module_for_device(platforms, dynamic_cast<mir::options::ProgramOption&>(*the_options()), the_console_services());
+                    platform_library = mir::graphics::module_for_device(
+                        the_options()->get<std::string>(options::platform_path),
+                        *the_platform_probe_cache(),
+                        dynamic_cast<mir::options::ProgramOption&>(*the_options()),
+                        the_console_services(),
+                        *the_shared_library_prober_report());
                 }
                 auto create_host_platform =
                     [platform_library]() -> std::function<std::remove_pointer<mg::CreateHostPlatform>::type>
@@ -17,11 +17,74 @@
  */
 
 #include "mir/log.h"
+#include "mir/libname.h"
 #include "mir/graphics/platform.h"
+#include "mir/platform_probe_cache.h"
+#include "mir/shared_library_prober.h"
+#include "mir/shared_library_prober_report.h"
 #include "platform_probe.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <chrono>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+char const* const graphics_role = "graphics";
+
+auto describe_function(mir::SharedLibrary const& module) -> mg::DescribeModule
+{
+    try
+    {
+        return module.load_function<mg::DescribeModule>(
+            "describe_graphics_module",
+            MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+
+    }
+    catch (std::runtime_error const&)
+    {
+        return module.load_function<mg::DescribeModule>(
+            "describe_graphics_module",
+            mg::obsolete_0_27::symbol_version);
+
+    }
+}
+
+// The file module was loaded from (which any of its symbols can tell us)
+auto filename_of(mir::SharedLibrary const& module) -> std::string
+{
+    return mir::detail::libname_impl(reinterpret_cast<void*>(describe_function(module)));
+}
+
+auto best_module(
+    std::vector<std::shared_ptr<mir::SharedLibrary>> const& modules,
+    mir::options::ProgramOption const& options,
+    std::shared_ptr<mir::ConsoleServices> const& console)
+-> std::pair<std::shared_ptr<mir::SharedLibrary>, mg::PlatformPriority>
+{
+    mg::PlatformPriority best_priority_so_far = mg::unsupported;
+    std::shared_ptr<mir::SharedLibrary> best_module_so_far;
+    for (auto& module : modules)
+    {
+        try
+        {
+            auto module_priority = mg::probe_module(*module, options, console);
+            if (module_priority > best_priority_so_far)
+            {
+                best_priority_so_far = module_priority;
+                best_module_so_far = module;
+            }
+        }
+        catch (std::runtime_error const&)
+        {
+        }
+    }
+    return {best_module_so_far, best_priority_so_far};
+}
+}
+
 auto mir::graphics::probe_module(
     mir::SharedLibrary& module,
     mir::options::ProgramOption const& options,
@@ -60,24 +123,7 @@ auto mir::graphics::probe_module(
 
     auto module_priority = probe(console, options);
 
-    auto describe =
-        [&module]()
-        {
-          try
-          {
-              return module.load_function<DescribeModule>(
-                  "describe_graphics_module",
-                  MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-
-          }
-          catch (std::runtime_error const&)
-          {
-              return module.load_function<DescribeModule>(
-                  "describe_graphics_module",
-                  obsolete_0_27::symbol_version);
-
-          }
-        }() ;
+    auto describe = describe_function(module);
     auto desc = describe();
     mir::log_info("Found graphics driver: %s (version %d.%d.%d) Support priority: %d",
                   desc->name,
@@ -95,26 +141,57 @@ mir::graphics::module_for_device(
     mir::options::ProgramOption const& options,
     std::shared_ptr<ConsoleServices> const& console)
 {
-    mir::graphics::PlatformPriority best_priority_so_far = mir::graphics::unsupported;
-    std::shared_ptr<mir::SharedLibrary> best_module_so_far;
-    for (auto& module : modules)
+    auto const best = best_module(modules, options, console);
+    if (best.second > mir::graphics::unsupported)
+    {
+        return best.first;
+    }
+    BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+}
+
+std::shared_ptr<mir::SharedLibrary>
+mir::graphics::module_for_device(
+    std::string const& path,
+    PlatformProbeCache& cache,
+    mir::options::ProgramOption const& options,
+    std::shared_ptr<ConsoleServices> const& console,
+    SharedLibraryProberReport& report)
+{
+    auto const start = std::chrono::steady_clock::now();
+
+    if (auto const cached = cache.lookup(graphics_role))
     {
         try
         {
-            auto module_priority = probe_module(*module, options, console);
-            if (module_priority > best_priority_so_far)
+            report.loading_cached_library(cached.value().module);
+            auto const module = std::make_shared<SharedLibrary>(cached.value().module);
+
+            // If it doesn't probe as it did the system has changed in a way the cache can't see
+            if (static_cast<int>(probe_module(*module, options, console)) == cached.value().priority)
             {
-                best_priority_so_far = module_priority;
-                best_module_so_far = module;
+                report.probing_finished(path, std::chrono::steady_clock::now() - start);
+                return module;
             }
         }
-        catch (std::runtime_error const&)
+        catch (std::runtime_error const& error)
         {
+            report.loading_failed(cached.value().module, error);
         }
     }
-    if (best_priority_so_far > mir::graphics::unsupported)
+
+    auto const modules = libraries_for_path(path, report);
+    if (modules.empty())
     {
-        return best_module_so_far;
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find any platform plugins in: " + path}));
     }
-    BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+
+    auto const best = best_module(modules, options, console);
+    if (best.second <= mir::graphics::unsupported)
+    {
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+    }
+
+    cache.store(graphics_role, {filename_of(*best.first), static_cast<int>(best.second)});
+    report.probing_finished(path, std::chrono::steady_clock::now() - start);
+    return best.first;
 }
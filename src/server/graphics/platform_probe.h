@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "mir/shared_library.h"
 #include "mir/options/program_option.h"
 #include "mir/graphics/platform.h"
@@ -28,6 +29,8 @@
 namespace mir
 {
 class ConsoleServices;
+class PlatformProbeCache;
+class SharedLibraryProberReport;
 
 namespace graphics
 {
@@ -43,6 +46,15 @@ std::shared_ptr<SharedLibrary> module_for_device(
     options::ProgramOption const& options,
     std::shared_ptr<ConsoleServices> const& console);
 
+/// Selects the module for the device from those in \a path, trying the module stored
+/// in \a cache before loading them all (and storing the one selected for next time)
+std::shared_ptr<SharedLibrary> module_for_device(
+    std::string const& path,
+    PlatformProbeCache& cache,
+    options::ProgramOption const& options,
+    std::shared_ptr<ConsoleServices> const& console,
+    SharedLibraryProberReport& report);
+
 }
 }
 
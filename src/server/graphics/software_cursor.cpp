@@ -71,6 +71,16 @@ public:
         return 1;
     }
 
+    auto damage_since(mg::BufferID) const -> std::experimental::optional<geom::Rectangles> override
+    {
+        return std::experimental::nullopt;
+    }
+
+    auto opaque_region() const -> geom::Rectangles override
+    {
+        return {};
+    }
+
     mg::Renderable::ID id() const override
     {
         return this;
@@ -177,13 +177,15 @@ mi::BasicSeat::BasicSeat(std::shared_ptr<mi::InputDispatcher> const& dispatcher,
                          std::shared_ptr<Registrar> const& registrar,
                          std::shared_ptr<mi::KeyMapper> const& key_mapper,
                          std::shared_ptr<time::Clock> const& clock,
-                         std::shared_ptr<mi::SeatObserver> const& observer) :
+                         std::shared_ptr<mi::SeatObserver> const& observer,
+                         std::shared_ptr<mi::InputReport> const& report) :
       input_state_tracker{dispatcher,
                           touch_visualizer,
                           cursor_listener,
                           key_mapper,
                           clock,
-                          observer},
+                          observer,
+                          report},
       output_tracker{std::make_shared<OutputTracker>(input_state_tracker)}
 {
     registrar->register_interest(output_tracker);
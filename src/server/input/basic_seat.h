@@ -42,6 +42,7 @@ namespace input
 class TouchVisualizer;
 class CursorListener;
 class InputDispatcher;
+class InputReport;
 class KeyMapper;
 class SeatObserver;
 
@@ -55,7 +56,8 @@ public:
               std::shared_ptr<Registrar> const& registrar,
               std::shared_ptr<KeyMapper> const& key_mapper,
               std::shared_ptr<time::Clock> const& clock,
-              std::shared_ptr<SeatObserver> const& observer);
+              std::shared_ptr<SeatObserver> const& observer,
+              std::shared_ptr<InputReport> const& report);
     // Seat methods:
     void add_device(Device const& device) override;
     void remove_device(Device const& device) override;
@@ -124,7 +124,7 @@ mir::DefaultServerConfiguration::the_surface_input_dispatcher()
     return surface_input_dispatcher(
         [this]()
         {
-            return std::make_shared<mi::SurfaceInputDispatcher>(the_input_scene());
+            return std::make_shared<mi::SurfaceInputDispatcher>(the_input_scene(), the_input_report());
         });
 }
 
@@ -258,7 +258,8 @@ mir::DefaultServerConfiguration::the_input_manager()
                         device_registry,
                         the_console_services(),
                         input_report,
-                        *the_shared_library_prober_report());
+                        *the_shared_library_prober_report(),
+                        *the_platform_probe_cache());
                 }
 
                 return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
@@ -290,7 +291,8 @@ std::shared_ptr<mi::Seat> mir::DefaultServerConfiguration::the_seat()
                     the_display_configuration_observer_registrar(),
                     the_key_mapper(),
                     the_clock(),
-                    the_seat_observer());
+                    the_seat_observer(),
+                    the_input_report());
         });
 }
 
@@ -22,11 +22,14 @@
 #include "mir/options/configuration.h"
 #include "mir/options/option.h"
 
+#include "mir/platform_probe_cache.h"
 #include "mir/shared_library_prober.h"
+#include "mir/shared_library_prober_report.h"
 #include "mir/shared_library.h"
 #include "mir/log.h"
 #include "mir/libname.h"
 
+#include <chrono>
 #include <stdexcept>
 
 namespace mi = mir::input;
@@ -34,6 +37,8 @@ namespace mo = mir::options;
 
 namespace
 {
+char const* const input_role = "input";
+
 mir::UniqueModulePtr<mi::Platform> create_input_platform(
     mir::SharedLibrary const& lib, mir::options::Option const& options,
     std::shared_ptr<mir::EmergencyCleanupRegistry> const& cleanup_registry,
@@ -61,11 +66,26 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
     std::shared_ptr<mir::ConsoleServices> const& console,
     std::shared_ptr<mi::InputReport> const& input_report,
     mir::SharedLibraryProberReport& prober_report)
+{
+    PlatformProbeCache no_cache{{}, {}};
+
+    return probe_input_platforms(
+        options, emergency_cleanup, device_registry, console, input_report, prober_report, no_cache);
+}
+
+mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
+    mo::Option const& options,
+    std::shared_ptr<EmergencyCleanupRegistry> const& emergency_cleanup,
+    std::shared_ptr<mi::InputDeviceRegistry> const& device_registry,
+    std::shared_ptr<mir::ConsoleServices> const& console,
+    std::shared_ptr<mi::InputReport> const& input_report,
+    mir::SharedLibraryProberReport& prober_report,
+    mir::PlatformProbeCache& probe_cache)
 {
     auto reject_platform_priority = mi::PlatformPriority::dummy;
 
     std::shared_ptr<mir::SharedLibrary> platform_module;
-    std::vector<std::string> module_names;
+    PlatformProbeCache::Entry platform_entry{};
 
     auto const module_selector = [&](std::shared_ptr<mir::SharedLibrary> const& module)
         {
@@ -78,6 +98,7 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
                 if (priority > reject_platform_priority)
                 {
                     platform_module = module;
+                    platform_entry = {detail::libname_impl(reinterpret_cast<void*>(probe)), static_cast<int>(priority)};
 
                     return Selection::quit;
                 }
@@ -97,7 +118,35 @@ mir::UniqueModulePtr<mi::Platform> mi::probe_input_platforms(
     }
     else
     {
-        select_libraries_for_path(options.get<std::string>(mo::platform_path), module_selector, prober_report);
+        auto const start = std::chrono::steady_clock::now();
+        auto const path = options.get<std::string>(mo::platform_path);
+
+        if (auto const cached = probe_cache.lookup(input_role))
+        {
+            try
+            {
+                prober_report.loading_cached_library(cached.value().module);
+                module_selector(std::make_shared<mir::SharedLibrary>(cached.value().module));
+            }
+            catch (std::runtime_error const& error)
+            {
+                prober_report.loading_failed(cached.value().module, error);
+            }
+
+            // If it doesn't probe as it did the system has changed in a way the cache can't see
+            if (platform_module && platform_entry.priority != cached.value().priority)
+                platform_module.reset();
+        }
+
+        if (!platform_module)
+        {
+            select_libraries_for_path(path, module_selector, prober_report);
+
+            if (platform_module)
+                probe_cache.store(input_role, platform_entry);
+        }
+
+        prober_report.probing_finished(path, std::chrono::steady_clock::now() - start);
     }
 
     if (!platform_module)
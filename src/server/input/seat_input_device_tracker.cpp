@@ -21,6 +21,7 @@
 #include "mir/input/device.h"
 #include "mir/input/cursor_listener.h"
 #include "mir/input/input_dispatcher.h"
+#include "mir/input/input_report.h"
 #include "mir/input/key_mapper.h"
 #include "mir/input/seat_observer.h"
 #include "mir/geometry/displacement.h"
@@ -46,9 +47,10 @@ mi::SeatInputDeviceTracker::SeatInputDeviceTracker(std::shared_ptr<InputDispatch
                                                    std::shared_ptr<CursorListener> const& cursor_listener,
                                                    std::shared_ptr<KeyMapper> const& key_mapper,
                                                    std::shared_ptr<time::Clock> const& clock,
-                                                   std::shared_ptr<SeatObserver> const& observer)
+                                                   std::shared_ptr<SeatObserver> const& observer,
+                                                   std::shared_ptr<InputReport> const& report)
     : dispatcher{dispatcher}, touch_visualizer{touch_visualizer}, cursor_listener{cursor_listener},
-      key_mapper{key_mapper}, clock{clock}, observer{observer}, buttons{0}
+      key_mapper{key_mapper}, clock{clock}, observer{observer}, report{report}, buttons{0}
 {
 }
 
@@ -105,6 +107,11 @@ void mi::SeatInputDeviceTracker::dispatch(std::shared_ptr<MirEvent> const& event
             mev::set_cursor_position(*event, cursor_x, cursor_y);
             mev::set_button_state(*event, buttons);
         }
+
+        report->input_event_reached(
+            InputEventStage::seat,
+            mir_input_event_get_device_id(input_event),
+            mir_input_event_get_event_time(input_event));
     }
 
     dispatcher->dispatch(event);
@@ -42,6 +42,7 @@ namespace input
 {
 class CursorListener;
 class InputDispatcher;
+class InputReport;
 class KeyMapper;
 class SeatObserver;
 
@@ -60,7 +61,8 @@ public:
                            std::shared_ptr<CursorListener> const& cursor_listener,
                            std::shared_ptr<KeyMapper> const& key_mapper,
                            std::shared_ptr<time::Clock> const& clock,
-                           std::shared_ptr<SeatObserver> const& observer);
+                           std::shared_ptr<SeatObserver> const& observer,
+                           std::shared_ptr<InputReport> const& report);
     void add_device(MirInputDeviceId);
     void remove_device(MirInputDeviceId);
 
@@ -92,6 +94,7 @@ private:
     std::shared_ptr<KeyMapper> const key_mapper;
     std::shared_ptr<time::Clock> const clock;
     std::shared_ptr<SeatObserver> const observer;
+    std::shared_ptr<InputReport> const report;
 
     struct DeviceData
     {
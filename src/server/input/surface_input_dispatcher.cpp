@@ -18,6 +18,7 @@
 
 #include "surface_input_dispatcher.h"
 
+#include "mir/input/input_report.h"
 #include "mir/input/scene.h"
 #include "mir/input/surface.h"
 #include "mir/scene/null_observer.h"
@@ -147,8 +148,11 @@ void deliver(
 
 }
 
-mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> const& scene)
+mi::SurfaceInputDispatcher::SurfaceInputDispatcher(
+    std::shared_ptr<mi::Scene> const& scene,
+    std::shared_ptr<InputReport> const& report)
     : scene(scene),
+      report(report),
       started(false)
 {
     scene_observer = std::make_shared<InputDispatcherSceneObserver>(
@@ -442,12 +446,7 @@ bool is_gesture_terminator(MirPointerEvent const* pev)
 
 std::shared_ptr<mi::Surface> mi::SurfaceInputDispatcher::find_target_surface(geom::Point const& point)
 {
-    std::shared_ptr<mi::Surface> top_target = nullptr;
-    scene->for_each([&top_target, &point](std::shared_ptr<mi::Surface> const& target) {
-            if (target->input_area_contains(point))
-                top_target = target;
-    });
-    return top_target;
+    return scene->input_surface_at(point);
 }
 
 void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surface> const& surface,
@@ -639,19 +638,26 @@ bool mi::SurfaceInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const&
     
     auto iev = mir_event_get_input_event(event.get());
     auto id = mir_input_event_get_device_id(iev);
+    bool delivered;
     switch (mir_input_event_get_type(iev))
     {
     case mir_input_event_type_key:
-        return dispatch_key(event.get());
+        delivered = dispatch_key(event.get());
+        break;
     case mir_input_event_type_touch:
-        return dispatch_touch(id, event.get());
+        delivered = dispatch_touch(id, event.get());
+        break;
     case mir_input_event_type_pointer:
-        return dispatch_pointer(id, event);
+        delivered = dispatch_pointer(id, event);
+        break;
     default:
         BOOST_THROW_EXCEPTION(std::logic_error("InputDispatcher got an input event of unknown type"));
     }
-    
-    return true;
+
+    if (delivered)
+        report->input_event_reached(InputEventStage::surface, id, mir_input_event_get_event_time(iev));
+
+    return delivered;
 }
 
 void mi::SurfaceInputDispatcher::start()
@@ -39,11 +39,12 @@ namespace input
 {
 class Surface;
 class Scene;
+class InputReport;
 
 class SurfaceInputDispatcher : public mir::input::InputDispatcher, public shell::InputTargeter
 {
 public:
-    SurfaceInputDispatcher(std::shared_ptr<input::Scene> const& scene);
+    SurfaceInputDispatcher(std::shared_ptr<input::Scene> const& scene, std::shared_ptr<InputReport> const& report);
     ~SurfaceInputDispatcher();
 
     // mir::input::InputDispatcher
@@ -93,6 +94,7 @@ private:
     TouchInputState& ensure_touch_state(MirInputDeviceId id);
     
     std::shared_ptr<input::Scene> const scene;
+    std::shared_ptr<InputReport> const report;
 
     std::shared_ptr<scene::Observer> scene_observer;
 
@@ -0,0 +1,208 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/platform_probe_cache.h"
+#include "mir/log.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+namespace fs = boost::filesystem;
+
+namespace
+{
+auto sorted_entries(fs::path const& directory) -> std::vector<fs::path>
+{
+    std::vector<fs::path> result;
+
+    boost::system::error_code ec;
+    for (fs::directory_iterator i{directory, ec}, end; !ec && i != end; i.increment(ec))
+        result.push_back(i->path());
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+auto kernel_release() -> std::string
+{
+    utsname name;
+    return uname(&name) == 0 ? name.release : "";
+}
+
+auto starts_with(char const* string, char const* prefix) -> bool
+{
+    return strncmp(string, prefix, strlen(prefix)) == 0;
+}
+
+// FNV-1a: the result has to be the same from one build to the next, which std::hash doesn't promise
+auto hash_of(std::string const& description) -> std::string
+{
+    uint64_t hash = 0xcbf29ce484222325;
+    for (unsigned char const c : description)
+    {
+        hash ^= c;
+        hash *= 0x100000001b3;
+    }
+
+    std::ostringstream result;
+    result << std::hex << hash;
+    return result.str();
+}
+
+// Describes everything that may change what the probes of the modules in platform_path return
+auto fingerprint_of(std::string const& platform_path) -> std::string
+{
+    std::ostringstream description;
+
+    description << "kernel " << kernel_release() << '\n';
+
+    for (auto const& module : sorted_entries(platform_path))
+    {
+        boost::system::error_code ec;
+        auto const size = fs::file_size(module, ec);
+        auto const mtime = fs::last_write_time(module, ec);
+        description << "module " << module.filename().string() << ' ' << size << ' ' << mtime << '\n';
+    }
+
+    // These are the devices udev reports for the subsystems the graphics and input platforms probe
+    for (auto const subsystem : {"/sys/class/drm", "/sys/class/input"})
+    {
+        for (auto const& device : sorted_entries(subsystem))
+        {
+            // The link target locates the device on its bus, so a different device with the same name is noticed
+            boost::system::error_code ec;
+            description << "device " << device.string() << ' ' << fs::read_symlink(device, ec).string() << '\n';
+        }
+    }
+
+    std::vector<std::string> environment;
+    for (auto variable = environ; *variable; ++variable)
+    {
+        if (starts_with(*variable, "MIR_SERVER_") ||
+            starts_with(*variable, "DISPLAY=") ||
+            starts_with(*variable, "WAYLAND_DISPLAY="))
+        {
+            environment.push_back(*variable);
+        }
+    }
+
+    std::sort(environment.begin(), environment.end());
+    for (auto const& variable : environment)
+        description << "environment " << variable << '\n';
+
+    return hash_of(description.str());
+}
+
+auto load(std::string const& filename, std::string const& fingerprint)
+-> std::map<std::string, mir::PlatformProbeCache::Entry>
+{
+    std::map<std::string, mir::PlatformProbeCache::Entry> result;
+
+    if (filename.empty())
+        return result;
+
+    std::ifstream in{filename};
+    std::string line;
+
+    if (!std::getline(in, line) || line != "fingerprint " + fingerprint)
+        return result;
+
+    while (std::getline(in, line))
+    {
+        std::istringstream entry{line};
+        std::string role;
+        int priority;
+        std::string module;
+
+        // The module is the rest of the line, as its path may contain spaces
+        if (entry >> role >> priority && entry.get() == ' ' && std::getline(entry, module) && !module.empty())
+            result[role] = mir::PlatformProbeCache::Entry{module, priority};
+    }
+
+    return result;
+}
+}
+
+mir::PlatformProbeCache::PlatformProbeCache(std::string const& filename, std::string const& platform_path) :
+    filename{filename},
+    fingerprint{filename.empty() ? std::string{} : fingerprint_of(platform_path)},
+    entries{load(filename, fingerprint)}
+{
+}
+
+auto mir::PlatformProbeCache::lookup(std::string const& role) const -> std::experimental::optional<Entry>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const entry = entries.find(role);
+    if (entry == entries.end())
+        return {};
+
+    return entry->second;
+}
+
+void mir::PlatformProbeCache::store(std::string const& role, Entry const& entry)
+{
+    if (filename.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const existing = entries.find(role);
+    if (existing != entries.end() &&
+        existing->second.module == entry.module &&
+        existing->second.priority == entry.priority)
+    {
+        return;
+    }
+
+    entries[role] = entry;
+    save();
+}
+
+void mir::PlatformProbeCache::save() const
+{
+    // Replace the file in one step, so that a crash while writing can't leave half a cache behind
+    auto const temporary = filename + ".new";
+
+    {
+        std::ofstream out{temporary, std::ios::trunc};
+
+        out << "fingerprint " << fingerprint << '\n';
+        for (auto const& entry : entries)
+            out << entry.first << ' ' << entry.second.priority << ' ' << entry.second.module << '\n';
+
+        out.close();
+        if (!out)
+        {
+            log_warning("Failed to write platform probe cache: %s", temporary.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+        log_warning("Failed to write platform probe cache: %s (%s)", filename.c_str(), strerror(errno));
+}
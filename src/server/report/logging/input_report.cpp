@@ -25,14 +25,26 @@
 
 #include <sstream>
 #include <cstring>
+#include <limits>
 #include <mutex>
 
 namespace mrl = mir::report::logging;
 namespace ml = mir::logging;
+namespace mi = mir::input;
 
-mrl::InputReport::InputReport(const std::shared_ptr<ml::Logger>& logger)
-    : logger(logger)
+namespace
+{
+int64_t const unclaimed = std::numeric_limits<int64_t>::min();
+std::chrono::seconds const report_interval{10};
+}
+
+mrl::InputReport::InputReport(std::shared_ptr<ml::Logger> const& logger, std::shared_ptr<time::Clock> const& clock)
+    : logger(logger),
+      clock(clock),
+      next_report((clock->now() + report_interval).time_since_epoch().count())
 {
+    for (auto& device : devices)
+        device.device_id = unclaimed;
 }
 
 const char* mrl::InputReport::component()
@@ -173,3 +185,114 @@ void mrl::InputReport::failed_to_open_input_device(char const* device_name, char
 
     logger->log(ml::Severity::informational, ss.str(), component());
 }
+
+void mrl::InputReport::input_event_reached(mi::InputEventStage stage, int64_t device_id, int64_t event_time)
+{
+    auto const now = clock->now();
+    auto const latency = now.time_since_epoch() - std::chrono::nanoseconds{event_time};
+
+    if (auto const device = slot_for(device_id, now))
+        device->stages[static_cast<size_t>(stage)].record(latency);
+
+    auto due = next_report.load(std::memory_order_relaxed);
+    if (now.time_since_epoch().count() >= due &&
+        next_report.compare_exchange_strong(
+            due,
+            (now + report_interval).time_since_epoch().count(),
+            std::memory_order_relaxed))
+    {
+        log_latencies();
+    }
+}
+
+auto mrl::InputReport::slot_for(int64_t device_id, time::Timestamp now) -> DeviceLatency*
+{
+    auto const now_count = now.time_since_epoch().count();
+    DeviceLatency* least_recent{nullptr};
+    time::Timestamp::rep least_recent_use{0};
+
+    for (auto& device : devices)
+    {
+        auto id = device.device_id.load(std::memory_order_acquire);
+
+        if (id == unclaimed && device.device_id.compare_exchange_strong(id, device_id, std::memory_order_acq_rel))
+            id = device_id;
+
+        if (id == device_id)
+        {
+            device.last_used.store(now_count, std::memory_order_relaxed);
+            return &device;
+        }
+
+        auto const last_used = device.last_used.load(std::memory_order_relaxed);
+        if (!least_recent || last_used < least_recent_use)
+        {
+            least_recent = &device;
+            least_recent_use = last_used;
+        }
+    }
+
+    // Devices get a new id each time they are plugged in, so one that has been idle for a
+    // whole report interval has most likely gone: reuse its slot
+    auto const idle = std::chrono::duration_cast<time::Timestamp::duration>(report_interval).count();
+    if (now_count - least_recent_use >= idle)
+    {
+        if (least_recent->last_used.compare_exchange_strong(least_recent_use, now_count, std::memory_order_relaxed))
+        {
+            for (auto& stage : least_recent->stages)
+                stage.take();
+
+            least_recent->device_id.store(device_id, std::memory_order_release);
+            return least_recent;
+        }
+
+        return nullptr;
+    }
+
+    if (!reported_devices_full.exchange(true, std::memory_order_relaxed))
+    {
+        std::stringstream ss;
+
+        ss << "More than " << max_devices << " input devices are in use; "
+           << "latency is not reported for some of them (e.g. device " << device_id << ")";
+
+        logger->log(ml::Severity::warning, ss.str(), component());
+    }
+
+    return nullptr;
+}
+
+void mrl::InputReport::log_latencies()
+{
+    static char const* const stage_names[] = {"platform", "seat", "surface", "client"};
+
+    for (auto& device : devices)
+    {
+        auto const id = device.device_id.load(std::memory_order_acquire);
+        if (id == unclaimed)
+            break;
+
+        std::array<LatencyHistogram::Snapshot, 4> snapshots;
+        for (size_t i = 0; i != snapshots.size(); ++i)
+            snapshots[i] = device.stages[i].take();
+
+        auto const events = snapshots[static_cast<size_t>(mi::InputEventStage::platform)].count();
+        if (events == 0)
+            continue;
+
+        std::stringstream ss;
+
+        ss << "Device " << id << " input latency over " << events << " events:";
+
+        for (size_t i = 0; i != snapshots.size(); ++i)
+        {
+            auto const to_ms = [](std::chrono::microseconds us) { return us.count() / 1000.0; };
+
+            ss << (i ? ", " : " ") << stage_names[i]
+               << " p50 " << to_ms(snapshots[i].percentile(50)) << "ms"
+               << " p99 " << to_ms(snapshots[i].percentile(99)) << "ms";
+        }
+
+        logger->log(ml::Severity::informational, ss.str(), component());
+    }
+}
@@ -19,8 +19,13 @@
 #ifndef MIR_REPORT_LOGGING_INPUT_REPORT_H_
 #define MIR_REPORT_LOGGING_INPUT_REPORT_H_
 
+#include "latency_histogram.h"
+
 #include "mir/input/input_report.h"
+#include "mir/time/clock.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
 
 namespace mir
@@ -37,7 +42,7 @@ namespace logging
 class InputReport : public input::InputReport
 {
 public:
-    InputReport(std::shared_ptr<mir::logging::Logger> const& logger);
+    InputReport(std::shared_ptr<mir::logging::Logger> const& logger, std::shared_ptr<time::Clock> const& clock);
     virtual ~InputReport() noexcept(true) = default;
 
     void received_event_from_kernel(int64_t when, int type, int code, int value) override;
@@ -47,9 +52,31 @@ public:
 
     void opened_input_device(char const* device_name, char const* input_platform) override;
     void failed_to_open_input_device(char const* device_name, char const* input_platform) override;
+
+    void input_event_reached(input::InputEventStage stage, int64_t device_id, int64_t event_time) override;
 private:
+    struct DeviceLatency;
+
     char const* component();
+    auto slot_for(int64_t device_id, time::Timestamp now) -> DeviceLatency*;
+    void log_latencies();
+
     std::shared_ptr<mir::logging::Logger> const logger;
+    std::shared_ptr<time::Clock> const clock;
+
+    // Latencies are recorded from the input, compositor and Wayland threads, so
+    // each device claims a fixed slot rather than taking a lock
+    struct DeviceLatency
+    {
+        std::atomic<int64_t> device_id;
+        std::atomic<time::Timestamp::rep> last_used{0};
+        std::array<LatencyHistogram, 4> stages;
+    };
+    static int const max_devices = 16;
+    std::array<DeviceLatency, max_devices> devices;
+    std::atomic<bool> reported_devices_full{false};
+
+    std::atomic<time::Timestamp::rep> next_report;
 };
 
 }
@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mrl = mir::report::logging;
+
+namespace
+{
+int const sub_bucket_bits = 4;
+static_assert(1 << sub_bucket_bits == mrl::LatencyHistogram::sub_buckets, "sub_bucket_bits doesn't match");
+
+auto bucket_for(uint64_t us) -> int
+{
+    uint64_t const max_us = (uint64_t{1} << mrl::LatencyHistogram::max_exponent) - 1;
+    if (us > max_us)
+        us = max_us;
+
+    if (us < mrl::LatencyHistogram::sub_buckets)
+        return us;
+
+    auto const exponent = 63 - __builtin_clzll(us);
+    auto const shift = exponent - sub_bucket_bits;
+    auto const sub_bucket = (us >> shift) & (mrl::LatencyHistogram::sub_buckets - 1);
+
+    return (shift + 1) * mrl::LatencyHistogram::sub_buckets + sub_bucket;
+}
+
+auto upper_bound_of(int bucket) -> uint64_t
+{
+    if (bucket < mrl::LatencyHistogram::sub_buckets)
+        return bucket;
+
+    auto const shift = bucket / mrl::LatencyHistogram::sub_buckets - 1;
+    auto const sub_bucket = bucket % mrl::LatencyHistogram::sub_buckets;
+    auto const lower = uint64_t(mrl::LatencyHistogram::sub_buckets + sub_bucket) << shift;
+
+    return lower + (uint64_t{1} << shift) - 1;
+}
+}
+
+void mrl::LatencyHistogram::record(std::chrono::nanoseconds latency)
+{
+    auto const us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+    counts[bucket_for(us < 0 ? 0 : us)].fetch_add(1, std::memory_order_relaxed);
+}
+
+auto mrl::LatencyHistogram::take() -> Snapshot
+{
+    Snapshot snapshot;
+
+    for (int i = 0; i != buckets; ++i)
+        snapshot.counts[i] = counts[i].exchange(0, std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+auto mrl::LatencyHistogram::Snapshot::count() const -> uint64_t
+{
+    uint64_t total = 0;
+
+    for (auto const n : counts)
+        total += n;
+
+    return total;
+}
+
+auto mrl::LatencyHistogram::Snapshot::percentile(double percent) const -> std::chrono::microseconds
+{
+    auto const total = count();
+    if (total == 0)
+        return std::chrono::microseconds{0};
+
+    auto const wanted = std::max<uint64_t>(std::ceil(total * percent / 100.0), 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i != buckets; ++i)
+    {
+        seen += counts[i];
+        if (seen >= wanted)
+            return std::chrono::microseconds(upper_bound_of(i));
+    }
+
+    return std::chrono::microseconds(upper_bound_of(buckets - 1));
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_LOGGING_LATENCY_HISTOGRAM_H_
+#define MIR_REPORT_LOGGING_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mir
+{
+namespace report
+{
+namespace logging
+{
+
+/// A histogram of latencies that can be recorded from any thread without locking or allocating.
+///
+/// Latencies are counted in microseconds, in buckets that are exact below 16us and then split
+/// each power of two into 16, so percentiles are accurate to within 1/16th (up to about a minute).
+class LatencyHistogram
+{
+public:
+    static int const sub_buckets = 16;
+    static int const max_exponent = 26;
+    static int const buckets = sub_buckets * (max_exponent - 3);
+
+    class Snapshot
+    {
+    public:
+        auto count() const -> uint64_t;
+
+        /// The latency no greater than \a percent of those recorded (rounded up to its bucket)
+        auto percentile(double percent) const -> std::chrono::microseconds;
+
+    private:
+        friend class LatencyHistogram;
+        std::array<uint32_t, buckets> counts{};
+    };
+
+    void record(std::chrono::nanoseconds latency);
+
+    /// The latencies recorded since the last take()
+    auto take() -> Snapshot;
+
+private:
+    std::array<std::atomic<uint32_t>, buckets> counts{};
+};
+
+}
+}
+}
+
+#endif /* MIR_REPORT_LOGGING_LATENCY_HISTOGRAM_H_ */
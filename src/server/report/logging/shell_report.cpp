@@ -24,6 +24,8 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <sstream>
+
 using mir::scene::Session;
 using mir::scene::Surface;
 
@@ -153,3 +155,13 @@ void mrl::ShellReport::surfaces_raised(shell::SurfaceSet const& surfaces)
 {
     log->log(Severity::informational, "Raising " + boost::lexical_cast<std::string>(surfaces.size()) + " surfaces", component);
 }
+
+void mrl::ShellReport::window_manager_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times)
+{
+    std::ostringstream out;
+
+    out << "Window manager lock contended: waited "
+        << std::chrono::duration_cast<std::chrono::microseconds>(wait).count() << "us (" << times << " times in all)";
+
+    log->log(Severity::informational, out.str(), component);
+}
@@ -75,6 +75,8 @@ public:
 
     void surfaces_raised(shell::SurfaceSet const& surfaces) override;
 
+    void window_manager_lock_contended(std::chrono::steady_clock::duration wait, uint64_t times) override;
+
 private:
     std::shared_ptr<mir::logging::Logger> const log;
 };
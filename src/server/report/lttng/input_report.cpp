@@ -48,3 +48,9 @@ void mir::report::lttng::InputReport::failed_to_open_input_device(char const* na
 {
     mir_tracepoint(mir_server_input, failed_to_open_input_device, name, platform);
 }
+
+void mir::report::lttng::InputReport::input_event_reached(
+    input::InputEventStage stage, int64_t device_id, int64_t event_time)
+{
+    mir_tracepoint(mir_server_input, input_event_reached, static_cast<int>(stage), device_id, event_time);
+}
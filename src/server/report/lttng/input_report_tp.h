@@ -88,6 +88,17 @@ TRACEPOINT_EVENT_INSTANCE(
     TP_ARGS(const char*, device, const char*, platform)
 )
 
+TRACEPOINT_EVENT(
+    mir_server_input,
+    input_event_reached,
+    TP_ARGS(int, stage, int64_t, device_id, int64_t, event_time),
+    TP_FIELDS(
+        ctf_integer(int, stage, stage)
+        ctf_integer(int64_t, device_id, device_id)
+        ctf_integer(int64_t, event_time, event_time)
+    )
+)
+
 #endif /* MIR_LTTNG_DISPLAY_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
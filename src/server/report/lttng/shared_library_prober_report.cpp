@@ -50,3 +50,16 @@ void mrl::SharedLibraryProberReport::loading_failed(bf::path const& filename, st
     mir_tracepoint(mir_server_shared_library_prober, loading_failed,
                    filename.string().c_str(), error.what());
 }
+
+void mrl::SharedLibraryProberReport::loading_cached_library(bf::path const& filename)
+{
+    mir_tracepoint(mir_server_shared_library_prober, loading_cached_library,
+                   filename.string().c_str());
+}
+
+void mrl::SharedLibraryProberReport::probing_finished(bf::path const& path, std::chrono::steady_clock::duration elapsed)
+{
+    mir_tracepoint(mir_server_shared_library_prober, probing_finished,
+                   path.string().c_str(),
+                   std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
@@ -65,6 +65,25 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_shared_library_prober,
+    loading_cached_library,
+    TP_ARGS(const char*, path),
+    TP_FIELDS(
+        ctf_string(path, path)
+    )
+)
+
+TRACEPOINT_EVENT(
+    mir_server_shared_library_prober,
+    probing_finished,
+    TP_ARGS(const char*, path, uint64_t, elapsed_us),
+    TP_FIELDS(
+        ctf_string(path, path)
+        ctf_integer(uint64_t, elapsed_us, elapsed_us)
+    )
+)
+
 #endif /* MIR_LTTNG_SHARED_LIBRARY_PROBER_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
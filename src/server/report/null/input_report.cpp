@@ -39,3 +39,8 @@ void mrn::InputReport::opened_input_device(char const* /* name */, char const* /
 void mrn::InputReport::failed_to_open_input_device(char const* /* name */, char const* /* platform */)
 {
 }
+
+void mrn::InputReport::input_event_reached(
+    mir::input::InputEventStage /* stage */, int64_t /* device_id */, int64_t /* event_time */)
+{
+}
@@ -42,6 +42,8 @@ public:
 
     void opened_input_device(char const* device_name, char const* input_platform) override;
     void failed_to_open_input_device(char const* device_name, char const* input_platform) override;
+
+    void input_event_reached(input::InputEventStage stage, int64_t device_id, int64_t event_time) override;
 };
 
 }
@@ -88,3 +88,7 @@ void mrn::ShellReport::input_focus_set_to(
 void mrn::ShellReport::surfaces_raised(shell::SurfaceSet const& /*surfaces*/)
 {
 }
+
+void mrn::ShellReport::window_manager_lock_contended(std::chrono::steady_clock::duration /*wait*/, uint64_t /*times*/)
+{
+}
@@ -71,6 +71,8 @@ class ShellReport : public shell::ShellReport
         scene::Surface const* /*focus_surface*/) override;
 
     void surfaces_raised(shell::SurfaceSet const& /*surfaces*/) override;
+
+    void window_manager_lock_contended(std::chrono::steady_clock::duration /*wait*/, uint64_t /*times*/) override;
 };
 }
 }
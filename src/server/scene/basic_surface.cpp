@@ -171,6 +171,21 @@ void ms::SurfaceObservers::application_id_set_to(Surface const* surf, std::strin
                  { observer->application_id_set_to(surf, application_id); });
 }
 
+void ms::SurfaceObservers::input_region_set_to(Surface const* surf, std::vector<geom::Rectangle> const& region)
+{
+    for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
+                 { observer->input_region_set_to(surf, region); });
+}
+
+void ms::SurfaceObservers::stream_frame_posted(
+    Surface const* surf,
+    mc::BufferStream const* stream,
+    geom::Size const& size)
+{
+    for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
+                 { observer->stream_frame_posted(surf, stream, size); });
+}
+
 ms::BasicSurface::ProofOfMutexLock::ProofOfMutexLock(std::unique_lock<std::mutex> const& lock)
 {
     if (!lock.owns_lock())
@@ -283,15 +298,17 @@ ms::BasicSurface::BasicSurface(
     cursor_stream_adapter{std::make_unique<ms::CursorStreamImageAdapter>(*this)},
     session_{session}
 {
-    auto callback = [this, observers=weak(observers)](auto const& size)
-        {
-            if (auto const o = observers.lock())
-                o->frame_posted(this, 1, size);
-        };
-
     for (auto& layer : layers)
     {
-        layer.stream->set_frame_posted_callback(callback);
+        layer.stream->set_frame_posted_callback(
+            [this, observers=weak(observers), stream=layer.stream.get()](auto const& size)
+            {
+                if (auto const o = observers.lock())
+                {
+                    o->stream_frame_posted(this, stream, size);
+                    o->frame_posted(this, 1, size);
+                }
+            });
     }
     report->surface_created(this, surface_name);
 }
@@ -366,8 +383,14 @@ std::shared_ptr<mf::BufferStream> ms::BasicSurface::primary_buffer_stream() cons
 
 void ms::BasicSurface::set_input_region(std::vector<geom::Rectangle> const& input_rectangles)
 {
-    std::lock_guard<std::mutex> lock(guard);
-    custom_input_rectangles = input_rectangles;
+    std::unique_lock<std::mutex> lock(guard);
+    if (custom_input_rectangles != input_rectangles)
+    {
+        custom_input_rectangles = input_rectangles;
+
+        lock.unlock();
+        observers->input_region_set_to(this, input_rectangles);
+    }
 }
 
 void ms::BasicSurface::resize(geom::Size const& desired_size)
@@ -821,6 +844,7 @@ public:
         std::experimental::optional<geom::Rectangle> const& clip_area,
         glm::mat4 const& transform,
         float alpha,
+        geom::Rectangles const& opaque_region,
         mg::Renderable::ID id)
     : underlying_buffer_stream{stream},
       compositor_id{compositor_id},
@@ -828,6 +852,7 @@ public:
       screen_position_(position),
       clip_area_(clip_area),
       transformation_(transform),
+      opaque_region_(opaque_region),
       id_(id)
     {
     }
@@ -865,6 +890,12 @@ public:
 
     mg::Renderable::ID id() const override
     { return id_; }
+
+    auto damage_since(mg::BufferID previous) const -> std::experimental::optional<geom::Rectangles> override
+    { return underlying_buffer_stream->damage_between(previous, buffer()->id()); }
+
+    auto opaque_region() const -> geom::Rectangles override
+    { return opaque_region_; }
 private:
     std::shared_ptr<mc::BufferStream> const underlying_buffer_stream;
     std::shared_ptr<mg::Buffer> mutable compositor_buffer;
@@ -873,6 +904,7 @@ private:
     geom::Rectangle const screen_position_;
     std::experimental::optional<geom::Rectangle> const clip_area_;
     glm::mat4 const transformation_;
+    geom::Rectangles const opaque_region_;
     mg::Renderable::ID const id_;
 };
 }
@@ -921,10 +953,13 @@ void ms::BasicSurface::set_streams(std::list<scene::StreamInfo> const& s)
 
         for(auto& layer : layers)
             layer.stream->set_frame_posted_callback(
-                [this, observers = weak(observers)](auto const& size)
+                [this, observers = weak(observers), stream = layer.stream.get()](auto const& size)
                 {
                     if (auto const o = observers.lock())
+                    {
+                        o->stream_frame_posted(this, stream, size);
                         o->frame_posted(this, 1, size);
+                    }
                 });
         surface_top_left = surface_rect.top_left;
     }
@@ -954,11 +989,27 @@ mg::RenderableList ms::BasicSurface::generate_renderables(mc::CompositorID id) c
             else
                 size = info.stream->stream_size();
 
+            geom::Rectangle const position{content_top_left_ + info.displacement, size};
+
+            // The opaque region is in buffer coordinates, so is only usable when the buffer isn't scaled
+            geom::Rectangles opaque_region;
+            if (!info.size.is_set())
+            {
+                for (auto const& rect : info.opaque_region)
+                {
+                    auto const opaque = geom::Rectangle{
+                        rect.top_left + as_displacement(position.top_left), rect.size}.intersection_with(position);
+
+                    if (opaque.size != geom::Size{})
+                        opaque_region.add(opaque);
+                }
+            }
+
             list.emplace_back(std::make_shared<SurfaceSnapshot>(
                 info.stream, id,
-                geom::Rectangle{content_top_left_ + info.displacement, std::move(size)},
+                position,
                 clip_area_,
-                transformation_matrix, surface_alpha, info.stream.get()));
+                transformation_matrix, surface_alpha, opaque_region, info.stream.get()));
         }
     }
     return list;
@@ -22,16 +22,35 @@
 #include "mir/renderer/gl/texture_source.h"
 
 #include <stdexcept>
+#include <cstdlib>
+#include <cstring>
 #include <boost/throw_exception.hpp>
+#include <EGL/egl.h>
 #include MIR_SERVER_GL_H
 #include MIR_SERVER_GLEXT_H
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
+// GLES 3 names, which the GLES 2 headers we build against don't provide
+struct __GLsync;
+
 namespace
 {
+GLenum const pixel_pack_buffer = 0x88EB;
+GLenum const stream_read = 0x88E1;
+GLbitfield const map_read_bit = 0x0001;
+GLenum const sync_gpu_commands_complete = 0x9117;
+GLbitfield const sync_flush_commands_bit = 0x0001;
+GLenum const wait_failed = 0x911D;
+uint64_t const timeout_ignored = 0xFFFFFFFFFFFFFFFFull;
 
 bool is_big_endian()
 {
@@ -47,11 +66,93 @@ inline uint32_t abgr_to_argb(uint32_t p)
            ((p) & 0xff000000);        /* A remains at same position */
 }
 
+/* Converts a line of abgr_8888 pixels to argb_8888 while copying */
+void copy_abgr_to_argb(uint32_t const* src, uint32_t* dst, uint32_t width)
+{
+    uint32_t n = 0;
+
+#if defined(__SSE2__)
+    __m128i const alpha_green = _mm_set1_epi32(static_cast<int>(0xff00ff00));
+
+    for (; n + 4 <= width; n += 4)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + n));
+        auto const blue_red = _mm_andnot_si128(alpha_green, p);
+        auto const red_blue = _mm_or_si128(_mm_slli_epi32(blue_red, 16), _mm_srli_epi32(blue_red, 16));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n), _mm_or_si128(_mm_and_si128(p, alpha_green), red_blue));
+    }
+#elif defined(__ARM_NEON)
+    for (; n + 16 <= width; n += 16)
+    {
+        auto p = vld4q_u8(reinterpret_cast<uint8_t const*>(src + n));
+        auto const red = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = red;
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + n), p);
+    }
+#endif
+
+    for (; n < width; n++)
+        dst[n] = abgr_to_argb(src[n]);
 }
 
+auto gl_major_version() -> int
+{
+    auto const version = reinterpret_cast<char const*>(glGetString(GL_VERSION));
+    if (!version)
+        return 0;
+
+    char const es_prefix[] = "OpenGL ES ";
+    if (strncmp(version, es_prefix, sizeof es_prefix - 1) == 0)
+        return atoi(version + sizeof es_prefix - 1);
+
+    return atoi(version);
+}
+}
+
+struct ms::GLPixelBuffer::AsyncReadback
+{
+    using MapBufferRange = void* (*)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    using UnmapBuffer = GLboolean (*)(GLenum target);
+    using FenceSync = __GLsync* (*)(GLenum condition, GLbitfield flags);
+    using ClientWaitSync = GLenum (*)(__GLsync* sync, GLbitfield flags, uint64_t timeout);
+    using DeleteSync = void (*)(__GLsync* sync);
+
+    /// Null if the current context can't read back through a pixel buffer object
+    static auto create() -> std::unique_ptr<AsyncReadback>
+    {
+        if (gl_major_version() < 3)
+            return nullptr;
+
+        std::unique_ptr<AsyncReadback> result{new AsyncReadback};
+
+        if (!result->map_buffer_range || !result->unmap_buffer ||
+            !result->fence_sync || !result->client_wait_sync || !result->delete_sync)
+            return nullptr;
+
+        return result;
+    }
+
+    MapBufferRange const map_buffer_range{
+        reinterpret_cast<MapBufferRange>(eglGetProcAddress("glMapBufferRange"))};
+    UnmapBuffer const unmap_buffer{
+        reinterpret_cast<UnmapBuffer>(eglGetProcAddress("glUnmapBuffer"))};
+    FenceSync const fence_sync{
+        reinterpret_cast<FenceSync>(eglGetProcAddress("glFenceSync"))};
+    ClientWaitSync const client_wait_sync{
+        reinterpret_cast<ClientWaitSync>(eglGetProcAddress("glClientWaitSync"))};
+    DeleteSync const delete_sync{
+        reinterpret_cast<DeleteSync>(eglGetProcAddress("glDeleteSync"))};
+
+    GLuint pbo{0};
+    GLsizeiptr pbo_size{0};
+    __GLsync* fence{nullptr};
+};
+
 ms::GLPixelBuffer::GLPixelBuffer(std::unique_ptr<renderer::gl::Context> gl_context)
     : gl_context{std::move(gl_context)},
-      tex{0}, fbo{0}, gl_pixel_format{0}, pixels_need_y_flip{false}
+      tex{0}, fbo{0}, async_readback_probed{false}, gl_pixel_format{0}, pixels_need_conversion{false}
 {
     /*
      * TODO: Handle systems that are big-endian, and therefore GL_BGRA doesn't
@@ -70,19 +171,33 @@ ms::GLPixelBuffer::~GLPixelBuffer() noexcept
      * This may be called from a different thread
      * than the one that called prepare
      */
-    if (tex != 0 || fbo != 0)
+    if (tex != 0 || fbo != 0 || async_readback)
         gl_context->make_current();
 
     if (tex != 0)
         glDeleteTextures(1, &tex);
     if (fbo != 0)
         glDeleteFramebuffers(1, &fbo);
+
+    if (async_readback)
+    {
+        if (async_readback->fence)
+            async_readback->delete_sync(async_readback->fence);
+        if (async_readback->pbo != 0)
+            glDeleteBuffers(1, &async_readback->pbo);
+    }
 }
 
 void ms::GLPixelBuffer::prepare()
 {
     gl_context->make_current();
 
+    if (!async_readback_probed)
+    {
+        async_readback = AsyncReadback::create();
+        async_readback_probed = true;
+    }
+
     if (tex == 0)
         glGenTextures(1, &tex);
 
@@ -99,8 +214,7 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
 {
     auto width = buffer.size().width.as_uint32_t();
     auto height = buffer.size().height.as_uint32_t();
-
-    pixels.resize(width * height * 4);
+    GLsizeiptr const bytes = width * height * 4;
 
     prepare();
 
@@ -113,53 +227,95 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
 
+    size_ = buffer.size();
+
+    if (async_readback)
+    {
+        auto& async = *async_readback;
+
+        if (async.pbo == 0)
+            glGenBuffers(1, &async.pbo);
+
+        glBindBuffer(pixel_pack_buffer, async.pbo);
+
+        if (async.pbo_size < bytes)
+        {
+            glBufferData(pixel_pack_buffer, bytes, nullptr, stream_read);
+            async.pbo_size = bytes;
+        }
+
+        /* With a pixel pack buffer bound the "pixels" are an offset into it */
+        read_pixels(nullptr);
+        glBindBuffer(pixel_pack_buffer, 0);
+
+        if (async.fence)
+            async.delete_sync(async.fence);
+        async.fence = async.fence_sync(sync_gpu_commands_complete, 0);
+
+        glFlush();
+    }
+    else
+    {
+        readback.resize(bytes);
+        read_pixels(readback.data());
+    }
+
+    pixels_need_conversion = true;
+}
+
+void ms::GLPixelBuffer::read_pixels(GLvoid* data)
+{
+    auto const width = size_.width.as_uint32_t();
+    auto const height = size_.height.as_uint32_t();
+
     /* First try to get pixels as BGRA */
     glGetError();
     gl_pixel_format = GL_BGRA_EXT;
-    glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, pixels.data());
+    glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, data);
 
     /* If getting pixels as BGRA failed, fall back to RGBA */
     if (glGetError() != GL_NO_ERROR)
     {
         gl_pixel_format = GL_RGBA;
-        glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, pixels.data());
+        glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, data);
     }
-
-    size_ = buffer.size();
-    pixels_need_y_flip = true;
 }
 
 void const* ms::GLPixelBuffer::as_argb_8888()
 {
-    if (pixels_need_y_flip)
+    if (pixels_need_conversion)
     {
-        auto const stride_val = stride().as_uint32_t();
-        auto const height = size_.height.as_uint32_t();
+        pixels.resize(stride().as_uint32_t() * size_.height.as_uint32_t());
 
-        std::vector<char> tmp(stride_val);
-
-        for (unsigned int i = 0; i < height / 2; i++)
+        if (async_readback)
         {
-            /* Store line i */
-            tmp.assign(&pixels[i * stride_val], &pixels[(i + 1) * stride_val]);
+            auto& async = *async_readback;
 
-            /* Copy line height - i - 1 to line i */
-            copy_and_convert_pixel_line(&pixels[(height - i - 1) * stride_val],
-                                        &pixels[i * stride_val]);
+            gl_context->make_current();
 
-            /* Copy stored line (i) to height - i - 1 */
-            copy_and_convert_pixel_line(tmp.data(),
-                                        &pixels[(height - i - 1) * stride_val]);
-        }
+            if (async.client_wait_sync(async.fence, sync_flush_commands_bit, timeout_ignored) == wait_failed)
+                BOOST_THROW_EXCEPTION(std::runtime_error("Failed to wait for pixels to be read back"));
 
-        /* Process middle line if there is one */
-        if (height % 2 == 1)
+            glBindBuffer(pixel_pack_buffer, async.pbo);
+
+            auto const mapped = async.map_buffer_range(pixel_pack_buffer, 0, pixels.size(), map_read_bit);
+            if (!mapped)
+            {
+                glBindBuffer(pixel_pack_buffer, 0);
+                BOOST_THROW_EXCEPTION(std::runtime_error("Failed to map pixel buffer object"));
+            }
+
+            convert_pixels(mapped);
+
+            async.unmap_buffer(pixel_pack_buffer);
+            glBindBuffer(pixel_pack_buffer, 0);
+        }
+        else
         {
-            copy_and_convert_pixel_line(&pixels[(height / 2) * stride_val],
-                                        &pixels[(height / 2) * stride_val]);
+            convert_pixels(readback.data());
         }
 
-        pixels_need_y_flip = false;
+        pixels_need_conversion = false;
     }
 
     return pixels.data();
@@ -175,20 +331,22 @@ geom::Stride ms::GLPixelBuffer::stride() const
     return geom::Stride{size_.width.as_uint32_t() * sizeof(uint32_t)};
 }
 
-void ms::GLPixelBuffer::copy_and_convert_pixel_line(char* src, char* dst)
+/* Flips the read back pixels (GL has the origin at the bottom left) and converts them to argb_8888 */
+void ms::GLPixelBuffer::convert_pixels(void const* src)
 {
-    if (gl_pixel_format == GL_RGBA)
-    {
-        /* Convert from abgr_8888 to argb_8888 while copying */
-        auto pixels_src = reinterpret_cast<uint32_t*>(src);
-        auto pixels_dst = reinterpret_cast<uint32_t*>(dst);
-        auto const width = size_.width.as_uint32_t();
+    auto const width = size_.width.as_uint32_t();
+    auto const height = size_.height.as_uint32_t();
+    auto const pixels_src = static_cast<uint32_t const*>(src);
+    auto const pixels_dst = reinterpret_cast<uint32_t*>(pixels.data());
 
-        for (uint32_t n = 0; n < width; n++)
-            pixels_dst[n] = abgr_to_argb(pixels_src[n]);
-    }
-    else if (src != dst)
+    for (uint32_t line = 0; line < height; line++)
     {
-        std::copy(src, src + stride().as_uint32_t(), dst);
+        auto const line_src = pixels_src + (height - line - 1) * width;
+        auto const line_dst = pixels_dst + line * width;
+
+        if (gl_pixel_format == GL_RGBA)
+            copy_abgr_to_argb(line_src, line_dst, width);
+        else
+            memcpy(line_dst, line_src, width * sizeof(uint32_t));
     }
 }
@@ -42,7 +42,14 @@ class Context;
 
 namespace scene
 {
-/** Extracts the pixels from a graphics::Buffer using GL facilities. */
+/**
+ * Extracts the pixels from a graphics::Buffer using GL facilities.
+ *
+ * Where the GL implementation supports pixel buffer objects and fence syncs
+ * (GLES 3 or GL 3) fill_from() only queues the read back, and as_argb_8888()
+ * waits for it to complete. This keeps the wait out of fill_from(), which is
+ * called with the buffer stream locked against the compositor.
+ */
 class GLPixelBuffer : public PixelBuffer
 {
 public:
@@ -56,14 +63,20 @@ public:
 
 private:
     void prepare();
-    void copy_and_convert_pixel_line(char* src, char* dst);
+    void read_pixels(GLvoid* data);
+    void convert_pixels(void const* src);
+
+    struct AsyncReadback;
 
     std::unique_ptr<renderer::gl::Context> const gl_context;
     GLuint tex;
     GLuint fbo;
+    bool async_readback_probed;
+    std::unique_ptr<AsyncReadback> async_readback;
+    std::vector<char> readback;
     std::vector<char> pixels;
     GLuint gl_pixel_format;
-    bool pixels_need_y_flip;
+    bool pixels_need_conversion;
     geometry::Size size_;
     geometry::Stride stride_;
 };
@@ -0,0 +1,272 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_region_index.h"
+#include "mir/scene/surface.h"
+#include "mir/geometry/rectangles.h"
+
+#include <algorithm>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+
+namespace
+{
+int const cell_size = 256;
+
+// A surface covering more cells than this (e.g. 8192x8192 pixels) is
+// cheaper to check on every query than to file in each cell
+long const max_cells_per_surface = 1024;
+
+int cell_of(int coordinate)
+{
+    // Round towards negative infinity so that negative coordinates work
+    return coordinate >= 0 ? coordinate / cell_size : -((-coordinate - 1) / cell_size) - 1;
+}
+
+auto key_of(int cell_x, int cell_y) -> uint64_t
+{
+    return (uint64_t{static_cast<uint32_t>(cell_x)} << 32) | static_cast<uint32_t>(cell_y);
+}
+
+struct CellRange
+{
+    int first_x, last_x;
+    int first_y, last_y;
+
+    auto count() const -> long
+    {
+        return (long{last_x} - first_x + 1) * (long{last_y} - first_y + 1);
+    }
+};
+
+auto cells_covered_by(geom::Rectangle const& bounds) -> CellRange
+{
+    return {
+        cell_of(bounds.left().as_int()), cell_of(bounds.right().as_int() - 1),
+        cell_of(bounds.top().as_int()), cell_of(bounds.bottom().as_int() - 1)};
+}
+
+bool is_empty(geom::Rectangle const& rect)
+{
+    return rect.size.width.as_int() <= 0 || rect.size.height.as_int() <= 0;
+}
+
+void insert_rank(std::vector<size_t>& ranks, size_t rank)
+{
+    ranks.insert(std::lower_bound(ranks.begin(), ranks.end(), rank), rank);
+}
+
+void erase_rank(std::vector<size_t>& ranks, size_t rank)
+{
+    auto const p = std::lower_bound(ranks.begin(), ranks.end(), rank);
+    if (p != ranks.end() && *p == rank)
+        ranks.erase(p);
+}
+}
+
+void ms::InputRegionIndex::add(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    input_regions[surface] = {};
+    is_stale = true;
+}
+
+void ms::InputRegionIndex::remove(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    input_regions.erase(surface);
+
+    // Drop everything now, so that the index doesn't keep the removed surface alive
+    entries.clear();
+    rank_of.clear();
+    cells.clear();
+    large_surfaces.clear();
+    is_stale = true;
+}
+
+void ms::InputRegionIndex::invalidate()
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    is_stale = true;
+}
+
+bool ms::InputRegionIndex::stale() const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return is_stale;
+}
+
+void ms::InputRegionIndex::rebuild(std::vector<std::shared_ptr<Surface>> const& stacking_order)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    entries.clear();
+    rank_of.clear();
+    cells.clear();
+    large_surfaces.clear();
+
+    entries.reserve(stacking_order.size());
+    for (auto const& surface : stacking_order)
+    {
+        auto const rank = entries.size();
+        entries.push_back(Entry{surface, bounds_of(surface.get()), false});
+        rank_of[surface.get()] = rank;
+        file(rank);
+    }
+
+    is_stale = false;
+}
+
+void ms::InputRegionIndex::update(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    update_locked(surface);
+}
+
+void ms::InputRegionIndex::update(Surface const* surface, std::vector<geom::Rectangle> const& input_region)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const region = input_regions.find(surface);
+    if (region == input_regions.end())
+        return;
+
+    region->second = input_region;
+    update_locked(surface);
+}
+
+auto ms::InputRegionIndex::top_surface_at(geom::Point point) const -> std::shared_ptr<Surface>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    static Ranks const no_ranks;
+    auto const cell = cells.find(key_of(cell_of(point.x.as_int()), cell_of(point.y.as_int())));
+    auto const& in_cell = cell != cells.end() ? cell->second : no_ranks;
+
+    // Walk both candidate lists from the top of the stack down
+    auto from_cell = in_cell.rbegin();
+    auto from_large = large_surfaces.rbegin();
+
+    while (from_cell != in_cell.rend() || from_large != large_surfaces.rend())
+    {
+        size_t rank;
+        if (from_large == large_surfaces.rend() ||
+            (from_cell != in_cell.rend() && *from_cell > *from_large))
+        {
+            rank = *from_cell++;
+        }
+        else
+        {
+            rank = *from_large++;
+        }
+
+        auto const& entry = entries[rank];
+        if (entry.bounds.contains(point) && entry.surface->input_area_contains(point))
+            return entry.surface;
+    }
+
+    return {};
+}
+
+void ms::InputRegionIndex::file(size_t rank)
+{
+    auto& entry = entries[rank];
+
+    if (is_empty(entry.bounds))
+    {
+        entry.spans_many_cells = false;
+        return;
+    }
+
+    auto const range = cells_covered_by(entry.bounds);
+    entry.spans_many_cells = range.count() > max_cells_per_surface;
+
+    if (entry.spans_many_cells)
+    {
+        insert_rank(large_surfaces, rank);
+        return;
+    }
+
+    for (auto x = range.first_x; x <= range.last_x; ++x)
+        for (auto y = range.first_y; y <= range.last_y; ++y)
+            insert_rank(cells[key_of(x, y)], rank);
+}
+
+void ms::InputRegionIndex::unfile(size_t rank)
+{
+    auto const& entry = entries[rank];
+
+    if (is_empty(entry.bounds))
+        return;
+
+    if (entry.spans_many_cells)
+    {
+        erase_rank(large_surfaces, rank);
+        return;
+    }
+
+    auto const range = cells_covered_by(entry.bounds);
+    for (auto x = range.first_x; x <= range.last_x; ++x)
+    {
+        for (auto y = range.first_y; y <= range.last_y; ++y)
+        {
+            auto const cell = cells.find(key_of(x, y));
+            if (cell == cells.end())
+                continue;
+
+            erase_rank(cell->second, rank);
+            if (cell->second.empty())
+                cells.erase(cell);
+        }
+    }
+}
+
+void ms::InputRegionIndex::update_locked(Surface const* surface)
+{
+    // Surfaces not (yet) in the index are picked up by the next rebuild()
+    auto const rank = rank_of.find(surface);
+    if (rank == rank_of.end())
+        return;
+
+    auto const new_bounds = bounds_of(surface);
+    auto& entry = entries[rank->second];
+    if (entry.bounds == new_bounds)
+        return;
+
+    unfile(rank->second);
+    entry.bounds = new_bounds;
+    file(rank->second);
+}
+
+auto ms::InputRegionIndex::bounds_of(Surface const* surface) const -> geom::Rectangle
+{
+    auto const content = surface->input_bounds();
+
+    auto const region = input_regions.find(surface);
+    if (region == input_regions.end() || region->second.empty())
+        return content;
+
+    // Custom input rectangles are relative to the content and not clipped to it
+    geom::Rectangles input_area;
+    for (auto const& rect : region->second)
+    {
+        if (!is_empty(rect))
+            input_area.add({rect.top_left + as_displacement(content.top_left), rect.size});
+    }
+
+    return input_area.bounding_rectangle();
+}
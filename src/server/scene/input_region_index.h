@@ -0,0 +1,102 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_INPUT_REGION_INDEX_H_
+#define MIR_SCENE_INPUT_REGION_INDEX_H_
+
+#include "mir/geometry/rectangle.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/**
+ * A grid over screen space that answers "which is the top-most surface
+ * accepting input at this point?" without visiting every surface.
+ *
+ * Each surface is filed in the grid cells covered by the bounds of its input
+ * region (the content area, or the custom input rectangles when set). Those
+ * bounds are a superset of where the surface accepts input, so candidates
+ * found in a cell are confirmed with Surface::input_area_contains(), which
+ * also accounts for visibility and clipping.
+ *
+ * Geometry changes of a single surface are applied incrementally. Changes to
+ * the stacking order only mark the index stale; it is rebuilt from the
+ * current stacking order on the next query.
+ */
+class InputRegionIndex
+{
+public:
+    /// Start tracking the input region of \a surface (initially the default region)
+    void add(Surface const* surface);
+    /// Stop tracking \a surface. This also marks the index stale.
+    void remove(Surface const* surface);
+
+    /// The stacking order changed; the index needs a rebuild()
+    void invalidate();
+    bool stale() const;
+    /// Index \a stacking_order, which lists surfaces from bottom to top
+    void rebuild(std::vector<std::shared_ptr<Surface>> const& stacking_order);
+
+    /// The position or size of \a surface changed
+    void update(Surface const* surface);
+    /// The custom input region of \a surface changed
+    void update(Surface const* surface, std::vector<geometry::Rectangle> const& input_region);
+
+    auto top_surface_at(geometry::Point point) const -> std::shared_ptr<Surface>;
+
+private:
+    struct Entry
+    {
+        std::shared_ptr<Surface> surface;
+        geometry::Rectangle bounds;
+        bool spans_many_cells;
+    };
+
+    using CellKey = uint64_t;
+    using Ranks = std::vector<size_t>;
+
+    void file(size_t rank);
+    void unfile(size_t rank);
+    void update_locked(Surface const* surface);
+    auto bounds_of(Surface const* surface) const -> geometry::Rectangle;
+
+    std::mutex mutable mutex;
+    bool is_stale{true};
+
+    /// Custom input regions of the tracked surfaces (empty for the default region)
+    std::unordered_map<Surface const*, std::vector<geometry::Rectangle>> input_regions;
+
+    /// Indexed surfaces, bottom to top: the position is the "rank" used below
+    std::vector<Entry> entries;
+    std::unordered_map<Surface const*, size_t> rank_of;
+    /// The ranks of the surfaces in each cell, in ascending order
+    std::unordered_map<CellKey, Ranks> cells;
+    /// Surfaces covering too many cells to file individually, in ascending order
+    Ranks large_surfaces;
+};
+}
+}
+
+#endif /* MIR_SCENE_INPUT_REGION_INDEX_H_ */
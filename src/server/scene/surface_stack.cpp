@@ -41,21 +41,16 @@ namespace mg = mir::graphics;
 namespace mi = mir::input;
 namespace geom = mir::geometry;
 
-namespace
-{
-
-class SurfaceSceneElement : public mc::SceneElement
+class ms::SurfaceSceneElement : public mc::SceneElement
 {
 public:
     SurfaceSceneElement(
-        std::string name,
         std::shared_ptr<mg::Renderable> const& renderable,
         std::shared_ptr<ms::RenderingTracker> const& tracker,
         mc::CompositorID id)
         : renderable_{renderable},
           tracker{tracker},
-          cid{id},
-          surface_name(name)
+          cid{id}
     {
     }
 
@@ -74,13 +69,36 @@ public:
         tracker->occluded_in(cid);
     }
 
+    /// Reuse this element (which the compositor has released) for another renderable
+    void reset(
+        std::shared_ptr<mg::Renderable> const& renderable,
+        std::shared_ptr<ms::RenderingTracker> const& tracker)
+    {
+        renderable_ = renderable;
+        this->tracker = tracker;
+    }
+
+    /// Don't keep the renderable (and the buffer it holds) alive while unused
+    void release()
+    {
+        renderable_.reset();
+        tracker.reset();
+    }
+
 private:
-    std::shared_ptr<mg::Renderable> const renderable_;
-    std::shared_ptr<ms::RenderingTracker> const tracker;
-    mc::CompositorID cid;
-    std::string const surface_name;
+    std::shared_ptr<mg::Renderable> renderable_;
+    std::shared_ptr<ms::RenderingTracker> tracker;
+    mc::CompositorID const cid;
 };
 
+namespace
+{
+bool is_unused(std::shared_ptr<ms::SurfaceSceneElement> const& element)
+{
+    // Only the pool holds it, and nothing else can get hold of it without the pool
+    return element.use_count() == 1;
+}
+
 //note: something different than a 2D/HWC overlay
 class OverlaySceneElement : public mc::SceneElement
 {
@@ -109,12 +127,17 @@ private:
 };
 
 /**
- * A SurfaceDepthLayerObserver must not outlive the SurfaceStack it was created for
+ * A StackedSurfaceObserver must not outlive the SurfaceStack it was created for
  */
-struct SurfaceDepthLayerObserver : ms::NullSurfaceObserver
-{
-    SurfaceDepthLayerObserver(ms::SurfaceStack* stack)
-        : stack{stack}
+struct StackedSurfaceObserver : ms::NullSurfaceObserver
+{
+    StackedSurfaceObserver(
+        ms::SurfaceStack* stack,
+        ms::InputRegionIndex* input_region_index,
+        ms::ViewAreaIndex* view_area_index)
+        : stack{stack},
+          input_region_index{input_region_index},
+          view_area_index{view_area_index}
     {
     }
 
@@ -124,8 +147,46 @@ struct SurfaceDepthLayerObserver : ms::NullSurfaceObserver
         stack->raise(surface);
     }
 
+    void moved_to(ms::Surface const* surface, geom::Point const& /*top_left*/) override
+    {
+        input_region_index->update(surface);
+        view_area_index->invalidate(surface);
+    }
+
+    void content_resized_to(ms::Surface const* surface, geom::Size const& /*content_size*/) override
+    {
+        input_region_index->update(surface);
+        view_area_index->invalidate(surface);
+    }
+
+    void transformation_set_to(ms::Surface const* surface, glm::mat4 const& /*t*/) override
+    {
+        view_area_index->invalidate(surface);
+    }
+
+    void input_region_set_to(ms::Surface const* surface, std::vector<geom::Rectangle> const& region) override
+    {
+        input_region_index->update(surface, region);
+    }
+
+    void stream_frame_posted(
+        ms::Surface const* surface,
+        mc::BufferStream const* stream,
+        geom::Size const& size) override
+    {
+        // Notified before frame_posted(), so the surface is back in view before compositors are woken for it
+        view_area_index->frame_posted(surface, stream, size);
+    }
+
+    void frame_posted(ms::Surface const* surface, int /*frames_available*/, geom::Size const& /*size*/) override
+    {
+        stack->frame_posted_by(surface);
+    }
+
 private:
     ms::SurfaceStack* stack;
+    ms::InputRegionIndex* input_region_index;
+    ms::ViewAreaIndex* view_area_index;
 };
 
 }
@@ -134,7 +195,7 @@ ms::SurfaceStack::SurfaceStack(
     std::shared_ptr<SceneReport> const& report) :
     report{report},
     scene_changed{false},
-    surface_observer{std::make_shared<SurfaceDepthLayerObserver>(this)}
+    surface_observer{std::make_shared<StackedSurfaceObserver>(this, &input_region_index, &view_area_index)}
 {
 }
 
@@ -155,25 +216,72 @@ mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID i
     RecursiveReadLock lg(guard);
 
     scene_changed = false;
+
+    // Only this compositor's thread uses its pool, and the map itself only
+    // changes under the write lock
+    auto const pool = element_pools.find(id);
+    size_t next_in_pool = 0;
+
+    auto const element_for =
+        [&](std::shared_ptr<mg::Renderable> const& renderable, std::shared_ptr<RenderingTracker> const& tracker)
+        -> std::shared_ptr<mc::SceneElement>
+        {
+            if (pool == element_pools.end())
+                return std::make_shared<SurfaceSceneElement>(renderable, tracker, id);
+
+            auto& pooled = pool->second;
+            for (; next_in_pool != pooled.size(); ++next_in_pool)
+            {
+                if (is_unused(pooled[next_in_pool]))
+                {
+                    pooled[next_in_pool]->reset(renderable, tracker);
+                    return pooled[next_in_pool++];
+                }
+            }
+
+            pooled.push_back(std::make_shared<SurfaceSceneElement>(renderable, tracker, id));
+            next_in_pool = pooled.size();
+            return pooled.back();
+        };
+
     mc::SceneElementSequence elements;
+    if (pool != element_pools.end())
+        elements.reserve(pool->second.size());
+
     for (auto const& layer : surface_layers)
     {
         for (auto const& surface : layer)
         {
             if (surface->visible())
             {
-                for (auto& renderable : surface->generate_renderables(id))
+                auto const tracker = rendering_trackers.find(surface.get());
+
+                if (!view_area_index.in_view(surface.get(), id))
                 {
-                    elements.emplace_back(
-                        std::make_shared<SurfaceSceneElement>(
-                            surface->name(),
-                            renderable,
-                            rendering_trackers[surface.get()],
-                            id));
+                    // As the compositor would have found it, so the surface knows it isn't shown here
+                    tracker->second->occluded_in(id);
+                    continue;
                 }
+
+                auto const version = view_area_index.version_of(surface.get());
+                auto const renderables = surface->generate_renderables(id);
+                view_area_index.update(surface.get(), version, renderables);
+
+                for (auto& renderable : renderables)
+                    elements.emplace_back(element_for(renderable, tracker->second));
             }
         }
     }
+
+    if (pool != element_pools.end())
+    {
+        for (auto i = next_in_pool; i != pool->second.size(); ++i)
+        {
+            if (is_unused(pool->second[i]))
+                pool->second[i]->release();
+        }
+    }
+
     for (auto const& renderable : overlays)
     {
         elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
@@ -186,33 +294,88 @@ int ms::SurfaceStack::frames_pending(mc::CompositorID id) const
     RecursiveReadLock lg(guard);
 
     int result = scene_changed ? 1 : 0;
-    for (auto const& layer : surface_layers)
+
+    std::set<Surface const*> candidates;
     {
-        for (auto const& surface : layer)
+        std::lock_guard<std::mutex> lock{pending_guard};
+        auto const maybe = maybe_pending.find(id);
+        if (maybe == maybe_pending.end())
         {
-            if (surface->visible())
+            // Not a registered compositor, so nothing is tracked for it
+            for (auto const& layer : surface_layers)
             {
-                auto const tracker = rendering_trackers.find(surface.get());
-                if (tracker != rendering_trackers.end() && tracker->second->is_exposed_in(id))
+                for (auto const& surface : layer)
                 {
-                    // Note that we ask the surface and not a Renderable.
-                    // This is because we don't want to waste time and resources
-                    // on a snapshot till we're sure we need it...
-                    int ready = surface->buffers_ready_for_compositor(id);
-                    if (ready > result)
-                        result = ready;
+                    if (is_exposed_in(surface.get(), id))
+                        result = std::max(result, surface->buffers_ready_for_compositor(id));
                 }
             }
+
+            return result;
+        }
+
+        // Any frame posted while we look at these puts the surface back
+        candidates.swap(maybe->second);
+    }
+
+    std::vector<Surface const*> still_pending;
+    for (auto const surface : candidates)
+    {
+        // A hidden or occluded surface may be exposed later with frames still ready
+        if (!is_exposed_in(surface, id))
+        {
+            still_pending.push_back(surface);
+            continue;
+        }
+
+        // Note that we ask the surface and not a Renderable.
+        // This is because we don't want to waste time and resources
+        // on a snapshot till we're sure we need it...
+        auto const ready = surface->buffers_ready_for_compositor(id);
+        if (ready > 0)
+        {
+            result = std::max(result, ready);
+            still_pending.push_back(surface);
         }
     }
+
+    std::lock_guard<std::mutex> lock{pending_guard};
+    maybe_pending[id].insert(still_pending.begin(), still_pending.end());
+
     return result;
 }
 
+bool ms::SurfaceStack::is_exposed_in(Surface const* surface, mc::CompositorID id) const
+{
+    if (!surface->visible())
+        return false;
+
+    auto const tracker = rendering_trackers.find(const_cast<Surface*>(surface));
+    return tracker != rendering_trackers.end() && tracker->second->is_exposed_in(id);
+}
+
+void ms::SurfaceStack::frame_posted_by(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{pending_guard};
+
+    // The notification may race with the surface's removal
+    if (!known_surfaces.count(surface))
+        return;
+
+    for (auto& pending : maybe_pending)
+        pending.second.insert(surface);
+}
+
 void ms::SurfaceStack::register_compositor(mc::CompositorID cid)
 {
     RecursiveWriteLock lg(guard);
 
     registered_compositors.insert(cid);
+    element_pools[cid];
+    {
+        std::lock_guard<std::mutex> lock{pending_guard};
+        maybe_pending[cid] = known_surfaces;
+    }
 
     update_rendering_tracker_compositors();
 }
@@ -222,10 +385,25 @@ void ms::SurfaceStack::unregister_compositor(mc::CompositorID cid)
     RecursiveWriteLock lg(guard);
 
     registered_compositors.erase(cid);
+    element_pools.erase(cid);
+    view_area_index.remove_view_area(cid);
+    {
+        std::lock_guard<std::mutex> lock{pending_guard};
+        maybe_pending.erase(cid);
+    }
 
     update_rendering_tracker_compositors();
 }
 
+void ms::SurfaceStack::set_view_area(mc::CompositorID cid, geom::Rectangle const& view_area)
+{
+    RecursiveWriteLock lg(guard);
+
+    // Only registered compositors are told which surfaces they aren't shown
+    if (registered_compositors.count(cid))
+        view_area_index.set_view_area(cid, view_area);
+}
+
 void ms::SurfaceStack::add_input_visualization(
     std::shared_ptr<mg::Renderable> const& overlay)
 {
@@ -270,6 +448,15 @@ void ms::SurfaceStack::add_surface(
         RecursiveWriteLock lg(guard);
         insert_surface_at_top_of_depth_layer(surface);
         create_rendering_tracker_for(surface);
+        input_region_index.add(surface.get());
+        view_area_index.add(surface.get());
+        {
+            // It may have posted frames before it was added
+            std::lock_guard<std::mutex> lock{pending_guard};
+            known_surfaces.insert(surface.get());
+            for (auto& pending : maybe_pending)
+                pending.second.insert(surface.get());
+        }
         surface->add_observer(surface_observer);
     }
     surface->set_reception_mode(input_mode);
@@ -294,6 +481,22 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
             {
                 layer.erase(surface);
                 rendering_trackers.erase(keep_alive.get());
+                input_region_index.remove(keep_alive.get());
+                view_area_index.remove(keep_alive.get());
+                {
+                    std::lock_guard<std::mutex> lock{pending_guard};
+                    known_surfaces.erase(keep_alive.get());
+                    for (auto& pending : maybe_pending)
+                        pending.second.erase(keep_alive.get());
+                }
+                for (auto& pool : element_pools)
+                {
+                    for (auto const& element : pool.second)
+                    {
+                        if (is_unused(element))
+                            element->release();
+                    }
+                }
                 keep_alive->remove_observer(surface_observer);
                 found_surface = true;
                 break;
@@ -309,37 +512,37 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
     // TODO: error logging when surface not found
 }
 
-namespace
+auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
+-> std::shared_ptr<Surface>
 {
-template <typename Container>
-struct InReverse {
-    Container& container;
-    auto begin() -> decltype(container.rbegin()) { return container.rbegin(); }
-    auto end() -> decltype(container.rend()) { return container.rend(); }
-};
+    // TODO There's a lack of clarity about how the input area will
+    // TODO be maintained and whether this test will detect clicks on
+    // TODO decorations (it should) as these may be outside the area
+    // TODO known to the client.  But it works for now.
+    return indexed_surface_at(cursor);
+}
 
-template <typename Container>
-InReverse<Container> in_reverse(Container& container) { return InReverse<Container>{container}; }
+auto ms::SurfaceStack::input_surface_at(geometry::Point point) -> std::shared_ptr<mi::Surface>
+{
+    return indexed_surface_at(point);
 }
 
-auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
--> std::shared_ptr<Surface>
+auto ms::SurfaceStack::indexed_surface_at(geometry::Point point) const -> std::shared_ptr<Surface>
 {
     RecursiveReadLock lg(guard);
-    for (auto const& layer : in_reverse(surface_layers))
+
+    // The stacking order can't change while we hold the lock, so a rebuilt
+    // index stays valid for this query
+    if (input_region_index.stale())
     {
-        for (auto const& surface : in_reverse(layer))
-        {
-            // TODO There's a lack of clarity about how the input area will
-            // TODO be maintained and whether this test will detect clicks on
-            // TODO decorations (it should) as these may be outside the area
-            // TODO known to the client.  But it works for now.
-            if (surface->input_area_contains(cursor))
-                    return surface;
-        }
+        std::vector<std::shared_ptr<Surface>> stacking_order;
+        for (auto const& layer : surface_layers)
+            stacking_order.insert(stacking_order.end(), layer.begin(), layer.end());
+
+        input_region_index.rebuild(stacking_order);
     }
 
-    return {};
+    return input_region_index.top_surface_at(point);
 }
 
 void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& callback)
@@ -375,6 +578,7 @@ void ms::SurfaceStack::raise(Surface const* surface)
                 std::shared_ptr<Surface> surface_shared = *p;
                 layer.erase(p);
                 insert_surface_at_top_of_depth_layer(surface_shared);
+                input_region_index.invalidate();
                 surfaces_reordered = true;
                 break;
             }
@@ -421,6 +625,9 @@ void ms::SurfaceStack::raise(SurfaceSet const& ss)
             if (old_layer != layer)
                 surfaces_reordered = true;
         }
+
+        if (surfaces_reordered)
+            input_region_index.invalidate();
     }
 
     if (surfaces_reordered)
@@ -26,6 +26,8 @@
 #include "mir/scene/observer.h"
 #include "mir/input/scene.h"
 #include "mir/recursive_read_write_mutex.h"
+#include "input_region_index.h"
+#include "view_area_index.h"
 
 #include "mir/basic_observers.h"
 #include "mir/scene/surface_observer.h"
@@ -50,6 +52,7 @@ namespace scene
 class BasicSurface;
 class SceneReport;
 class RenderingTracker;
+class SurfaceSceneElement;
 
 class Observers : public Observer, BasicObservers<Observer>
 {
@@ -82,13 +85,17 @@ public:
     int frames_pending(compositor::CompositorID) const override;
     void register_compositor(compositor::CompositorID id) override;
     void unregister_compositor(compositor::CompositorID id) override;
+    void set_view_area(compositor::CompositorID id, geometry::Rectangle const& view_area) override;
 
     // From Scene
     void for_each(std::function<void(std::shared_ptr<input::Surface> const&)> const& callback) override;
+    auto input_surface_at(geometry::Point point) -> std::shared_ptr<input::Surface> override;
 
     virtual void remove_surface(std::weak_ptr<Surface> const& surface) override;
 
     void raise(Surface const* surface);
+    /// Note that \a surface may have frames ready for the compositors
+    void frame_posted_by(Surface const* surface);
     virtual void raise(std::weak_ptr<Surface> const& surface) override;
     void raise(SurfaceSet const& surfaces) override;
 
@@ -113,6 +120,8 @@ private:
     void create_rendering_tracker_for(std::shared_ptr<Surface> const&);
     void update_rendering_tracker_compositors();
     void insert_surface_at_top_of_depth_layer(std::shared_ptr<Surface> const& surface);
+    auto indexed_surface_at(geometry::Point point) const -> std::shared_ptr<Surface>;
+    bool is_exposed_in(Surface const* surface, compositor::CompositorID id) const;
 
     RecursiveReadWriteMutex mutable guard;
 
@@ -128,9 +137,29 @@ private:
     std::vector<std::vector<std::shared_ptr<Surface>>> surface_layers;
     std::map<Surface*,std::shared_ptr<RenderingTracker>> rendering_trackers;
     std::set<compositor::CompositorID> registered_compositors;
+
+    /// Scene elements handed out to each registered compositor, reused once it releases them
+    std::map<compositor::CompositorID, std::vector<std::shared_ptr<SurfaceSceneElement>>> element_pools;
+
+    /**
+     * Surfaces that may have frames pending for each registered compositor
+     *
+     * A surface's pending frames only increase when it posts a frame, so
+     * frames_pending() only needs to look at the surfaces that have posted
+     * since they were last found to have none.
+     */
+    std::mutex mutable pending_guard;
+    std::set<Surface const*> known_surfaces;
+    std::map<compositor::CompositorID, std::set<Surface const*>> mutable maybe_pending;
     
     std::vector<std::shared_ptr<graphics::Renderable>> overlays;
 
+    /// Kept up to date with surface geometry through surface_observer
+    InputRegionIndex mutable input_region_index;
+    /// Which surfaces each compositor may draw, learnt in scene_elements_for() and
+    /// forgotten through surface_observer
+    ViewAreaIndex view_area_index;
+
     Observers observers;
     std::atomic<bool> scene_changed;
     std::shared_ptr<SurfaceObserver> surface_observer;
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "view_area_index.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ms = mir::scene;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+// The bounds of the renderables, if they can be known from their screen positions
+auto extents_of(mg::RenderableList const& renderables) -> std::experimental::optional<geom::Rectangle>
+{
+    static glm::mat4 const identity(1);
+
+    // A surface drawing nothing now may draw anywhere without moving (e.g. once it's no longer clipped)
+    if (renderables.empty())
+        return {};
+
+    auto left = std::numeric_limits<int>::max();
+    auto top = std::numeric_limits<int>::max();
+    auto right = std::numeric_limits<int>::min();
+    auto bottom = std::numeric_limits<int>::min();
+
+    for (auto const& renderable : renderables)
+    {
+        if (renderable->transformation() != identity)
+            return {};
+
+        auto const position = renderable->screen_position();
+        left = std::min(left, position.left().as_int());
+        top = std::min(top, position.top().as_int());
+        right = std::max(right, position.right().as_int());
+        bottom = std::max(bottom, position.bottom().as_int());
+    }
+
+    return geom::Rectangle{{left, top}, {right - left, bottom - top}};
+}
+}
+
+void ms::ViewAreaIndex::set_view_area(mc::CompositorID id, geom::Rectangle const& view_area)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto& view = views[id];
+    view.area = view_area;
+    view.surfaces.clear();
+
+    for (auto const& entry : entries)
+    {
+        if (may_draw_in(entry.second, view))
+            view.surfaces.insert(entry.first);
+    }
+}
+
+void ms::ViewAreaIndex::remove_view_area(mc::CompositorID id)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    views.erase(id);
+}
+
+void ms::ViewAreaIndex::add(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    refile(surface, entries[surface] = Entry{});
+}
+
+void ms::ViewAreaIndex::remove(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    entries.erase(surface);
+    for (auto& view : views)
+        view.second.surfaces.erase(surface);
+}
+
+auto ms::ViewAreaIndex::version_of(Surface const* surface) const -> uint64_t
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const entry = entries.find(surface);
+    return entry != entries.end() ? entry->second.version : 0;
+}
+
+void ms::ViewAreaIndex::update(Surface const* surface, uint64_t version, mg::RenderableList const& renderables)
+{
+    auto const extents = extents_of(renderables);
+
+    std::lock_guard<std::mutex> lock{mutex};
+
+    // The update may race with the surface's removal, or with a change to it
+    auto const entry = entries.find(surface);
+    if (entry == entries.end() || entry->second.version != version)
+        return;
+
+    auto& drawn = entry->second.drawn;
+    bool const same_drawn =
+        drawn.size() == renderables.size() &&
+        std::equal(drawn.begin(), drawn.end(), renderables.begin(),
+            [](std::pair<mg::Renderable::ID, geom::Size> const& drawn, std::shared_ptr<mg::Renderable> const& renderable)
+            {
+                return drawn.first == renderable->id() && drawn.second == renderable->screen_position().size;
+            });
+
+    if (same_drawn && entry->second.extents == extents)
+        return;
+
+    drawn.clear();
+    for (auto const& renderable : renderables)
+        drawn.emplace_back(renderable->id(), renderable->screen_position().size);
+
+    entry->second.extents = extents;
+    refile(surface, entry->second);
+}
+
+void ms::ViewAreaIndex::invalidate(Surface const* surface)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const entry = entries.find(surface);
+    if (entry != entries.end())
+        forget_extents(surface, entry->second);
+}
+
+void ms::ViewAreaIndex::frame_posted(Surface const* surface, mg::Renderable::ID stream, geom::Size const& size)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const entry = entries.find(surface);
+    if (entry == entries.end())
+        return;
+
+    // A frame of the size the stream is already drawn at can't change the extents. The stream's first frame,
+    // or one of a new size, might (even if another of the surface's streams is drawn at that size).
+    auto const& drawn = entry->second.drawn;
+    if (entry->second.extents && std::find(drawn.begin(), drawn.end(), std::make_pair(stream, size)) != drawn.end())
+        return;
+
+    forget_extents(surface, entry->second);
+}
+
+bool ms::ViewAreaIndex::in_view(Surface const* surface, mc::CompositorID id) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto const view = views.find(id);
+    if (view == views.end() || !entries.count(surface))
+        return true;
+
+    return view->second.surfaces.count(surface) != 0;
+}
+
+void ms::ViewAreaIndex::forget_extents(Surface const* surface, Entry& entry)
+{
+    ++entry.version;
+
+    if (entry.extents)
+    {
+        entry.extents = {};
+        refile(surface, entry);
+    }
+}
+
+void ms::ViewAreaIndex::refile(Surface const* surface, Entry const& entry)
+{
+    for (auto& view : views)
+    {
+        if (may_draw_in(entry, view.second))
+            view.second.surfaces.insert(surface);
+        else
+            view.second.surfaces.erase(surface);
+    }
+}
+
+bool ms::ViewAreaIndex::may_draw_in(Entry const& entry, View const& view)
+{
+    return !entry.extents || entry.extents.value().overlaps(view.area);
+}
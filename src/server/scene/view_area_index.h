@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_VIEW_AREA_INDEX_H_
+#define MIR_SCENE_VIEW_AREA_INDEX_H_
+
+#include "mir/compositor/compositor_id.h"
+#include "mir/graphics/renderable.h"
+#include "mir/geometry/rectangle.h"
+
+#include <cstdint>
+#include <experimental/optional>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/**
+ * Keeps, for each compositor that has a view area, the set of surfaces that
+ * may be drawn in it, so that the other surfaces can be left out of the
+ * compositor's scene elements.
+ *
+ * Where a surface is drawn is learnt from the renderables it generates, and
+ * forgotten whenever that may have changed (it moves, resizes, is transformed,
+ * or one of its streams posts its first frame or one of a new size). Each such
+ * change bumps the surface's
+ * version, so renderables generated before the change are not learnt from.
+ *
+ * A surface whose extents aren't known is in every view area until its
+ * renderables are seen again. So are surfaces with transformed renderables,
+ * which may be drawn anywhere.
+ *
+ * Compositors without a view area are in view of every surface.
+ */
+class ViewAreaIndex
+{
+public:
+    /// Compositor \a id only draws \a view_area (in screen coordinates)
+    void set_view_area(compositor::CompositorID id, geometry::Rectangle const& view_area);
+    void remove_view_area(compositor::CompositorID id);
+
+    void add(Surface const* surface);
+    void remove(Surface const* surface);
+
+    /// To be read before generating the renderables of \a surface that are passed to update()
+    auto version_of(Surface const* surface) const -> uint64_t;
+    /// \a surface generated \a renderables at \a version, which show where it is drawn
+    void update(Surface const* surface, uint64_t version, graphics::RenderableList const& renderables);
+    /// Where \a surface is drawn may have changed
+    void invalidate(Surface const* surface);
+    /// \a stream (the id() of the renderable drawing it) of \a surface posted a frame of \a size
+    void frame_posted(Surface const* surface, graphics::Renderable::ID stream, geometry::Size const& size);
+
+    /// Whether \a surface may be drawn in the view area of compositor \a id
+    bool in_view(Surface const* surface, compositor::CompositorID id) const;
+
+private:
+    struct Entry
+    {
+        /// Bounds of what the surface last drew, unset if not known
+        std::experimental::optional<geometry::Rectangle> extents;
+        /// IDs and sizes of the renderables the surface last drew
+        std::vector<std::pair<graphics::Renderable::ID, geometry::Size>> drawn;
+        uint64_t version{0};
+    };
+
+    struct View
+    {
+        geometry::Rectangle area;
+        std::unordered_set<Surface const*> surfaces;
+    };
+
+    void forget_extents(Surface const* surface, Entry& entry);
+    void refile(Surface const* surface, Entry const& entry);
+    static bool may_draw_in(Entry const& entry, View const& view);
+
+    std::mutex mutable mutex;
+    std::unordered_map<Surface const*, Entry> entries;
+    std::unordered_map<compositor::CompositorID, View> views;
+};
+}
+}
+
+#endif /* MIR_SCENE_VIEW_AREA_INDEX_H_ */
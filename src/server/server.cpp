@@ -33,6 +33,7 @@
 #include "mir/main_loop.h"
 #include "mir/report_exception.h"
 #include "mir/run_mir.h"
+#include "mir/startup_trace.h"
 #include "mir/cookie/authority.h"
 
 // TODO these are used to frig a stub renderer when running headless
@@ -130,6 +131,7 @@ struct TemporaryCompositeEventFilter : public mi::CompositeEventFilter
     MACRO(the_prompt_session_manager)\
     MACRO(the_shell)\
     MACRO(the_shell_display_layout)\
+    MACRO(the_shell_report)\
     MACRO(the_surface_stack)\
     MACRO(the_touch_visualizer)\
     MACRO(the_input_device_hub)\
@@ -299,6 +301,7 @@ void mir::Server::add_pre_init_callback(std::function<void()> const& pre_init_ca
     auto const updated = [=]
         {
             existing();
+            startup_trace::Span const span{"pre-init callback", "callback"};
             pre_init_callback();
         };
 
@@ -312,6 +315,7 @@ void mir::Server::add_init_callback(std::function<void()> const& init_callback)
     auto const updated = [=]
         {
             existing();
+            startup_trace::Span const span{"init callback", "callback"};
             init_callback();
         };
 
@@ -386,6 +390,9 @@ void mir::Server::apply_settings()
     auto const config = std::make_shared<ServerConfiguration>(options, self);
     self->server_config = config;
 
+    if (config->the_options()->is_set(mo::startup_trace_opt))
+        startup_trace::start(config->the_options()->get<std::string>(mo::startup_trace_opt));
+
     mir::logging::set_logger(config->the_logger());
 }
 
@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer_pool.h"
+
+#include "mir/graphics/graphic_buffer_allocator.h"
+#include "mir/graphics/buffer.h"
+#include "mir/renderer/sw/pixel_source.h"
+#include "mir/log.h"
+
+#include <algorithm>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace geom = mir::geometry;
+namespace msd = mir::shell::decoration;
+
+msd::BufferPool::BufferPool(
+    std::shared_ptr<mg::GraphicBufferAllocator> const& buffer_allocator,
+    size_t max_buffers)
+    : buffer_allocator{buffer_allocator},
+      max_buffers{max_buffers}
+{
+}
+
+auto msd::BufferPool::buffer_for(
+    uint32_t const* pixels,
+    geom::Size size,
+    uint64_t content) -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+{
+    if (size.width <= geom::Width{} || size.height <= geom::Height{})
+    {
+        log_warning("Failed to draw SSD: tried to create zero size buffer");
+        return std::experimental::nullopt;
+    }
+
+    // A pooled buffer is free once the buffer streams and compositor have let go of it
+    auto const is_free = [](PooledBuffer const& pooled) { return pooled.buffer.use_count() == 1; };
+
+    auto const pooled = std::find_if(buffers.begin(), buffers.end(),
+        [&](PooledBuffer const& pooled)
+        {
+            return is_free(pooled) && pooled.content == content && pooled.buffer->size() == size;
+        });
+
+    if (pooled != buffers.end())
+        return pooled->buffer;
+
+    std::shared_ptr<mg::Buffer> const buffer = buffer_allocator->alloc_software_buffer(size, mir_pixel_format_argb_8888);
+    auto const pixel_source = dynamic_cast<mrs::PixelSource*>(buffer->native_buffer_base());
+    if (!pixel_source)
+    {
+        log_warning("Failed to draw SSD: software buffer not a pixel source");
+        return std::experimental::nullopt;
+    }
+    pixel_source->write(
+        reinterpret_cast<unsigned char const*>(pixels),
+        size.width.as_int() * size.height.as_int() * sizeof(uint32_t));
+
+    if (buffers.size() >= max_buffers)
+        buffers.erase(std::remove_if(buffers.begin(), buffers.end(), is_free), buffers.end());
+
+    if (buffers.size() < max_buffers)
+        buffers.push_back(PooledBuffer{buffer, content});
+
+    return buffer;
+}
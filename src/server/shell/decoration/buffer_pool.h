@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SHELL_DECORATION_BUFFER_POOL_H_
+#define MIR_SHELL_DECORATION_BUFFER_POOL_H_
+
+#include "mir/geometry/size.h"
+
+#include <experimental/optional>
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+class GraphicBufferAllocator;
+class Buffer;
+}
+namespace shell
+{
+namespace decoration
+{
+/**
+ * Hands out software buffers holding decoration pixels, handing back one it
+ * handed out before when it already holds what is asked for.
+ *
+ * Buffers are never written to once handed out: the compositor uploads a
+ * buffer's pixels once, and keys its caches on the buffer's ID.
+ */
+class BufferPool
+{
+public:
+    BufferPool(
+        std::shared_ptr<graphics::GraphicBufferAllocator> const& buffer_allocator,
+        size_t max_buffers);
+
+    /// A buffer of \a size holding \a pixels (ARGB), which \a content identifies
+    auto buffer_for(
+        uint32_t const* pixels,
+        geometry::Size size,
+        uint64_t content) -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
+
+private:
+    struct PooledBuffer
+    {
+        std::shared_ptr<graphics::Buffer> buffer;
+        uint64_t content; ///< Identifies the pixels written to the buffer
+    };
+
+    std::shared_ptr<graphics::GraphicBufferAllocator> const buffer_allocator;
+    size_t const max_buffers;
+    std::vector<PooledBuffer> buffers;
+};
+}
+}
+}
+
+#endif // MIR_SHELL_DECORATION_BUFFER_POOL_H_
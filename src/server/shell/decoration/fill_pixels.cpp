@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fill_pixels.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+void mir::shell::decoration::fill_pixels(uint32_t* const start, size_t count, uint32_t color)
+{
+    size_t n = 0;
+
+#if defined(__SSE2__)
+    __m128i const colors = _mm_set1_epi32(static_cast<int>(color));
+    for (; n + 4 <= count; n += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(start + n), colors);
+#elif defined(__ARM_NEON)
+    uint32x4_t const colors = vdupq_n_u32(color);
+    for (; n + 4 <= count; n += 4)
+        vst1q_u32(start + n, colors);
+#endif
+
+    for (; n < count; n++)
+        start[n] = color;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SHELL_DECORATION_FILL_PIXELS_H_
+#define MIR_SHELL_DECORATION_FILL_PIXELS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mir
+{
+namespace shell
+{
+namespace decoration
+{
+/// Sets \a count pixels from \a start to \a color (four at a time where SSE2 or NEON is available)
+void fill_pixels(uint32_t* start, size_t count, uint32_t color);
+}
+}
+}
+
+#endif // MIR_SHELL_DECORATION_FILL_PIXELS_H_
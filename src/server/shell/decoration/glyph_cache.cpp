@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "glyph_cache.h"
+
+namespace msd = mir::shell::decoration;
+namespace geom = mir::geometry;
+
+msd::GlyphCache::GlyphCache(size_t max_glyphs_per_height)
+    : max_glyphs_per_height{max_glyphs_per_height}
+{
+}
+
+auto msd::GlyphCache::glyph_for(
+    char32_t code,
+    geom::Height height,
+    std::function<Glyph()> const& rasterize) -> Glyph const&
+{
+    auto& cached = glyphs[height.as_int()];
+
+    auto const glyph = cached.find(code);
+    if (glyph != cached.end())
+        return glyph->second;
+
+    auto rasterized = rasterize();
+
+    if (cached.size() >= max_glyphs_per_height)
+        cached.clear();
+
+    return cached.emplace(code, std::move(rasterized)).first->second;
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SHELL_DECORATION_GLYPH_CACHE_H_
+#define MIR_SHELL_DECORATION_GLYPH_CACHE_H_
+
+#include "mir/geometry/size.h"
+#include "mir/geometry/displacement.h"
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace shell
+{
+namespace decoration
+{
+/// A rasterized glyph
+struct Glyph
+{
+    geometry::Displacement offset;      ///< From the pen position to the top left of the bitmap
+    geometry::Displacement advance;
+    geometry::Size size;
+    std::vector<unsigned char> alpha;   ///< One byte per pixel, rows are not padded
+};
+
+/// Keeps rasterized glyphs by pixel height, then by character. Not threadsafe.
+class GlyphCache
+{
+public:
+    /// The cache for a pixel height is started afresh when it would hold more than \a max_glyphs_per_height
+    explicit GlyphCache(size_t max_glyphs_per_height);
+
+    /// The glyph for \a code at \a height, from \a rasterize if it isn't cached
+    /// The reference is valid until the next call
+    auto glyph_for(
+        char32_t code,
+        geometry::Height height,
+        std::function<Glyph()> const& rasterize) -> Glyph const&;
+
+private:
+    size_t const max_glyphs_per_height;
+    std::unordered_map<int, std::unordered_map<char32_t, Glyph>> glyphs;
+};
+}
+}
+}
+
+#endif // MIR_SHELL_DECORATION_GLYPH_CACHE_H_
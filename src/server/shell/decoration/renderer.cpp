@@ -20,23 +20,26 @@
 #include "renderer.h"
 #include "window.h"
 #include "input.h"
+#include "buffer_pool.h"
+#include "fill_pixels.h"
+#include "glyph_cache.h"
 
 #include "mir/graphics/graphic_buffer_allocator.h"
-#include "mir/renderer/sw/pixel_source.h"
 #include "mir/geometry/displacement.h"
 #include "mir/log.h"
 
 #include <boost/throw_exception.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <algorithm>
 #include <locale>
 #include <codecvt>
 
 namespace ms = mir::scene;
 namespace mg = mir::graphics;
-namespace mrs = mir::renderer::software;
 namespace geom = mir::geometry;
 namespace msh = mir::shell;
 namespace msd = mir::shell::decoration;
@@ -95,6 +98,12 @@ inline auto area(geom::Size size) -> size_t
         : 0;
 }
 
+/// Enough for any window title in a handful of scripts; the cache is started afresh beyond that
+size_t const max_cached_glyphs = 512;
+
+/// Most decorations have four buffers, and one or two of each may still be on screen
+size_t const max_pooled_buffers = 12;
+
 inline void render_row(
     uint32_t* const data,
     geom::Size buf_size,
@@ -107,9 +116,8 @@ inline void render_row(
     geom::X const right = std::min(left.x + as_delta(length), as_x(buf_size.width));
     left.x = std::max(left.x, geom::X{});
     uint32_t* const start = data + (left.y.as_int() * buf_size.width.as_int()) + left.x.as_int();
-    uint32_t* const end = start + right.as_int() - left.x.as_int();
-    for (uint32_t* i = start; i < end; i++)
-        *i = color;
+    if (right > left.x)
+        msd::fill_pixels(start, right.as_int() - left.x.as_int(), color);
 }
 
 inline void render_close_icon(
@@ -188,13 +196,16 @@ private:
     std::mutex mutex;
     FT_Library library;
     FT_Face face;
+    geom::Height char_size{};
+    GlyphCache glyph_cache{max_cached_glyphs};
 
     void set_char_size(geom::Height height);
     void rasterize_glyph(char32_t glyph);
+    auto rendered_glyph(char32_t code, geom::Height height) -> Glyph;
     void render_glyph(
         Pixel* buf,
         geom::Size buf_size,
-        FT_Bitmap const* glyph,
+        Glyph const& glyph,
         geom::Point top_left,
         Pixel color);
 
@@ -290,34 +301,18 @@ void msd::Renderer::Text::Impl::render(
         return;
     }
 
-    try
-    {
-        set_char_size(height_pixels);
-    }
-    catch (std::runtime_error const& error)
-    {
-        log_warning(error.what());
-        return;
-    }
-
     auto const utf32 = utf8_to_utf32(text);
 
-    for (char32_t const glyph : utf32)
+    for (char32_t const code : utf32)
     {
         try
         {
-            rasterize_glyph(glyph);
-
-            geom::Point glyph_top_left =
-                top_left +
-                geom::Displacement{
-                    face->glyph->bitmap_left,
-                    height_pixels.as_int() - face->glyph->bitmap_top};
-            render_glyph(buf, buf_size, &face->glyph->bitmap, glyph_top_left, color);
-
-            top_left += geom::Displacement{
-                face->glyph->advance.x / 64,
-                face->glyph->advance.y / 64};
+            auto const& glyph = glyph_cache.glyph_for(
+                code,
+                height_pixels,
+                [&]() { return rendered_glyph(code, height_pixels); });
+            render_glyph(buf, buf_size, glyph, top_left + glyph.offset, color);
+            top_left += glyph.advance;
         }
         catch (std::runtime_error const& error)
         {
@@ -326,11 +321,39 @@ void msd::Renderer::Text::Impl::render(
     }
 }
 
+auto msd::Renderer::Text::Impl::rendered_glyph(char32_t code, geom::Height height) -> Glyph
+{
+    set_char_size(height);
+    rasterize_glyph(code);
+
+    auto const& bitmap = face->glyph->bitmap;
+    Glyph glyph{
+        {face->glyph->bitmap_left, height.as_int() - face->glyph->bitmap_top},
+        {face->glyph->advance.x / 64, face->glyph->advance.y / 64},
+        {bitmap.width, bitmap.rows},
+        std::vector<unsigned char>(bitmap.width * bitmap.rows)};
+
+    for (unsigned row = 0; row < bitmap.rows; row++)
+    {
+        std::copy_n(
+            bitmap.buffer + static_cast<int>(row) * bitmap.pitch,
+            bitmap.width,
+            glyph.alpha.begin() + row * bitmap.width);
+    }
+
+    return glyph;
+}
+
 void msd::Renderer::Text::Impl::set_char_size(geom::Height height)
 {
+    if (height == char_size)
+        return;
+
     if (auto const error = FT_Set_Pixel_Sizes(face, 0, height.as_int()))
         BOOST_THROW_EXCEPTION(std::runtime_error(
             "Setting char size failed with error " + std::to_string(error)));
+
+    char_size = height;
 }
 
 void msd::Renderer::Text::Impl::rasterize_glyph(char32_t glyph)
@@ -349,15 +372,15 @@ void msd::Renderer::Text::Impl::rasterize_glyph(char32_t glyph)
 void msd::Renderer::Text::Impl::render_glyph(
     Pixel* buf,
     geom::Size buf_size,
-    FT_Bitmap const* glyph,
+    Glyph const& glyph,
     geom::Point top_left,
     Pixel color)
 {
     geom::X const buffer_left = std::max(top_left.x, geom::X{});
-    geom::X const buffer_right = std::min(top_left.x + geom::DeltaX{glyph->width}, as_x(buf_size.width));
+    geom::X const buffer_right = std::min(top_left.x + as_delta(glyph.size.width), as_x(buf_size.width));
 
     geom::Y const buffer_top = std::max(top_left.y, geom::Y{});
-    geom::Y const buffer_bottom = std::min(top_left.y + geom::DeltaY{glyph->rows}, as_y(buf_size.height));
+    geom::Y const buffer_bottom = std::min(top_left.y + as_delta(glyph.size.height), as_y(buf_size.height));
 
     geom::Displacement const glyph_offset = as_displacement(top_left);
 
@@ -367,7 +390,7 @@ void msd::Renderer::Text::Impl::render_glyph(
     for (geom::Y buffer_y = buffer_top; buffer_y < buffer_bottom; buffer_y += geom::DeltaY{1})
     {
         geom::Y const glyph_y = buffer_y - glyph_offset.dy;
-        unsigned char* const glyph_row = glyph->buffer + glyph_y.as_int() * glyph->pitch;
+        unsigned char const* const glyph_row = glyph.alpha.data() + glyph_y.as_int() * glyph.size.width.as_int();
         Pixel* const buffer_row = buf + buffer_y.as_int() * buf_size.width.as_int();
 
         for (geom::X buffer_x = buffer_left; buffer_x < buffer_right; buffer_x += geom::DeltaX{1})
@@ -436,8 +459,7 @@ auto msd::Renderer::Text::Impl::utf8_to_utf32(std::string const& text) -> std::u
 msd::Renderer::Renderer(
     std::shared_ptr<graphics::GraphicBufferAllocator> const& buffer_allocator,
     std::shared_ptr<StaticGeometry const> const& static_geometry)
-    : buffer_allocator{buffer_allocator},
-      focused_theme{
+    : focused_theme{
           default_focused_background,
           default_focused_text},
       unfocused_theme{
@@ -462,7 +484,8 @@ msd::Renderer::Renderer(
               render_minimize_icon}},
       },
       static_geometry{static_geometry},
-      text{Text::instance()}
+      text{Text::instance()},
+      buffer_pool{buffer_allocator, max_pooled_buffers}
 {
 }
 
@@ -538,15 +561,12 @@ auto msd::Renderer::render_titlebar() -> std::experimental::optional<std::shared
         needs_titlebar_redraw = true;
     }
 
+    if (needs_titlebar_redraw || needs_titlebar_buttons_redraw)
+        titlebar_content = titlebar_content_key();
+
     if (needs_titlebar_redraw)
     {
-        for (geom::Y y{0}; y < as_y(titlebar_size.height); y += geom::DeltaY{1})
-        {
-            render_row(
-                titlebar_pixels.get(), titlebar_size,
-                {0, y}, titlebar_size.width,
-                current_theme->background_color);
-        }
+        fill_pixels(titlebar_pixels.get(), area(titlebar_size), current_theme->background_color);
 
         text->render(
             titlebar_pixels.get(),
@@ -597,7 +617,7 @@ auto msd::Renderer::render_titlebar() -> std::experimental::optional<std::shared
     needs_titlebar_redraw = false;
     needs_titlebar_buttons_redraw = false;
 
-    return make_buffer(titlebar_pixels.get(), titlebar_size);
+    return buffer_pool.buffer_for(titlebar_pixels.get(), titlebar_size, titlebar_content);
 }
 
 auto msd::Renderer::render_left_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
@@ -605,7 +625,7 @@ auto msd::Renderer::render_left_border() -> std::experimental::optional<std::sha
     if (!area(left_border_size))
         return std::experimental::nullopt;
     update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), left_border_size);
+    return buffer_pool.buffer_for(solid_color_pixels.get(), left_border_size, solid_color_content);
 }
 
 auto msd::Renderer::render_right_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
@@ -613,7 +633,7 @@ auto msd::Renderer::render_right_border() -> std::experimental::optional<std::sh
     if (!area(right_border_size))
         return std::experimental::nullopt;
     update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), right_border_size);
+    return buffer_pool.buffer_for(solid_color_pixels.get(), right_border_size, solid_color_content);
 }
 
 auto msd::Renderer::render_bottom_border() -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
@@ -621,7 +641,7 @@ auto msd::Renderer::render_bottom_border() -> std::experimental::optional<std::s
     if (!area(bottom_border_size))
         return std::experimental::nullopt;
     update_solid_color_pixels();
-    return make_buffer(solid_color_pixels.get(), bottom_border_size);
+    return buffer_pool.buffer_for(solid_color_pixels.get(), bottom_border_size, solid_color_content);
 }
 
 void msd::Renderer::update_solid_color_pixels()
@@ -634,34 +654,30 @@ void msd::Renderer::update_solid_color_pixels()
 
     if (needs_solid_color_redraw)
     {
-        render_row(
-            solid_color_pixels.get(), geom::Size{solid_color_pixels_length, 1},
-            geom::Point{}, geom::Width{solid_color_pixels_length},
-            current_theme->background_color);
+        fill_pixels(solid_color_pixels.get(), solid_color_pixels_length, current_theme->background_color);
+        solid_color_content = current_theme->background_color;
     }
 
     needs_solid_color_redraw = false;
 }
 
-auto msd::Renderer::make_buffer(
-    uint32_t const* pixels,
-    geometry::Size size) -> std::experimental::optional<std::shared_ptr<mg::Buffer>>
+auto msd::Renderer::titlebar_content_key() const -> uint64_t
 {
-    if (!area(size))
-    {
-        log_warning("Failed to draw SSD: tried to create zero size buffer");
-        return std::experimental::nullopt;
-    }
-    std::shared_ptr<graphics::Buffer> const buffer = buffer_allocator->alloc_software_buffer(size, buffer_format);
-    auto const pixel_source = dynamic_cast<mrs::PixelSource*>(buffer->native_buffer_base());
-    if (!pixel_source)
+    // Everything the titlebar is drawn from, except its size (which the buffer pool matches on anyway)
+    size_t key{0};
+    boost::hash_combine(key, current_theme->background_color);
+    boost::hash_combine(key, current_theme->text_color);
+    boost::hash_combine(key, name);
+    for (auto const& button : buttons)
     {
-        log_warning("Failed to draw SSD: software buffer not a pixel source");
-        return std::experimental::nullopt;
+        boost::hash_combine(key, static_cast<int>(button.function));
+        boost::hash_combine(key, button.state == ButtonState::Hovered);
+        boost::hash_combine(key, button.rect.top_left.x.as_int());
+        boost::hash_combine(key, button.rect.top_left.y.as_int());
+        boost::hash_combine(key, button.rect.size.width.as_int());
+        boost::hash_combine(key, button.rect.size.height.as_int());
     }
-    size_t const buf_pixels_size{area(size) * sizeof(Pixel)};
-    pixel_source->write((unsigned char const*)pixels, buf_pixels_size);
-    return buffer;
+    return key;
 }
 
 auto msd::Renderer::alloc_pixels(geometry::Size size) -> std::unique_ptr<uint32_t[]>
@@ -22,9 +22,11 @@
 #include "mir/geometry/rectangle.h"
 
 #include "input.h"
+#include "buffer_pool.h"
 
 #include <memory>
 #include <map>
+#include <vector>
 
 namespace mir
 {
@@ -105,7 +107,6 @@ private:
             Pixel color)> const render_icon; ///< Draws button's icon to the given buffer
     };
 
-    std::shared_ptr<graphics::GraphicBufferAllocator> buffer_allocator;
     Theme const focused_theme;
     Theme const unfocused_theme;
     Theme const* current_theme;
@@ -129,10 +130,13 @@ private:
 
     std::shared_ptr<Text> const text;
 
+    BufferPool buffer_pool;
+    /// Keyed on what was drawn, so going back to an earlier state (such as focus) reuses its buffer
+    uint64_t titlebar_content{0};
+    uint64_t solid_color_content{0};
+
     void update_solid_color_pixels();
-    auto make_buffer(
-        Pixel const* pixels,
-        geometry::Size size) -> std::experimental::optional<std::shared_ptr<graphics::Buffer>>;
+    auto titlebar_content_key() const -> uint64_t;
     static auto alloc_pixels(geometry::Size size) -> std::unique_ptr<Pixel[]>;
 };
 }
@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+#include "mir/log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <cxxabi.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mst = mir::startup_trace;
+
+namespace
+{
+struct Event
+{
+    std::string name;
+    char const* category;
+    mst::Clock::time_point begin;
+    mst::Clock::time_point end;
+    long thread;
+};
+
+struct Trace
+{
+    std::string filename;
+    mst::Clock::time_point start;
+    std::vector<Event> events;
+};
+
+std::atomic<bool> is_recording{false};
+std::mutex trace_mutex;
+std::unique_ptr<Trace> trace;
+
+auto escaped(std::string const& string) -> std::string
+{
+    std::string result;
+    result.reserve(string.size());
+
+    for (char const c : string)
+    {
+        switch (c)
+        {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char code[7];
+                snprintf(code, sizeof code, "\\u%04x", c);
+                result += code;
+            }
+            else
+            {
+                result += c;
+            }
+        }
+    }
+
+    return result;
+}
+
+auto microseconds(mst::Clock::duration duration) -> long long
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}
+
+void mst::start(std::string const& filename)
+{
+    std::lock_guard<std::mutex> lock{trace_mutex};
+
+    trace.reset(new Trace{filename, Clock::now(), {}});
+    is_recording = true;
+}
+
+auto mst::recording() -> bool
+{
+    return is_recording;
+}
+
+void mst::record(std::string const& name, char const* category, Clock::time_point begin, Clock::time_point end)
+{
+    std::lock_guard<std::mutex> lock{trace_mutex};
+
+    if (trace)
+        trace->events.push_back(Event{name, category, begin, end, syscall(SYS_gettid)});
+}
+
+void mst::finish()
+{
+    std::unique_ptr<Trace> finished;
+    {
+        std::lock_guard<std::mutex> lock{trace_mutex};
+        is_recording = false;
+        finished = std::move(trace);
+    }
+
+    if (!finished)
+        return;
+
+    std::ofstream out{finished->filename, std::ios::trunc};
+
+    // Complete ("X") events, with times in microseconds since recording started
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto separator = "\n";
+    for (auto const& event : finished->events)
+    {
+        out << separator
+            << "{\"name\":\"" << escaped(event.name) << "\""
+            << ",\"cat\":\"" << event.category << "\""
+            << ",\"ph\":\"X\""
+            << ",\"ts\":" << microseconds(event.begin - finished->start)
+            << ",\"dur\":" << microseconds(event.end - event.begin)
+            << ",\"pid\":" << getpid()
+            << ",\"tid\":" << event.thread
+            << "}";
+        separator = ",\n";
+    }
+
+    out << "\n]}\n";
+
+    out.close();
+    if (!out)
+        log_warning("Failed to write startup trace: %s", finished->filename.c_str());
+    else
+        log_info("Wrote startup trace: %s", finished->filename.c_str());
+}
+
+auto mst::name_of_pointee(std::type_info const& pointer_type) -> std::string
+{
+    int status{0};
+    std::unique_ptr<char, void(*)(void*)> const demangled{
+        abi::__cxa_demangle(pointer_type.name(), nullptr, nullptr, &status),
+        &std::free};
+
+    std::string name{status == 0 && demangled ? demangled.get() : pointer_type.name()};
+
+    if (!name.empty() && name.back() == '*')
+        name.pop_back();
+
+    return name;
+}
+
+mst::Span::Span(std::string const& name, char const* category) :
+    recording{mst::recording()},
+    name{recording ? name : std::string{}},
+    category{category},
+    begin{recording ? Clock::now() : Clock::time_point{}}
+{
+}
+
+mst::Span::~Span()
+{
+    if (recording)
+        record(name, category, begin, Clock::now());
+}
@@ -105,11 +105,27 @@ public:
         return 1u;
     }
 
+    auto damage_since(graphics::BufferID) const -> std::experimental::optional<geometry::Rectangles> override
+    {
+        return std::experimental::nullopt;
+    }
+
+    auto opaque_region() const -> geometry::Rectangles override
+    {
+        return opaque;
+    }
+
+    void set_opaque_region(geometry::Rectangles const& region)
+    {
+        opaque = region;
+    }
+
 private:
     std::shared_ptr<graphics::Buffer> buf;
     mir::geometry::Rectangle rect;
     float opacity;
     bool rectangular;
+    geometry::Rectangles opaque;
 };
 
 } // namespace doubles
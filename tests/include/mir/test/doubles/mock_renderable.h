@@ -45,6 +45,8 @@ struct MockRenderable : public graphics::Renderable
             .WillByDefault(testing::Return(glm::mat4{}));
         ON_CALL(*this, visible())
             .WillByDefault(testing::Return(true));
+        ON_CALL(*this, damage_since(testing::_))
+            .WillByDefault(testing::Return(std::experimental::optional<geometry::Rectangles>()));
     }
 
     MOCK_CONST_METHOD0(id, ID());
@@ -56,6 +58,8 @@ struct MockRenderable : public graphics::Renderable
     MOCK_CONST_METHOD0(visible, bool());
     MOCK_CONST_METHOD0(shaped, bool());
     MOCK_CONST_METHOD0(swap_interval, unsigned int());
+    MOCK_CONST_METHOD1(damage_since, std::experimental::optional<geometry::Rectangles>(graphics::BufferID));
+    MOCK_CONST_METHOD0(opaque_region, geometry::Rectangles());
 };
 }
 }
@@ -44,6 +44,7 @@ public:
     MOCK_CONST_METHOD1(frames_pending, int(compositor::CompositorID));
     MOCK_METHOD1(register_compositor, void(compositor::CompositorID));
     MOCK_METHOD1(unregister_compositor, void(compositor::CompositorID));
+    MOCK_METHOD2(set_view_area, void(compositor::CompositorID, geometry::Rectangle const&));
 
     MOCK_METHOD1(add_observer, void(std::shared_ptr<scene::Observer> const&));
     MOCK_METHOD1(remove_observer, void(std::weak_ptr<scene::Observer> const&));
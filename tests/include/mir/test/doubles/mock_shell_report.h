@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_DOUBLES_MOCK_SHELL_REPORT_H_
+#define MIR_TEST_DOUBLES_MOCK_SHELL_REPORT_H_
+
+#include "mir/shell/shell_report.h"
+#include <gmock/gmock.h>
+
+namespace mir
+{
+namespace test
+{
+namespace doubles
+{
+
+class MockShellReport : public shell::ShellReport
+{
+public:
+    MOCK_METHOD1(opened_session, void(scene::Session const&));
+    MOCK_METHOD1(closing_session, void(scene::Session const&));
+    MOCK_METHOD2(created_surface, void(scene::Session const&, scene::Surface const&));
+    MOCK_METHOD3(update_surface,
+                 void(scene::Session const&, scene::Surface const&, shell::SurfaceSpecification const&));
+    MOCK_METHOD4(update_surface, void(scene::Session const&, scene::Surface const&, MirWindowAttrib, int));
+    MOCK_METHOD2(destroying_surface, void(scene::Session const&, scene::Surface const&));
+    MOCK_METHOD2(started_prompt_session, void(scene::PromptSession const&, scene::Session const&));
+    MOCK_METHOD2(added_prompt_provider, void(scene::PromptSession const&, scene::Session const&));
+    MOCK_METHOD1(stopping_prompt_session, void(scene::PromptSession const&));
+    MOCK_METHOD1(adding_display, void(geometry::Rectangle const&));
+    MOCK_METHOD1(removing_display, void(geometry::Rectangle const&));
+    MOCK_METHOD2(input_focus_set_to, void(scene::Session const*, scene::Surface const*));
+    MOCK_METHOD1(surfaces_raised, void(shell::SurfaceSet const&));
+    MOCK_METHOD2(window_manager_lock_contended, void(std::chrono::steady_clock::duration, uint64_t));
+};
+
+} // namespace doubles
+} // namespace test
+} // namespace mir
+
+#endif
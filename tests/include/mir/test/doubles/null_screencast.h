@@ -47,6 +47,10 @@ public:
     {
         return nullptr;
     }
+    frontend::ScreencastFrame capture_if_damaged(frontend::ScreencastSessionId)
+    {
+        return {};
+    }
     void capture(frontend::ScreencastSessionId, std::shared_ptr<graphics::Buffer> const&) {}
 };
 
@@ -65,6 +65,15 @@ public:
     {
         if (b) ++nready;
     }
+    void submit_buffer(std::shared_ptr<graphics::Buffer> const& b, geometry::Rectangles const&) override
+    {
+        submit_buffer(b);
+    }
+    auto damage_between(graphics::BufferID, graphics::BufferID) const
+        -> std::experimental::optional<geometry::Rectangles> override
+    {
+        return std::experimental::nullopt;
+    }
     void with_most_recent_buffer_do(std::function<void(graphics::Buffer&)> const& fn) override
     {
         fn(*stub_compositor_buffer);
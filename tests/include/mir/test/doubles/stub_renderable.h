@@ -95,6 +95,16 @@ public:
         return 1;
     }
 
+    auto damage_since(graphics::BufferID) const -> std::experimental::optional<geometry::Rectangles> override
+    {
+        return std::experimental::nullopt;
+    }
+
+    auto opaque_region() const -> geometry::Rectangles override
+    {
+        return {};
+    }
+
 private:
     std::shared_ptr<graphics::Buffer> make_stub_buffer(geometry::Rectangle const& rect)
     {
@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+
+#include <future>
+#include <thread>
+
+using namespace miral;
+using namespace testing;
+namespace mt = mir::test;
+
+namespace
+{
+struct ModelLock : mt::TestWindowManagerTools
+{
+    // Holds the lock until another thread has found it held, and is waiting for it
+    void contend_for_the_lock()
+    {
+        std::promise<void> waiting;
+        EXPECT_CALL(*window_manager_policy, model_lock_waiting())
+            .WillOnce(InvokeWithoutArgs([&] { waiting.set_value(); }));
+
+        std::thread waiter;
+
+        basic_window_manager.invoke_under_lock([&]
+            {
+                waiter = std::thread{[this] { basic_window_manager.invoke_under_lock([]{}); }};
+                waiting.get_future().wait();
+            });
+
+        waiter.join();
+    }
+};
+}
+
+TEST_F(ModelLock, an_uncontended_lock_is_not_reported)
+{
+    EXPECT_CALL(*window_manager_policy, model_lock_waiting()).Times(0);
+    EXPECT_CALL(*window_manager_policy, model_lock_contended(_, _)).Times(0);
+    EXPECT_CALL(*shell_report, window_manager_lock_contended(_, _)).Times(0);
+
+    basic_window_manager.invoke_under_lock([]{});
+}
+
+TEST_F(ModelLock, a_thread_waiting_for_the_lock_is_reported)
+{
+    EXPECT_CALL(*window_manager_policy, model_lock_contended(_, 1u));
+
+    contend_for_the_lock();
+}
+
+TEST_F(ModelLock, a_thread_waiting_for_the_lock_is_reported_to_the_shell_report)
+{
+    EXPECT_CALL(*shell_report, window_manager_lock_contended(_, 1u));
+    EXPECT_CALL(*shell_report, window_manager_lock_contended(_, 2u));
+
+    contend_for_the_lock();
+    contend_for_the_lock();
+}
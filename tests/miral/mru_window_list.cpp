@@ -189,3 +189,17 @@ TEST_F(MRUWindowList, hiding_then_showing_windows_retains_order)
     EXPECT_THAT(as_enumerated, ElementsAre(window_c, window_b, window_a));
 }
 
+
+TEST_F(MRUWindowList, pushing_windows_while_enumerating_enumerates_each_window_once)
+{
+    mru_list.push(window_a);
+    mru_list.push(window_b);
+    mru_list.push(window_c);
+
+    std::vector<miral::Window> as_enumerated;
+
+    mru_list.enumerate([&](miral::Window& window)
+       { auto const w = window; as_enumerated.push_back(w); mru_list.push(w); return true; });
+
+    EXPECT_THAT(as_enumerated, ElementsAre(window_c, window_b, window_a));
+}
@@ -279,11 +279,13 @@ mt::TestWindowManagerTools::TestWindowManagerTools()
       session{std::make_shared<StubStubSession>()},
       window_manager_policy{nullptr},
       window_manager_tools{nullptr},
+      shell_report{std::make_shared<testing::NiceMock<doubles::MockShellReport>>()},
       basic_window_manager{
         &self->focus_controller,
         mir::test::fake_shared(self->display_layout),
         mir::test::fake_shared(self->persistent_surface_store),
         self->display_configuration_observer,
+        shell_report,
         [this](miral::WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
             {
                 auto policy = std::make_unique<testing::NiceMock<MockWindowManagerPolicy>>(tools);
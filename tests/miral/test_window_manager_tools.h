@@ -26,6 +26,7 @@
 #include <mir/shell/surface_specification.h>
 #include <mir/scene/surface_creation_parameters.h>
 #include <mir/scene/surface.h>
+#include <mir/test/doubles/mock_shell_report.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -42,7 +43,8 @@ namespace test
 
 struct MockWindowManagerPolicy
     : miral::CanonicalWindowManagerPolicy,
-      miral::WindowManagementPolicy::ApplicationZoneAddendum
+      miral::WindowManagementPolicy::ApplicationZoneAddendum,
+      miral::ModelLockReport
 {
     using miral::CanonicalWindowManagerPolicy::CanonicalWindowManagerPolicy;
 
@@ -60,6 +62,8 @@ struct MockWindowManagerPolicy
     MOCK_METHOD1(advise_application_zone_create, void(miral::Zone const&));
     MOCK_METHOD2(advise_application_zone_update, void(miral::Zone const&, miral::Zone const&));
     MOCK_METHOD1(advise_application_zone_delete, void(miral::Zone const&));
+    MOCK_METHOD0(model_lock_waiting, void());
+    MOCK_METHOD2(model_lock_contended, void(std::chrono::steady_clock::duration, uint64_t));
 
     void handle_request_drag_and_drop(miral::WindowInfo& /*window_info*/) {}
     void handle_request_move(miral::WindowInfo& /*window_info*/, MirInputEvent const* /*input_event*/) {}
@@ -83,6 +87,7 @@ public:
     std::shared_ptr<mir::scene::Session> session;
     MockWindowManagerPolicy* window_manager_policy;
     miral::WindowManagerTools window_manager_tools;
+    std::shared_ptr<testing::NiceMock<doubles::MockShellReport>> const shell_report;
     miral::BasicWindowManager basic_window_manager;
 
     static auto create_surface(
@@ -506,6 +506,16 @@ void basic_software_buffer_drawing(
             return 0;
         }
 
+        auto damage_since(mg::BufferID) const -> std::experimental::optional<mir::geometry::Rectangles> override
+        {
+            return std::experimental::nullopt;
+        }
+
+        auto opaque_region() const -> mir::geometry::Rectangles override
+        {
+            return {};
+        }
+
         void set_position(mir::geometry::Point top_left)
         {
             this->top_left = top_left;
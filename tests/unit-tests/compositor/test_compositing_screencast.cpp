@@ -34,6 +34,8 @@
 #include "mir/test/doubles/mock_gl.h"
 #include "mir/test/doubles/stub_scene.h"
 #include "mir/test/doubles/stub_scene_element.h"
+#include "mir/test/doubles/stub_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
 #include "mir/test/doubles/mock_scene.h"
 
 #include "mir/test/as_render_target.h"
@@ -410,6 +412,74 @@ TEST_F(CompositingScreencastTest, allocates_different_buffers_per_session)
     ASSERT_EQ(&stub_buffer2, buffer2.get());
 }
 
+TEST_F(CompositingScreencastTest, capture_if_damaged_composites_only_when_the_scene_changed)
+{
+    using namespace testing;
+
+    NiceMock<mtd::MockScene> mock_scene;
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+    auto const renderable = std::make_shared<mtd::StubRenderable>(default_region);
+
+    ON_CALL(mock_scene, scene_elements_for(_))
+        .WillByDefault(InvokeWithoutArgs(
+            [&] { return mc::SceneElementSequence{std::make_shared<mtd::StubSceneElement>(renderable)}; }));
+    EXPECT_CALL(mock_db_compositor_factory, create_compositor_mock(_));
+
+    mc::CompositingScreencast screencast_local{
+        mt::fake_shared(mock_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast_local.create_session(
+        default_region, default_size, default_pixel_format,
+        default_num_buffers, default_mirror_mode);
+
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(1);
+
+    auto const first = screencast_local.capture_if_damaged(session_id);
+    auto const unchanged = screencast_local.capture_if_damaged(session_id);
+
+    EXPECT_THAT(first.buffer, NotNull());
+    EXPECT_THAT(first.damage.size(), Gt(0u));
+    EXPECT_THAT(unchanged.buffer, Eq(first.buffer));
+    EXPECT_THAT(unchanged.damage.size(), Eq(0u));
+
+    Mock::VerifyAndClearExpectations(&mock_db_compositor_factory.mock_db_compositor);
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(1);
+
+    renderable->set_buffer(std::make_shared<mtd::StubBuffer>());
+    auto const changed = screencast_local.capture_if_damaged(session_id);
+
+    EXPECT_THAT(changed.damage.size(), Gt(0u));
+}
+
+TEST_F(CompositingScreencastTest, capture_always_composites)
+{
+    using namespace testing;
+
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+    EXPECT_CALL(mock_db_compositor_factory, create_compositor_mock(_));
+
+    mc::CompositingScreencast screencast_local{
+        mt::fake_shared(stub_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast_local.create_session(
+        default_region, default_size, default_pixel_format,
+        default_num_buffers, default_mirror_mode);
+
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(2);
+
+    screencast_local.capture(session_id);
+    screencast_local.capture(session_id);
+}
+
 TEST_F(CompositingScreencastTest, registers_and_unregisters_from_scene)
 {
     using namespace testing;
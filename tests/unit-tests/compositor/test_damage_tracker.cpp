@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/damage_tracker.h"
+#include "mir/test/doubles/mock_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+using namespace testing;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+namespace mtd = mir::test::doubles;
+
+namespace
+{
+struct DamageTracker : Test
+{
+    std::shared_ptr<NiceMock<mtd::MockRenderable>> renderable_at(geom::Rectangle const& position)
+    {
+        auto const renderable = std::make_shared<NiceMock<mtd::MockRenderable>>();
+        ON_CALL(*renderable, id()).WillByDefault(Return(renderable.get()));
+        ON_CALL(*renderable, screen_position()).WillByDefault(Return(position));
+        ON_CALL(*renderable, transformation()).WillByDefault(Return(glm::mat4(1)));
+        ON_CALL(*renderable, buffer()).WillByDefault(Return(std::make_shared<mtd::StubBuffer>(position.size)));
+        return renderable;
+    }
+
+    geom::Rectangle const view_area{{0, 0}, {1920, 1080}};
+    mc::DamageTracker tracker;
+};
+}
+
+TEST_F(DamageTracker, first_frame_is_entirely_damaged)
+{
+    auto const renderable = renderable_at({{10, 10}, {100, 100}});
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area), Eq(geom::Rectangles{view_area}));
+}
+
+TEST_F(DamageTracker, unchanged_frame_has_no_damage)
+{
+    auto const renderable = renderable_at({{10, 10}, {100, 100}});
+    tracker.damage_for({renderable}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area).size(), Eq(0u));
+}
+
+TEST_F(DamageTracker, moving_damages_old_and_new_positions)
+{
+    geom::Rectangle const old_position{{10, 10}, {100, 100}};
+    geom::Rectangle const new_position{{50, 60}, {100, 100}};
+    auto const renderable = renderable_at(old_position);
+    tracker.damage_for({renderable}, view_area);
+
+    ON_CALL(*renderable, screen_position()).WillByDefault(Return(new_position));
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area), Eq(geom::Rectangles{old_position, new_position}));
+}
+
+TEST_F(DamageTracker, removal_damages_where_the_renderable_was)
+{
+    geom::Rectangle const position{{10, 10}, {100, 100}};
+    auto const removed = renderable_at(position);
+    auto const remaining = renderable_at({{500, 500}, {100, 100}});
+    tracker.damage_for({remaining, removed}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({remaining}, view_area), Eq(geom::Rectangles{position}));
+}
+
+TEST_F(DamageTracker, new_buffer_damages_only_what_the_client_changed)
+{
+    auto const renderable = renderable_at({{10, 10}, {100, 100}});
+    auto const old_buffer = renderable->buffer();
+    tracker.damage_for({renderable}, view_area);
+
+    ON_CALL(*renderable, buffer()).WillByDefault(Return(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100})));
+    EXPECT_CALL(*renderable, damage_since(old_buffer->id()))
+        .WillOnce(Return(geom::Rectangles{{{5, 5}, {2, 3}}}));
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area), Eq(geom::Rectangles{{{15, 15}, {2, 3}}}));
+}
+
+TEST_F(DamageTracker, new_buffer_without_known_damage_damages_the_whole_renderable)
+{
+    geom::Rectangle const position{{10, 10}, {100, 100}};
+    auto const renderable = renderable_at(position);
+    tracker.damage_for({renderable}, view_area);
+
+    ON_CALL(*renderable, buffer()).WillByDefault(Return(std::make_shared<mtd::StubBuffer>(geom::Size{100, 100})));
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area), Eq(geom::Rectangles{position}));
+}
+
+TEST_F(DamageTracker, restacking_damages_everything)
+{
+    auto const lower = renderable_at({{10, 10}, {100, 100}});
+    auto const upper = renderable_at({{50, 50}, {100, 100}});
+    tracker.damage_for({lower, upper}, view_area);
+
+    EXPECT_THAT(tracker.damage_for({upper, lower}, view_area), Eq(geom::Rectangles{view_area}));
+}
+
+TEST_F(DamageTracker, reset_damages_everything)
+{
+    auto const renderable = renderable_at({{10, 10}, {100, 100}});
+    tracker.damage_for({renderable}, view_area);
+
+    tracker.reset();
+
+    EXPECT_THAT(tracker.damage_for({renderable}, view_area), Eq(geom::Rectangles{view_area}));
+}
@@ -388,3 +388,23 @@ TEST_F(DefaultDisplayBufferCompositor, marks_occluded_scene_elements)
     compositor.composite({element0_occluded, element1_rendered, element2_occluded});
 }
 
+
+TEST_F(DefaultDisplayBufferCompositor, repaints_everything_after_a_bypassed_frame)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({small}));
+
+    EXPECT_CALL(display_buffer, overlay(_))
+        .WillOnce(Return(true))
+        .WillRepeatedly(Return(false));
+    compositor.composite(make_scene_elements({small}));
+
+    EXPECT_CALL(mock_renderer, set_damage(Eq(geom::Rectangles{screen})));
+    compositor.composite(make_scene_elements({small}));
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/compositor/frame_presentation.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+using namespace testing;
+
+TEST(FramePresentation, work_runs_straight_away_outside_a_compositing_thread)
+{
+    bool ran{false};
+
+    mc::on_frame_presented([&](mc::FramePresentation const& presentation)
+        {
+            ran = true;
+            EXPECT_FALSE(presentation.hardware_clock);
+            EXPECT_THAT(presentation.frame.ust.clock_id, Eq(CLOCK_MONOTONIC));
+        });
+
+    EXPECT_TRUE(ran);
+}
+
+TEST(FramePresentation, work_is_deferred_until_the_frame_is_presented)
+{
+    mc::FramePresentationScope scope;
+
+    int64_t presented_msc{0};
+    mc::on_frame_presented([&](mc::FramePresentation const& presentation)
+        {
+            presented_msc = presentation.frame.msc;
+        });
+
+    EXPECT_FALSE(scope.empty());
+    EXPECT_THAT(presented_msc, Eq(0));
+
+    mc::FramePresentation presentation;
+    presentation.frame.msc = 42;
+    scope.presented(presentation);
+
+    EXPECT_THAT(presented_msc, Eq(42));
+    EXPECT_TRUE(scope.empty());
+}
+
+TEST(FramePresentation, work_runs_only_for_the_next_frame)
+{
+    mc::FramePresentationScope scope;
+
+    int runs{0};
+    mc::on_frame_presented([&](mc::FramePresentation const&) { ++runs; });
+
+    scope.presented({});
+    scope.presented({});
+
+    EXPECT_THAT(runs, Eq(1));
+}
+
+TEST(FramePresentation, outstanding_work_runs_when_scope_ends)
+{
+    bool ran{false};
+
+    {
+        mc::FramePresentationScope scope;
+        mc::on_frame_presented([&](mc::FramePresentation const&) { ran = true; });
+        EXPECT_FALSE(ran);
+    }
+
+    EXPECT_TRUE(ran);
+}
+
+TEST(FramePresentation, scope_only_collects_work_from_its_own_thread)
+{
+    mc::FramePresentationScope scope;
+
+    bool ran{false};
+    std::thread{
+        [&]
+        {
+            mc::on_frame_presented([&](mc::FramePresentation const&) { ran = true; });
+        }}.join();
+
+    EXPECT_TRUE(ran);
+    EXPECT_TRUE(scope.empty());
+}
+
+TEST(FramePresentation, only_one_scope_per_thread)
+{
+    mc::FramePresentationScope scope;
+
+    EXPECT_THROW(mc::FramePresentationScope{}, std::logic_error);
+}
@@ -18,6 +18,7 @@
 
 #include "src/server/compositor/multi_threaded_compositor.h"
 #include "src/server/report/null_report_factory.h"
+#include "mir/compositor/frame_presentation.h"
 
 #include "mir/compositor/display_listener.h"
 #include "mir/compositor/display_buffer_compositor.h"
@@ -359,6 +360,28 @@ struct MockDisplayListener : mc::DisplayListener
     MOCK_METHOD1(remove_display, void(geom::Rectangle const& /*area*/));
 };
 
+/*
+ * Reports a page flip at each vblank of a 60Hz clock, as a platform that
+ * tracks page flips does. Like a group of several outputs, its post()
+ * doesn't wait for the flip.
+ */
+struct FlippingStubDisplay : mtd::StubDisplay
+{
+    using mtd::StubDisplay::StubDisplay;
+
+    mg::Frame last_frame_on(unsigned) const override
+    {
+        auto const now = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+        mg::Frame frame;
+        frame.msc = now.nanoseconds / refresh_interval;
+        frame.ust = mir::time::PosixTimestamp{CLOCK_MONOTONIC, frame.msc * refresh_interval};
+        return frame;
+    }
+
+    std::chrono::nanoseconds const refresh_interval{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>{1.0 / 60.0})};
+};
+
 auto const null_report = mr::null_compositor_report();
 unsigned int const composites_per_update{1};
 auto const null_display_listener = std::make_shared<StubDisplayListener>();
@@ -662,6 +685,170 @@ TEST(MultiThreadedCompositor, recommended_sleep_throttles_compositor_loop)
     compositor.stop();
 }
 
+TEST(MultiThreadedCompositor, composing_before_vblank_paces_by_output_refresh_rate)
+{
+    using namespace testing;
+    using namespace std::chrono;
+
+    unsigned int const nbuffers = 2;
+    milliseconds const no_delay{0};
+    auto const frame_interval = duration_cast<milliseconds>(duration<double>{1.0 / 60.0});
+
+    // StubDisplay's outputs all refresh at 60Hz
+    auto display = std::make_shared<FlippingStubDisplay>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto factory = std::make_shared<RecordingDisplayBufferCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{display, scene, factory,
+                                           null_display_listener, null_report,
+                                           no_delay, false, true};
+
+    compositor.start();
+
+    int const max_retries = 100;
+    int const nframes = 10;
+    auto start = steady_clock::now();
+
+    for (int frame = 1; frame <= nframes; ++frame)
+    {
+        scene->emit_change_event();
+
+        int retry = 0;
+        while (retry < max_retries &&
+               !factory->check_record_count_for_each_buffer(nbuffers, frame))
+        {
+            std::this_thread::sleep_for(milliseconds(1));
+            ++retry;
+        }
+        ASSERT_LT(retry, max_retries);
+    }
+
+    auto duration = steady_clock::now() - start;
+    // Minus 2 because the first won't be paced, and the last not detected.
+    // Allow for the (tiny) render times the compositor has measured.
+    int minimum = (frame_interval.count() - 2) * (nframes - 2);
+    ASSERT_THAT(duration_cast<milliseconds>(duration).count(),
+                Ge(minimum));
+
+    compositor.stop();
+}
+
+TEST(MultiThreadedCompositor, composing_before_vblank_does_not_pace_without_page_flips)
+{
+    using namespace testing;
+    using namespace std::chrono;
+
+    unsigned int const nbuffers = 2;
+    milliseconds const no_delay{0};
+    auto const frame_interval = duration_cast<milliseconds>(duration<double>{1.0 / 60.0});
+
+    // StubDisplay's outputs refresh at 60Hz, but it reports no page flips to time frames from
+    auto display = std::make_shared<mtd::StubDisplay>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto factory = std::make_shared<RecordingDisplayBufferCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{display, scene, factory,
+                                           null_display_listener, null_report,
+                                           no_delay, false, true};
+
+    compositor.start();
+
+    int const max_retries = 100;
+    int const nframes = 10;
+    auto start = steady_clock::now();
+
+    for (int frame = 1; frame <= nframes; ++frame)
+    {
+        scene->emit_change_event();
+
+        int retry = 0;
+        while (retry < max_retries &&
+               !factory->check_record_count_for_each_buffer(nbuffers, frame))
+        {
+            std::this_thread::sleep_for(milliseconds(1));
+            ++retry;
+        }
+        ASSERT_LT(retry, max_retries);
+    }
+
+    auto duration = steady_clock::now() - start;
+    // Paced, the frames would take at least this long
+    int paced_minimum = (frame_interval.count() - 2) * (nframes - 2);
+    ASSERT_THAT(duration_cast<milliseconds>(duration).count(),
+                Lt(paced_minimum));
+
+    compositor.stop();
+}
+
+TEST(MultiThreadedCompositor, work_deferred_while_compositing_runs_once_the_frame_is_posted)
+{
+    using namespace testing;
+    using namespace std::chrono;
+
+    std::mutex mutex;
+    std::vector<mc::FramePresentation> presentations;
+    int composites{0};
+    bool deferred{false};
+
+    class DeferringDisplayBufferCompositorFactory : public mc::DisplayBufferCompositorFactory
+    {
+    public:
+        explicit DeferringDisplayBufferCompositorFactory(std::function<void()> const& on_composite)
+            : on_composite{on_composite}
+        {
+        }
+
+        std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer&) override
+        {
+            return std::make_unique<RecordingDisplayBufferCompositor>(on_composite);
+        }
+
+    private:
+        std::function<void()> const on_composite;
+    };
+
+    // StubDisplay's outputs all refresh at 60Hz
+    auto display = std::make_shared<mtd::StubDisplay>(1);
+    auto scene = std::make_shared<StubScene>();
+    auto factory = std::make_shared<DeferringDisplayBufferCompositorFactory>(
+        [&]
+        {
+            mc::on_frame_presented(
+                [&](mc::FramePresentation const& presentation)
+                {
+                    std::lock_guard<std::mutex> lock{mutex};
+                    presentations.push_back(presentation);
+                });
+
+            // Nothing is presented until the whole (first) frame has been composited
+            std::lock_guard<std::mutex> lock{mutex};
+            if (composites++ == 0)
+                deferred = presentations.empty();
+        });
+    mc::MultiThreadedCompositor compositor{display, scene, factory,
+                                           null_display_listener, null_report,
+                                           default_delay, true};
+
+    compositor.start();
+
+    for (int retry = 0; retry != 100; ++retry)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!presentations.empty())
+                break;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+
+    compositor.stop();
+
+    std::lock_guard<std::mutex> lock{mutex};
+    ASSERT_THAT(presentations, Not(IsEmpty()));
+    EXPECT_TRUE(deferred);
+    EXPECT_TRUE(presentations.front().output);
+    EXPECT_THAT(presentations.front().refresh_interval,
+                Eq(duration_cast<nanoseconds>(duration<double>{1.0 / 60.0})));
+}
+
 TEST(MultiThreadedCompositor, when_no_initial_composite_is_needed_there_is_none)
 {
     using namespace testing;
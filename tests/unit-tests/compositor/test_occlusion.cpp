@@ -17,6 +17,7 @@
  */
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
 #include "src/server/compositor/occlusion.h"
 #include "mir/test/doubles/fake_renderable.h"
 #include "mir/test/doubles/stub_scene_element.h"
@@ -202,3 +203,56 @@ TEST_F(OcclusionFilterTest,
     EXPECT_THAT(renderables_from(occlusions), ElementsAre(partially_onscreen));
     EXPECT_THAT(renderables_from(elements), ElementsAre(covering));
 }
+
+TEST_F(OcclusionFilterTest, window_covered_by_several_windows_occluded)
+{
+    auto const left = std::make_shared<mtd::FakeRenderable>(0, 0, 50, 100);
+    auto const right = std::make_shared<mtd::FakeRenderable>(50, 0, 50, 100);
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 80, 80);
+    auto elements = scene_elements_from({bottom, left, right});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), ElementsAre(bottom));
+    EXPECT_THAT(renderables_from(elements), ElementsAre(left, right));
+}
+
+TEST_F(OcclusionFilterTest, window_partly_uncovered_by_several_windows_not_occluded)
+{
+    auto const left = std::make_shared<mtd::FakeRenderable>(0, 0, 50, 100);
+    auto const right = std::make_shared<mtd::FakeRenderable>(51, 0, 50, 100);
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(10, 10, 80, 80);
+    auto elements = scene_elements_from({bottom, left, right});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), IsEmpty());
+    EXPECT_THAT(renderables_from(elements), ElementsAre(bottom, left, right));
+}
+
+TEST_F(OcclusionFilterTest, shaped_window_occludes_with_its_opaque_region)
+{
+    auto const top = std::make_shared<mtd::FakeRenderable>(Rectangle{{0, 0}, {100, 100}}, 1.0f, false);
+    top->set_opaque_region(Rectangles{{{10, 10}, {80, 80}}});
+    auto const covered = std::make_shared<mtd::FakeRenderable>(20, 20, 50, 50);
+    auto const under_shadow = std::make_shared<mtd::FakeRenderable>(5, 5, 50, 50);
+    auto elements = scene_elements_from({under_shadow, covered, top});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), ElementsAre(covered));
+    EXPECT_THAT(renderables_from(elements), ElementsAre(under_shadow, top));
+}
+
+TEST_F(OcclusionFilterTest, translucent_window_ignores_its_opaque_region)
+{
+    auto const top = std::make_shared<mtd::FakeRenderable>(Rectangle{{0, 0}, {100, 100}}, 0.5f, false);
+    top->set_opaque_region(Rectangles{{{0, 0}, {100, 100}}});
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(20, 20, 50, 50);
+    auto elements = scene_elements_from({bottom, top});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), IsEmpty());
+    EXPECT_THAT(renderables_from(elements), ElementsAre(bottom, top));
+}
@@ -241,3 +241,42 @@ TEST_F(Stream, DISABLED_stream_remembers_scale_when_buffer_added)
     stream.submit_buffer(buffers[0]);
     ASSERT_THAT(stream.stream_size(), Eq(initial_size / 2));
 }
+
+TEST_F(Stream, accumulates_damage_between_submissions)
+{
+    stream.submit_buffer(buffers[0], geom::Rectangles{{{0, 0}, {1, 1}}});
+    stream.submit_buffer(buffers[1], geom::Rectangles{{{1, 0}, {2, 1}}});
+    stream.submit_buffer(buffers[2], geom::Rectangles{{{3, 1}, {4, 1}}});
+
+    auto const damage = stream.damage_between(buffers[0]->id(), buffers[2]->id());
+
+    ASSERT_TRUE(damage);
+    EXPECT_THAT(damage.value(), Eq(geom::Rectangles{{{1, 0}, {2, 1}}, {{3, 1}, {4, 1}}}));
+}
+
+TEST_F(Stream, damage_is_unknown_when_a_submission_had_no_damage)
+{
+    stream.submit_buffer(buffers[0], geom::Rectangles{{{0, 0}, {1, 1}}});
+    stream.submit_buffer(buffers[1]);
+    stream.submit_buffer(buffers[2], geom::Rectangles{{{3, 1}, {4, 1}}});
+
+    EXPECT_FALSE(stream.damage_between(buffers[0]->id(), buffers[2]->id()));
+    EXPECT_TRUE(stream.damage_between(buffers[1]->id(), buffers[2]->id()));
+}
+
+TEST_F(Stream, damage_is_unknown_for_buffers_it_has_not_seen)
+{
+    stream.submit_buffer(buffers[1], geom::Rectangles{{{0, 0}, {1, 1}}});
+
+    EXPECT_FALSE(stream.damage_between(buffers[0]->id(), buffers[1]->id()));
+}
+
+TEST_F(Stream, damage_is_unknown_across_a_resize)
+{
+    auto const resized = std::make_shared<mtd::StubBuffer>(geom::Size{88, 4});
+
+    stream.submit_buffer(buffers[0], geom::Rectangles{{{0, 0}, {1, 1}}});
+    stream.submit_buffer(resized, geom::Rectangles{{{0, 0}, {1, 1}}});
+
+    EXPECT_FALSE(stream.damage_between(buffers[0]->id(), resized->id()));
+}
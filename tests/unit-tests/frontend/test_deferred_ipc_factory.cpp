@@ -0,0 +1,298 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/deferred_ipc_factory.h"
+#include "mir/frontend/connection_context.h"
+#include "mir/frontend/session_credentials.h"
+#include "mir/server_action_queue.h"
+
+#include "mir/test/auto_unblock_thread.h"
+#include "mir/test/fake_shared.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace mf = mir::frontend;
+namespace mt = mir::test;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct StubIpcFactory : mf::ProtobufIpcFactory
+{
+    std::shared_ptr<mf::detail::DisplayServer> make_ipc_server(
+        mf::SessionCredentials const&,
+        std::shared_ptr<mf::EventSinkFactory> const&,
+        std::shared_ptr<mf::MessageSender> const&,
+        mf::ConnectionContext const&) override
+    {
+        ++ipc_servers_made;
+        return nullptr;
+    }
+
+    std::shared_ptr<mf::ResourceCache> resource_cache() override
+    {
+        ++resource_caches_taken;
+        return nullptr;
+    }
+
+    std::atomic<int> ipc_servers_made{0};
+    std::atomic<int> resource_caches_taken{0};
+};
+
+/// Runs actions on its own thread, as the main loop does
+class ThreadedActionQueue : public mir::ServerActionQueue
+{
+public:
+    ThreadedActionQueue()
+        : thread{[this] { run(); }}
+    {
+    }
+
+    ~ThreadedActionQueue()
+    {
+        enqueue_with_guaranteed_execution([this] { running = false; });
+    }
+
+    void enqueue(void const*, mir::ServerAction const& action) override
+    {
+        enqueue_with_guaranteed_execution(action);
+    }
+
+    void enqueue_with_guaranteed_execution(mir::ServerAction const& action) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        actions.push_back(action);
+        actions_changed.notify_all();
+    }
+
+    void pause_processing_for(void const*) override {}
+    void resume_processing_for(void const*) override {}
+
+    std::thread::id const& id() const { return thread_id; }
+
+private:
+    void run()
+    {
+        thread_id = std::this_thread::get_id();
+        while (running)
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            actions_changed.wait(lock, [this] { return !actions.empty(); });
+            auto const action = actions.front();
+            actions.pop_front();
+            lock.unlock();
+
+            action();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable actions_changed;
+    std::deque<mir::ServerAction> actions;
+    bool running{true};
+    std::thread::id thread_id;
+    mt::AutoJoinThread thread;
+};
+
+/// Runs actions on the calling thread, as the main loop does when it isn't running
+struct InlineActionQueue : mir::ServerActionQueue
+{
+    void enqueue(void const*, mir::ServerAction const& action) override { action(); }
+    void enqueue_with_guaranteed_execution(mir::ServerAction const& action) override { action(); }
+    void pause_processing_for(void const*) override {}
+    void resume_processing_for(void const*) override {}
+};
+
+/// Holds on to actions until the test runs them
+class ManualActionQueue : public mir::ServerActionQueue
+{
+public:
+    void enqueue(void const*, mir::ServerAction const& action) override
+    {
+        enqueue_with_guaranteed_execution(action);
+    }
+
+    void enqueue_with_guaranteed_execution(mir::ServerAction const& action) override
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        actions.push_back(action);
+    }
+
+    void pause_processing_for(void const*) override {}
+    void resume_processing_for(void const*) override {}
+
+    auto queued() -> size_t
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return actions.size();
+    }
+
+    void run_queued()
+    {
+        std::deque<mir::ServerAction> to_run;
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            to_run.swap(actions);
+        }
+
+        for (auto const& action : to_run)
+            action();
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<mir::ServerAction> actions;
+};
+
+struct DeferredIpcFactory : Test
+{
+    auto make_counting(std::shared_ptr<StubIpcFactory> const& factory)
+        -> std::function<std::shared_ptr<mf::ProtobufIpcFactory>()>
+    {
+        return [this, factory]
+            {
+                ++made;
+                return factory;
+            };
+    }
+
+    std::shared_ptr<StubIpcFactory> const stub_factory{std::make_shared<StubIpcFactory>()};
+    std::atomic<int> made{0};
+};
+}
+
+TEST_F(DeferredIpcFactory, makes_nothing_until_created)
+{
+    auto const deferred = std::make_shared<mf::DeferredIpcFactory>(
+        make_counting(stub_factory),
+        std::make_shared<ManualActionQueue>());
+
+    EXPECT_THAT(made, Eq(0));
+
+    deferred->create();
+    deferred->create();
+
+    EXPECT_THAT(made, Eq(1));
+}
+
+TEST_F(DeferredIpcFactory, forwards_to_the_made_factory)
+{
+    auto const deferred = std::make_shared<mf::DeferredIpcFactory>(
+        make_counting(stub_factory),
+        std::make_shared<ManualActionQueue>());
+    deferred->create();
+
+    deferred->resource_cache();
+    deferred->make_ipc_server(mf::SessionCredentials{0, 0, 0}, nullptr, nullptr, mf::ConnectionContext{nullptr});
+
+    EXPECT_THAT(stub_factory->resource_caches_taken, Eq(1));
+    EXPECT_THAT(stub_factory->ipc_servers_made, Eq(1));
+}
+
+TEST_F(DeferredIpcFactory, first_use_makes_the_factory_on_the_main_loop)
+{
+    ThreadedActionQueue main_loop;
+    std::thread::id made_on;
+
+    auto const deferred = std::make_shared<mf::DeferredIpcFactory>(
+        [&]() -> std::shared_ptr<mf::ProtobufIpcFactory>
+        {
+            made_on = std::this_thread::get_id();
+            return stub_factory;
+        },
+        mt::fake_shared(main_loop));
+
+    deferred->resource_cache();
+
+    EXPECT_THAT(made_on, Eq(main_loop.id()));
+    EXPECT_THAT(made_on, Ne(std::this_thread::get_id()));
+    EXPECT_THAT(stub_factory->resource_caches_taken, Eq(1));
+}
+
+TEST_F(DeferredIpcFactory, first_use_waits_for_the_main_loop_to_make_the_factory)
+{
+    auto const main_loop = std::make_shared<ManualActionQueue>();
+    auto const deferred = std::make_shared<mf::DeferredIpcFactory>(make_counting(stub_factory), main_loop);
+
+    std::atomic<bool> used{false};
+    mt::AutoJoinThread const connection{[&] { deferred->resource_cache(); used = true; }};
+
+    while (!main_loop->queued())
+        std::this_thread::yield();
+    std::this_thread::sleep_for(10ms);
+
+    EXPECT_FALSE(used);
+    EXPECT_THAT(made, Eq(0));
+
+    main_loop->run_queued();
+
+    while (!used)
+        std::this_thread::yield();
+
+    EXPECT_THAT(made, Eq(1));
+}
+
+TEST_F(DeferredIpcFactory, factories_first_used_together_are_made_once_and_one_at_a_time)
+{
+    auto const main_loop = std::make_shared<InlineActionQueue>();
+    std::atomic<int> making{0};
+    std::atomic<bool> overlapped{false};
+
+    auto const make = [&]() -> std::shared_ptr<mf::ProtobufIpcFactory>
+        {
+            if (++making > 1)
+                overlapped = true;
+            std::this_thread::sleep_for(1ms);
+            --making;
+            ++made;
+            return stub_factory;
+        };
+
+    auto const normal = std::make_shared<mf::DeferredIpcFactory>(make, main_loop);
+    auto const prompt = std::make_shared<mf::DeferredIpcFactory>(make, main_loop);
+
+    {
+        std::vector<mt::AutoJoinThread> connections;
+        for (auto i = 0; i != 8; ++i)
+        {
+            auto const& deferred = i % 2 ? normal : prompt;
+            connections.emplace_back([deferred] { deferred->resource_cache(); });
+        }
+    }
+
+    EXPECT_THAT(made, Eq(2));
+    EXPECT_FALSE(overlapped);
+    EXPECT_THAT(stub_factory->resource_caches_taken, Eq(8));
+}
+
+TEST_F(DeferredIpcFactory, failure_to_make_the_factory_is_reported_to_its_users)
+{
+    auto const deferred = std::make_shared<mf::DeferredIpcFactory>(
+        []() -> std::shared_ptr<mf::ProtobufIpcFactory> { throw std::runtime_error{"no screencast"}; },
+        std::make_shared<ManualActionQueue>());
+
+    EXPECT_THROW(deferred->create(), std::runtime_error);
+    EXPECT_THROW(deferred->resource_cache(), std::runtime_error);
+}
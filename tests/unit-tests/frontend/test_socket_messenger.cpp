@@ -0,0 +1,322 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/socket_messenger.h"
+#include "mir/fd_socket_transmission.h"
+
+#include <boost/asio.hpp>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <limits>
+#include <string>
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mf = mir::frontend;
+namespace mfd = mf::detail;
+namespace ba = boost::asio;
+
+using namespace testing;
+
+namespace
+{
+auto const unlimited = std::numeric_limits<size_t>::max();
+
+/// The socket whose writes are limited, or -1 for none
+std::atomic<int> limited_socket{-1};
+/// How many more bytes the client has room for on limited_socket
+std::atomic<size_t> client_room{unlimited};
+std::atomic<int> sends{0};
+}
+
+// Lets the tests decide how much the "client" accepts before it stops reading
+extern "C" ssize_t sendmsg(int socket, msghdr const* message, int flags)
+{
+    static auto const real_sendmsg =
+        reinterpret_cast<ssize_t(*)(int, msghdr const*, int)>(dlsym(RTLD_NEXT, "sendmsg"));
+
+    if (socket != limited_socket)
+        return real_sendmsg(socket, message, flags);
+
+    ++sends;
+
+    size_t const room = client_room;
+    if (room == 0)
+    {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    std::vector<iovec> iov;
+    size_t remaining = room;
+    for (size_t i = 0; i != message->msg_iovlen && remaining; ++i)
+    {
+        auto const length = std::min(message->msg_iov[i].iov_len, remaining);
+        iov.push_back({message->msg_iov[i].iov_base, length});
+        remaining -= length;
+    }
+
+    auto limited_message = *message;
+    limited_message.msg_iov = iov.data();
+    limited_message.msg_iovlen = iov.size();
+
+    auto const sent = real_sendmsg(socket, &limited_message, flags);
+    if (sent > 0 && room != unlimited)
+        client_room -= sent;
+    return sent;
+}
+
+namespace
+{
+struct SocketMessenger : Test
+{
+    SocketMessenger()
+    {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+            throw std::system_error(errno, std::system_category(), "Failed to create socket pair");
+
+        server_socket = std::make_shared<ba::local::stream_protocol::socket>(
+            io_service, ba::local::stream_protocol(), fds[0]);
+        client = mir::Fd{fds[1]};
+        messenger = std::make_shared<mfd::SocketMessenger>(server_socket);
+
+        limited_socket = fds[0];
+        client_room = unlimited;
+        sends = 0;
+    }
+
+    ~SocketMessenger()
+    {
+        limited_socket = -1;
+        client_room = unlimited;
+    }
+
+    // Lets the "client" accept everything and runs the pending flushes
+    void client_catches_up()
+    {
+        client_room = unlimited;
+        io_service.poll();
+        io_service.reset();
+    }
+
+    static auto framed(std::string const& payload) -> std::string
+    {
+        return std::string{
+            static_cast<char>((payload.size() >> 8) & 0xff),
+            static_cast<char>((payload.size() >> 0) & 0xff)} + payload;
+    }
+
+    auto receive(size_t bytes) -> std::string
+    {
+        std::string received(bytes, '\0');
+        std::vector<mir::Fd> no_fds;
+        mir::receive_data(client, &received[0], bytes, no_fds);
+        return received;
+    }
+
+    auto receive_fds(size_t count) -> std::vector<mir::Fd>
+    {
+        char dummy;
+        std::vector<mir::Fd> fds(count);
+        mir::receive_data(client, &dummy, 1, fds);
+        return fds;
+    }
+
+    auto client_has_data() -> bool
+    {
+        char byte;
+        return recv(client, &byte, 1, MSG_PEEK | MSG_DONTWAIT) > 0;
+    }
+
+    void send(std::string const& payload, mf::FdSets const& fds = {})
+    {
+        messenger->send(payload.data(), payload.size(), fds);
+    }
+
+    // Each pipe is a distinct file, so the fds received can be told apart
+    static auto make_fd() -> mir::Fd
+    {
+        int pipe_fds[2];
+        if (pipe2(pipe_fds, O_CLOEXEC))
+            throw std::system_error(errno, std::system_category(), "Failed to create pipe");
+
+        mir::Fd{pipe_fds[1]};
+        return mir::Fd{pipe_fds[0]};
+    }
+
+    static auto same_file(int lhs, int rhs) -> bool
+    {
+        struct stat lhs_stat, rhs_stat;
+        return fstat(lhs, &lhs_stat) == 0 && fstat(rhs, &rhs_stat) == 0 &&
+            lhs_stat.st_dev == rhs_stat.st_dev && lhs_stat.st_ino == rhs_stat.st_ino;
+    }
+
+    ba::io_service io_service;
+    std::shared_ptr<ba::local::stream_protocol::socket> server_socket;
+    mir::Fd client;
+    std::shared_ptr<mfd::SocketMessenger> messenger;
+};
+}
+
+TEST_F(SocketMessenger, sends_message_with_its_length)
+{
+    send("Hello");
+
+    EXPECT_THAT(receive(7), Eq(framed("Hello")));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, completes_partially_written_header)
+{
+    client_room = 1;
+    send("Hello");
+
+    EXPECT_THAT(receive(1), Eq(framed("Hello").substr(0, 1)));
+    EXPECT_FALSE(client_has_data());
+
+    client_catches_up();
+
+    EXPECT_THAT(receive(6), Eq(framed("Hello").substr(1)));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, completes_partially_written_payload)
+{
+    client_room = 4;
+    send("Hello");
+
+    EXPECT_THAT(receive(4), Eq(framed("Hello").substr(0, 4)));
+    EXPECT_FALSE(client_has_data());
+
+    client_catches_up();
+
+    EXPECT_THAT(receive(3), Eq(framed("Hello").substr(4)));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, completes_a_write_split_many_times)
+{
+    std::string const payload(1000, 'x');
+    std::string received;
+
+    client_room = 0;
+    send(payload);
+
+    while (received.size() != payload.size() + 2)
+    {
+        auto const chunk = std::min<size_t>(7, payload.size() + 2 - received.size());
+        client_room = chunk;
+        io_service.poll_one();
+        io_service.reset();
+        received += receive(chunk);
+    }
+
+    EXPECT_THAT(received, Eq(framed(payload)));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, fds_queued_behind_pending_data_arrive_after_it_in_order)
+{
+    auto const first_fd = make_fd();
+    auto const second_fd = make_fd();
+    auto const third_fd = make_fd();
+
+    client_room = 3;
+    send("First", {{first_fd}, {second_fd}});
+    send("Second", {{third_fd}});
+
+    EXPECT_THAT(receive(3), Eq(framed("First").substr(0, 3)));
+    EXPECT_FALSE(client_has_data());
+
+    client_catches_up();
+
+    EXPECT_THAT(receive(4), Eq(framed("First").substr(3)));
+    auto const first_received = receive_fds(1);
+    auto const second_received = receive_fds(1);
+    EXPECT_THAT(receive(8), Eq(framed("Second")));
+    auto const third_received = receive_fds(1);
+
+    EXPECT_TRUE(same_file(first_received[0], first_fd));
+    EXPECT_TRUE(same_file(second_received[0], second_fd));
+    EXPECT_TRUE(same_file(third_received[0], third_fd));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, fds_the_client_is_not_ready_for_are_sent_later)
+{
+    auto const fd = make_fd();
+
+    // The message is written, the fds wait
+    client_room = 7;
+    send("Hello", {{fd}});
+    client_room = 0;
+    send("World");
+
+    EXPECT_THAT(receive(7), Eq(framed("Hello")));
+    EXPECT_FALSE(client_has_data());
+
+    client_catches_up();
+
+    auto const received = receive_fds(1);
+    EXPECT_TRUE(same_file(received[0], fd));
+    EXPECT_THAT(receive(7), Eq(framed("World")));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, batches_queued_messages_into_one_write)
+{
+    client_room = 0;
+    send("One");
+    send("Two");
+    send("Three");
+
+    sends = 0;
+    client_catches_up();
+
+    EXPECT_THAT(sends, Eq(1));
+    EXPECT_THAT(receive(17), Eq(framed("One") + framed("Two") + framed("Three")));
+    EXPECT_FALSE(client_has_data());
+}
+
+TEST_F(SocketMessenger, disconnects_client_that_falls_more_than_a_megabyte_behind)
+{
+    std::string const payload(60000, 'x');
+    size_t const max_pending_bytes{1024 * 1024};
+
+    client_room = 0;
+
+    size_t pending{0};
+    while (pending + payload.size() + 2 <= max_pending_bytes)
+    {
+        ASSERT_NO_THROW(send(payload));
+        pending += payload.size() + 2;
+    }
+
+    EXPECT_THROW(send(payload), std::runtime_error);
+    EXPECT_THROW(send(payload), std::runtime_error);
+
+    char byte;
+    EXPECT_THAT(recv(client, &byte, 1, MSG_DONTWAIT), Eq(0));
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/gl/default_program_factory.h"
+#include "mir/gl/texture_cache.h"
+#include "mir/renderer/gl/texture_source.h"
+
+#include "mir/test/doubles/mock_gl_buffer.h"
+#include "mir/test/doubles/mock_renderable.h"
+#include "mir/test/doubles/mock_gl.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+struct MockIncrementalGLBuffer : mtd::MockGLBuffer, mir::renderer::gl::IncrementalTextureSource
+{
+    MockIncrementalGLBuffer(mg::BufferID id, geom::Size size) :
+        MockGLBuffer{size, geom::Stride{size.width.as_int() * 4}, mir_pixel_format_argb_8888}
+    {
+        ON_CALL(*this, id()).WillByDefault(Return(id));
+    }
+
+    MOCK_METHOD1(update_texture, void(geom::Rectangles const&));
+};
+
+struct RecentlyUsedCache : Test
+{
+    RecentlyUsedCache()
+    {
+        ON_CALL(renderable, id()).WillByDefault(Return(&renderable));
+    }
+
+    void show(std::shared_ptr<mg::Buffer> const& buffer)
+    {
+        EXPECT_CALL(renderable, buffer()).WillRepeatedly(Return(buffer));
+        cache->load(renderable);
+    }
+
+    NiceMock<mtd::MockGL> mock_gl;
+    mir::gl::DefaultProgramFactory factory;
+    std::unique_ptr<mir::gl::TextureCache> const cache{factory.create_texture_cache()};
+    NiceMock<mtd::MockRenderable> renderable;
+
+    geom::Size const size{64, 32};
+    geom::Rectangles const damage{{{0, 4}, {8, 8}}};
+    std::shared_ptr<MockIncrementalGLBuffer> const first{
+        std::make_shared<NiceMock<MockIncrementalGLBuffer>>(mg::BufferID{1}, size)};
+    std::shared_ptr<MockIncrementalGLBuffer> const second{
+        std::make_shared<NiceMock<MockIncrementalGLBuffer>>(mg::BufferID{2}, size)};
+};
+}
+
+TEST_F(RecentlyUsedCache, uploads_only_damage_of_buffer_with_same_shape)
+{
+    show(first);
+
+    EXPECT_CALL(renderable, damage_since(mg::BufferID{1})).WillOnce(Return(damage));
+    EXPECT_CALL(*second, update_texture(damage));
+    EXPECT_CALL(*second, bind()).Times(0);
+
+    show(second);
+}
+
+TEST_F(RecentlyUsedCache, binds_whole_buffer_when_damage_is_unknown)
+{
+    show(first);
+
+    EXPECT_CALL(renderable, damage_since(_)).WillOnce(Return(std::experimental::nullopt));
+    EXPECT_CALL(*second, update_texture(_)).Times(0);
+    EXPECT_CALL(*second, bind());
+
+    show(second);
+}
+
+TEST_F(RecentlyUsedCache, binds_whole_buffer_when_size_changes)
+{
+    auto const resized = std::make_shared<NiceMock<MockIncrementalGLBuffer>>(mg::BufferID{2}, geom::Size{32, 32});
+    show(first);
+
+    ON_CALL(renderable, damage_since(_)).WillByDefault(Return(damage));
+    EXPECT_CALL(*resized, update_texture(_)).Times(0);
+    EXPECT_CALL(*resized, bind());
+
+    show(resized);
+}
+
+TEST_F(RecentlyUsedCache, binds_whole_buffer_after_invalidate)
+{
+    show(first);
+    cache->invalidate();
+
+    ON_CALL(renderable, damage_since(_)).WillByDefault(Return(damage));
+    EXPECT_CALL(*second, update_texture(_)).Times(0);
+    EXPECT_CALL(*second, bind());
+
+    show(second);
+}
+
+TEST_F(RecentlyUsedCache, binds_whole_buffer_after_one_backed_by_an_egl_image)
+{
+    auto const egl_image_backed = std::make_shared<NiceMock<mtd::MockGLBuffer>>(
+        size, geom::Stride{size.width.as_int() * 4}, mir_pixel_format_argb_8888);
+    ON_CALL(*egl_image_backed, id()).WillByDefault(Return(mg::BufferID{1}));
+    show(egl_image_backed);
+
+    ON_CALL(renderable, damage_since(_)).WillByDefault(Return(damage));
+    EXPECT_CALL(*second, update_texture(_)).Times(0);
+    EXPECT_CALL(*second, bind());
+
+    show(second);
+}
@@ -283,3 +283,37 @@ TEST_F(InputEventBuilder, when_deserialized_input_device_state_event_has_supplie
         EXPECT_THAT(mir_input_device_state_event_device_pressed_keys_for_index(ids_event, 2, i), Eq(pressed_keys[i]));
     }
 }
+
+TEST_F(InputEventBuilder, reuses_storage_of_deleted_events)
+{
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        mir_pointer_action_motion, 0, 1, 2, 0, 0, 0, 0);
+    MirEvent const* const first_storage = ev.get();
+    ev.reset();
+
+    ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        mir_pointer_action_motion, 0, 3, 4, 0, 0, 0, 0);
+
+    EXPECT_THAT(ev.get(), Eq(first_storage));
+    auto pev = mir_input_event_get_pointer_event(mir_event_get_input_event(ev.get()));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_x), Eq(3));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_y), Eq(4));
+}
+
+TEST_F(InputEventBuilder, clones_events_too_large_for_inline_storage)
+{
+    std::vector<uint8_t> large_cookie(4096);
+    for (size_t i = 0; i != large_cookie.size(); ++i)
+        large_cookie[i] = i % 251;
+
+    auto ev = mev::make_event(device_id, timestamp, large_cookie, modifiers,
+        mir_pointer_action_motion, 0, 5, 6, 0, 0, 0, 0);
+
+    auto const clone = mev::clone_event(*ev);
+
+    auto const input_event = mir_event_get_input_event(clone.get());
+    auto pev = mir_input_event_get_pointer_event(input_event);
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_x), Eq(5));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_y), Eq(6));
+    EXPECT_THAT(clone->to_input()->cookie(), Eq(large_cookie));
+}
@@ -18,6 +18,7 @@
 
 #include "src/server/input/seat_input_device_tracker.h"
 #include "src/server/input/default_event_builder.h"
+#include "src/server/report/null_report_factory.h"
 
 #include "mir/input/xkb_mapper.h"
 #include "mir/test/doubles/mock_input_device.h"
@@ -68,7 +69,8 @@ struct SeatInputDeviceTracker : ::testing::Test
     mi::receiver::XKBMapper mapper;
     mi::SeatInputDeviceTracker tracker{
         mt::fake_shared(mock_dispatcher), mt::fake_shared(mock_visualizer), mt::fake_shared(mock_cursor_listener),
-        mt::fake_shared(mapper),          mt::fake_shared(clock),           mt::fake_shared(mock_seat_report)};
+        mt::fake_shared(mapper),          mt::fake_shared(clock),           mt::fake_shared(mock_seat_report),
+        mir::report::null_input_report()};
 
     std::chrono::nanoseconds arbitrary_timestamp;
 };
@@ -17,6 +17,7 @@
  */
 
 #include "src/server/input/surface_input_dispatcher.h"
+#include "src/server/report/null_report_factory.h"
 
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h"
@@ -120,7 +121,7 @@ struct StubInputScene : public mtd::StubInputScene
 struct SurfaceInputDispatcher : public testing::Test
 {
     SurfaceInputDispatcher()
-        : dispatcher(mt::fake_shared(scene))
+        : dispatcher(mt::fake_shared(scene), mir::report::null_input_report())
     {
     }
 
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/logging/input_report.h"
+#include "src/server/report/logging/latency_histogram.h"
+#include "mir/logging/logger.h"
+#include "mir/test/doubles/advanceable_clock.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace mtd = mir::test::doubles;
+namespace mrl = mir::report::logging;
+namespace ml = mir::logging;
+namespace mi = mir::input;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+
+class Recorder : public ml::Logger
+{
+public:
+    void log(ml::Severity, std::string const& message, std::string const&) override
+    {
+        messages.push_back(message);
+    }
+
+    std::vector<std::string> messages;
+};
+
+struct LoggingInputReport : Test
+{
+    std::shared_ptr<mtd::AdvanceableClock> const clock = std::make_shared<mtd::AdvanceableClock>();
+    std::shared_ptr<Recorder> const recorder = std::make_shared<Recorder>();
+    mrl::InputReport report{recorder, clock};
+
+    int64_t now() const
+    {
+        return duration_cast<nanoseconds>(clock->now().time_since_epoch()).count();
+    }
+
+    void event_reaches_every_stage(int64_t device_id, milliseconds stage_latency)
+    {
+        auto const event_time = now();
+
+        for (auto stage : {mi::InputEventStage::platform, mi::InputEventStage::seat,
+                           mi::InputEventStage::surface, mi::InputEventStage::client})
+        {
+            clock->advance_by(stage_latency);
+            report.input_event_reached(stage, device_id, event_time);
+        }
+    }
+};
+}
+
+TEST(LatencyHistogram, percentiles_are_within_a_sixteenth)
+{
+    mrl::LatencyHistogram histogram;
+
+    for (int i = 1; i <= 100; ++i)
+        histogram.record(milliseconds{i});
+
+    auto const snapshot = histogram.take();
+
+    EXPECT_THAT(snapshot.count(), Eq(100u));
+    EXPECT_THAT(snapshot.percentile(50).count(), AllOf(Ge(50000), Le(50000 + 50000/16)));
+    EXPECT_THAT(snapshot.percentile(99).count(), AllOf(Ge(99000), Le(99000 + 99000/16)));
+    EXPECT_THAT(snapshot.percentile(100).count(), AllOf(Ge(100000), Le(100000 + 100000/16)));
+}
+
+TEST(LatencyHistogram, take_resets_the_counts)
+{
+    mrl::LatencyHistogram histogram;
+
+    histogram.record(microseconds{5});
+    histogram.take();
+
+    auto const snapshot = histogram.take();
+
+    EXPECT_THAT(snapshot.count(), Eq(0u));
+    EXPECT_THAT(snapshot.percentile(50).count(), Eq(0));
+}
+
+TEST(LatencyHistogram, small_latencies_are_exact)
+{
+    mrl::LatencyHistogram histogram;
+
+    histogram.record(microseconds{7});
+
+    EXPECT_THAT(histogram.take().percentile(50).count(), Eq(7));
+}
+
+TEST_F(LoggingInputReport, does_not_log_latencies_before_the_report_interval)
+{
+    event_reaches_every_stage(3, milliseconds{1});
+
+    EXPECT_THAT(recorder->messages, IsEmpty());
+}
+
+TEST_F(LoggingInputReport, logs_latencies_of_each_stage_per_device)
+{
+    for (int i = 0; i != 10; ++i)
+    {
+        event_reaches_every_stage(3, milliseconds{1});
+        event_reaches_every_stage(7, milliseconds{2});
+    }
+
+    clock->advance_by(seconds{10});
+    event_reaches_every_stage(3, milliseconds{1});
+
+    ASSERT_THAT(recorder->messages.size(), Eq(2u));
+    EXPECT_THAT(recorder->messages[0], StartsWith("Device 3 input latency over 11 events: platform p50 1"));
+    EXPECT_THAT(recorder->messages[0], HasSubstr(", client p50 4"));
+    EXPECT_THAT(recorder->messages[1], StartsWith("Device 7 input latency over 10 events: platform p50 2"));
+    EXPECT_THAT(recorder->messages[1], HasSubstr(", client p50 8"));
+}
+
+TEST_F(LoggingInputReport, reports_latency_of_devices_replugged_many_times)
+{
+    // Each time a device is plugged in it gets a new id
+    for (int64_t device_id = 1; device_id <= 40; ++device_id)
+    {
+        clock->advance_by(seconds{11});
+        event_reaches_every_stage(device_id, milliseconds{1});
+    }
+
+    clock->advance_by(seconds{11});
+    event_reaches_every_stage(40, milliseconds{1});
+
+    EXPECT_THAT(recorder->messages, Contains(StartsWith("Device 40 input latency")));
+    EXPECT_THAT(recorder->messages, Not(Contains(HasSubstr("More than"))));
+}
+
+TEST_F(LoggingInputReport, warns_once_when_too_many_devices_are_in_use)
+{
+    for (int64_t device_id = 1; device_id <= 20; ++device_id)
+        event_reaches_every_stage(device_id, milliseconds{1});
+
+    EXPECT_THAT(recorder->messages, ElementsAre(StartsWith("More than 16 input devices are in use")));
+}
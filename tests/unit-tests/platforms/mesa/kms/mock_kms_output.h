@@ -59,6 +59,10 @@ struct MockKMSOutput : public graphics::mesa::KMSOutput
     MOCK_METHOD1(schedule_page_flip_thunk, bool(graphics::mesa::FBHandle const*));
     MOCK_METHOD0(wait_for_page_flip, void());
 
+    MOCK_METHOD0(max_scanout_layers, size_t());
+    MOCK_METHOD1(test_scanout_layers, bool(std::vector<graphics::mesa::ScanoutLayer> const&));
+    MOCK_METHOD1(schedule_scanout_layers_flip, bool(std::vector<graphics::mesa::ScanoutLayer> const&));
+
     MOCK_CONST_METHOD0(last_frame, graphics::Frame());
 
     MOCK_METHOD1(set_cursor, bool(gbm_bo*));
@@ -503,3 +503,115 @@ TEST_F(MesaDisplayBufferTest, buffer_requiring_migration_is_ineligable_for_bypas
 
     EXPECT_FALSE(db.overlay(bypassable_list));
 }
+
+namespace
+{
+MATCHER_P(LayerDestinationsAre, destinations, "")
+{
+    if (arg.size() != destinations.size())
+        return false;
+
+    for (size_t i = 0; i != arg.size(); ++i)
+    {
+        if (arg[i].destination != destinations[i])
+            return false;
+    }
+    return true;
+}
+}
+
+TEST_F(MesaDisplayBufferTest, scanout_buffers_stacked_on_fullscreen_one_are_put_on_planes)
+{
+    geometry::Size const popup_size{10, 20};
+    auto popup_buffer = std::make_shared<NiceMock<MockBuffer>>();
+    ON_CALL(*popup_buffer, size())
+        .WillByDefault(Return(popup_size));
+    ON_CALL(*popup_buffer, native_buffer_handle())
+        .WillByDefault(Return(std::make_shared<StubGBMNativeBuffer>(popup_size)));
+    auto popup = std::make_shared<FakeRenderable>(
+        geometry::Rectangle{display_area.top_left + geometry::Displacement{5, 6}, popup_size});
+    popup->set_buffer(popup_buffer);
+
+    graphics::RenderableList const list{fake_bypassable_renderable, popup};
+
+    ON_CALL(*mock_kms_output, max_scanout_layers())
+        .WillByDefault(Return(3));
+    ON_CALL(*mock_kms_output, test_scanout_layers(_))
+        .WillByDefault(Return(true));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    std::vector<geometry::Rectangle> const destinations{
+        {{0, 0}, display_area.size},
+        {{5, 6}, popup_size}};
+
+    EXPECT_CALL(*mock_kms_output, schedule_scanout_layers_flip(LayerDestinationsAre(destinations)))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_kms_output, schedule_page_flip_thunk(_))
+        .Times(0);
+
+    auto original_count = popup_buffer.use_count();
+
+    EXPECT_TRUE(db.overlay(list));
+    db.post();
+
+    // Held until the next frame replaces it on screen
+    EXPECT_EQ(original_count+1, popup_buffer.use_count());
+}
+
+TEST_F(MesaDisplayBufferTest, planes_are_not_used_if_the_driver_rejects_the_layers)
+{
+    auto shaped_popup = std::make_shared<FakeRenderable>(display_area, 1.0f, false);
+    shaped_popup->set_buffer(mock_bypassable_buffer);
+
+    graphics::RenderableList const list{fake_bypassable_renderable, shaped_popup};
+
+    ON_CALL(*mock_kms_output, max_scanout_layers())
+        .WillByDefault(Return(3));
+    EXPECT_CALL(*mock_kms_output, test_scanout_layers(_))
+        .WillOnce(Return(false));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_FALSE(db.overlay(list));
+}
+
+TEST_F(MesaDisplayBufferTest, planes_are_not_used_for_more_renderables_than_planes)
+{
+    auto popup = std::make_shared<FakeRenderable>(display_area);
+    popup->set_buffer(mock_bypassable_buffer);
+    auto shaped_popup = std::make_shared<FakeRenderable>(display_area, 1.0f, false);
+    shaped_popup->set_buffer(mock_bypassable_buffer);
+
+    graphics::RenderableList const list{fake_bypassable_renderable, popup, shaped_popup};
+
+    ON_CALL(*mock_kms_output, max_scanout_layers())
+        .WillByDefault(Return(2));
+    ON_CALL(*mock_kms_output, test_scanout_layers(_))
+        .WillByDefault(Return(true));
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    EXPECT_CALL(*mock_kms_output, test_scanout_layers(_))
+        .Times(0);
+
+    EXPECT_FALSE(db.overlay(list));
+}
@@ -46,6 +46,7 @@ class NullPageFlipper : public mgm::PageFlipper
 {
 public:
     bool schedule_flip(uint32_t,uint32_t,uint32_t) override { return true; }
+    bool schedule_atomic_flip(uint32_t,uint32_t,drmModeAtomicReq*) override { return true; }
     mg::Frame wait_for_flip(uint32_t) override { return {}; }
 };
 
@@ -53,6 +54,7 @@ class MockPageFlipper : public mgm::PageFlipper
 {
 public:
     MOCK_METHOD3(schedule_flip, bool(uint32_t,uint32_t,uint32_t));
+    MOCK_METHOD3(schedule_atomic_flip, bool(uint32_t,uint32_t,drmModeAtomicReq*));
     MOCK_METHOD1(wait_for_flip, mg::Frame(uint32_t));
 };
 
@@ -548,3 +550,38 @@ TEST_F(RealKMSOutputTest, drm_set_gamma_failure_does_not_throw)
 
     EXPECT_NO_THROW(output.set_gamma(gamma););
 }
+
+TEST_F(RealKMSOutputTest, has_no_scanout_layers_without_atomic_support)
+{
+    using namespace testing;
+
+    setup_outputs_connected_crtc();
+
+    uint32_t const fb_id{42};
+    append_fb_id(fb_id);
+
+    ON_CALL(mock_drm, drmSetClientCap(_, DRM_CLIENT_CAP_ATOMIC, _))
+        .WillByDefault(Return(-EINVAL));
+
+    EXPECT_CALL(mock_drm, drmModeAtomicCommit(_, _, _, _))
+        .Times(0);
+    EXPECT_CALL(mock_page_flipper, schedule_atomic_flip(_, _, _))
+        .Times(0);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    auto fb = output.fb_for(fake_bo);
+
+    geom::Rectangle const full_screen{{0, 0}, {640, 480}};
+    std::vector<mgm::ScanoutLayer> const layers{
+        {fb, full_screen, full_screen},
+        {fb, full_screen, full_screen}};
+
+    EXPECT_TRUE(output.set_crtc(*fb));
+    EXPECT_THAT(output.max_scanout_layers(), Eq(0u));
+    EXPECT_FALSE(output.test_scanout_layers(layers));
+    EXPECT_FALSE(output.schedule_scanout_layers_flip(layers));
+}
@@ -466,3 +466,123 @@ TEST_F(GLRenderer, sets_viewport_downscaled_wide)
 
     mrg::Renderer renderer(mock_display_buffer);
 }
+
+TEST_F(GLRenderer, scissors_to_damage_when_back_buffer_is_current)
+{
+    mir::geometry::Rectangle const view_area{{0,0}, {1920,1080}};
+
+    ON_CALL(mock_egl, eglQueryString(_,EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_EXT_buffer_age"));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_WIDTH,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1920), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_HEIGHT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1080), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_BUFFER_AGE_EXT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1), Return(EGL_TRUE)));
+    ON_CALL(mock_display_buffer, view_area())
+        .WillByDefault(Return(view_area));
+
+    mrg::Renderer renderer(mock_display_buffer);
+    renderer.render(renderable_list);
+
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST));
+    EXPECT_CALL(mock_gl, glScissor(10, 1050, 20, 10));
+    EXPECT_CALL(mock_gl, glDisable(GL_SCISSOR_TEST));
+
+    renderer.set_damage(mir::geometry::Rectangles{{{10, 20}, {20, 10}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, repaints_everything_when_back_buffer_contents_are_undefined)
+{
+    mir::geometry::Rectangle const view_area{{0,0}, {1920,1080}};
+
+    ON_CALL(mock_egl, eglQueryString(_,EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_EXT_buffer_age"));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_WIDTH,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1920), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_HEIGHT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1080), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_BUFFER_AGE_EXT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(0), Return(EGL_TRUE)));
+    ON_CALL(mock_display_buffer, view_area())
+        .WillByDefault(Return(view_area));
+
+    mrg::Renderer renderer(mock_display_buffer);
+    renderer.render(renderable_list);
+
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST)).Times(0);
+    EXPECT_CALL(mock_gl, glScissor(_, _, _, _)).Times(0);
+
+    renderer.set_damage(mir::geometry::Rectangles{{{10, 20}, {20, 10}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, uploads_vertices_of_all_renderables_once_per_frame)
+{
+    GLuint const vertex_buffer{42};
+    ON_CALL(mock_gl, glGenBuffers(1, _))
+        .WillByDefault(SetArgPointee<1>(vertex_buffer));
+
+    auto const second = std::make_shared<testing::NiceMock<mtd::MockRenderable>>();
+    ON_CALL(*second, id()).WillByDefault(Return(second.get()));
+    ON_CALL(*second, buffer()).WillByDefault(Return(mock_buffer));
+    ON_CALL(*second, screen_position())
+        .WillByDefault(Return(mir::geometry::Rectangle{{5,6},{7,8}}));
+    renderable_list.push_back(second);
+
+    mrg::Renderer renderer(display_buffer);
+
+    EXPECT_CALL(mock_gl, glBufferData(GL_ARRAY_BUFFER, 2 * 4 * sizeof(mgl::Vertex), _, GL_STREAM_DRAW));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, 0, 4));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, 4, 4));
+
+    renderer.render(renderable_list);
+
+    EXPECT_CALL(mock_gl, glDeleteBuffers(1, Pointee(vertex_buffer)));
+}
+
+TEST_F(GLRenderer, avoids_redundant_state_changes_between_similar_renderables)
+{
+    auto const second = std::make_shared<testing::NiceMock<mtd::MockRenderable>>();
+    ON_CALL(*second, id()).WillByDefault(Return(second.get()));
+    ON_CALL(*second, buffer()).WillByDefault(Return(mock_buffer));
+    ON_CALL(*second, shaped()).WillByDefault(Return(false));
+    renderable_list.push_back(second);
+
+    mrg::Renderer renderer(display_buffer);
+
+    EXPECT_CALL(mock_gl, glUseProgram(_)).Times(1);
+    EXPECT_CALL(mock_gl, glDisable(GL_BLEND)).Times(1);
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(2);
+
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, repaints_everything_after_being_suspended)
+{
+    mir::geometry::Rectangle const view_area{{0,0}, {1920,1080}};
+
+    ON_CALL(mock_egl, eglQueryString(_,EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_EXT_buffer_age"));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_WIDTH,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1920), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_HEIGHT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1080), Return(EGL_TRUE)));
+    ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_BUFFER_AGE_EXT,_))
+        .WillByDefault(DoAll(SetArgPointee<3>(1), Return(EGL_TRUE)));
+    ON_CALL(mock_display_buffer, view_area())
+        .WillByDefault(Return(view_area));
+
+    mrg::Renderer renderer(mock_display_buffer);
+    renderer.render(renderable_list);
+
+    // A bypassed frame: the back buffer (still of age 1) holds the frame before it
+    renderer.suspend();
+
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST)).Times(0);
+    EXPECT_CALL(mock_gl, glScissor(_, _, _, _)).Times(0);
+
+    renderer.set_damage(mir::geometry::Rectangles{{{10, 20}, {20, 10}}});
+    renderer.render(renderable_list);
+}
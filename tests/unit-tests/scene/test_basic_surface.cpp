@@ -72,6 +72,7 @@ public:
     MOCK_METHOD2(cursor_image_set_to, void(ms::Surface const*, mir::graphics::CursorImage const& image));
     MOCK_METHOD1(cursor_image_removed, void(ms::Surface const*));
     MOCK_METHOD2(application_id_set_to, void(ms::Surface const*, std::string const&));
+    MOCK_METHOD2(input_region_set_to, void(ms::Surface const*, std::vector<geom::Rectangle> const&));
 };
 
 struct BasicSurfaceTest : public testing::Test
@@ -1135,6 +1136,22 @@ TEST_F(BasicSurfaceTest, does_not_notify_if_application_id_is_unchanged)
     surface.set_application_id(id);
 }
 
+TEST_F(BasicSurfaceTest, notifies_about_input_region_changes)
+{
+    using namespace testing;
+
+    std::vector<geom::Rectangle> const region{{{10, 10}, {20, 20}}};
+    NiceMock<MockSurfaceObserver> mock_surface_observer;
+
+    EXPECT_CALL(mock_surface_observer, input_region_set_to(_, region))
+        .Times(1);
+
+    surface.add_observer(mt::fake_shared(mock_surface_observer));
+
+    surface.set_input_region(region);
+    surface.set_input_region(region);
+}
+
 TEST_F(BasicSurfaceTest, observer_can_remove_itself_within_notification)
 {
     using namespace testing;
@@ -1256,6 +1273,43 @@ TEST_F(BasicSurfaceTest, moving_surface_repositions_all_associated_streams)
     EXPECT_THAT(renderables[1], IsRenderableOfPosition(pt + d));
 }
 
+TEST_F(BasicSurfaceTest, renderables_report_opaque_region_in_screen_coordinates)
+{
+    using namespace testing;
+    geom::Displacement const d{5, 6};
+    auto buffer_stream = std::make_shared<NiceMock<mtd::MockBufferStream>>();
+    ON_CALL(*buffer_stream, stream_size()).WillByDefault(Return(geom::Size{100, 100}));
+
+    std::list<ms::StreamInfo> streams = {
+        { buffer_stream, d, {}, geom::Rectangles{{{10, 10}, {20, 20}}, {{90, 90}, {20, 20}}} }
+    };
+    surface.set_streams(streams);
+
+    auto renderables = surface.generate_renderables(this);
+    ASSERT_THAT(renderables.size(), Eq(1));
+
+    auto const top_left = rect.top_left + d;
+    EXPECT_THAT(renderables[0]->opaque_region(), Eq(geom::Rectangles{
+        {top_left + geom::Displacement{10, 10}, {20, 20}},
+        {top_left + geom::Displacement{90, 90}, {10, 10}}}));
+}
+
+TEST_F(BasicSurfaceTest, renderables_of_scaled_streams_have_no_opaque_region)
+{
+    using namespace testing;
+    auto buffer_stream = std::make_shared<NiceMock<mtd::MockBufferStream>>();
+    ON_CALL(*buffer_stream, stream_size()).WillByDefault(Return(geom::Size{100, 100}));
+
+    std::list<ms::StreamInfo> streams = {
+        { buffer_stream, {0, 0}, geom::Size{50, 50}, geom::Rectangles{{{10, 10}, {20, 20}}} }
+    };
+    surface.set_streams(streams);
+
+    auto renderables = surface.generate_renderables(this);
+    ASSERT_THAT(renderables.size(), Eq(1));
+    EXPECT_THAT(renderables[0]->opaque_region(), Eq(geom::Rectangles{}));
+}
+
 TEST_F(BasicSurfaceTest, can_remove_all_streams)
 {
     using namespace testing;
@@ -21,6 +21,7 @@
 
 #include "mir/test/doubles/mock_gl_buffer.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -33,8 +34,41 @@ namespace ms = mir::scene;
 namespace mtd = mir::test::doubles;
 namespace mrgl = mir::renderer::gl;
 
+struct __GLsync;
+
 namespace
 {
+GLenum const pixel_pack_buffer{0x88EB};
+GLenum const already_signaled{0x911A};
+
+std::vector<uint32_t> pbo_pixels;
+bool waited_for_fence{false};
+
+void* fake_glMapBufferRange(GLenum, GLintptr, GLsizeiptr, GLbitfield)
+{
+    return pbo_pixels.data();
+}
+
+GLboolean fake_glUnmapBuffer(GLenum)
+{
+    return GL_TRUE;
+}
+
+__GLsync* fake_glFenceSync(GLenum, GLbitfield)
+{
+    static int fence;
+    return reinterpret_cast<__GLsync*>(&fence);
+}
+
+GLenum fake_glClientWaitSync(__GLsync*, GLbitfield, uint64_t)
+{
+    waited_for_fence = true;
+    return already_signaled;
+}
+
+void fake_glDeleteSync(__GLsync*)
+{
+}
 
 struct MockGLContext : public mrgl::Context
 {
@@ -225,3 +259,69 @@ TEST_F(GLPixelBufferTest, returns_data_from_rgba_buffer_texture)
     EXPECT_EQ(width - 1,
               static_cast<uint32_t const*>(data)[width * height - 1]);
 }
+
+TEST_F(GLPixelBufferTest, reads_back_through_pixel_buffer_object_when_supported)
+{
+    using namespace testing;
+    using FunctionPointer = mtd::MockEGL::generic_function_pointer_t;
+    GLuint const pbo{30};
+    uint32_t const width{mock_buffer.size().width.as_uint32_t()};
+    uint32_t const height{mock_buffer.size().height.as_uint32_t()};
+
+    NiceMock<mtd::MockEGL> mock_egl;
+    ON_CALL(mock_gl, glGetString(GL_VERSION))
+        .WillByDefault(Return(reinterpret_cast<GLubyte const*>("OpenGL ES 3.2 Mesa")));
+    ON_CALL(mock_egl, eglGetProcAddress(StrEq("glMapBufferRange")))
+        .WillByDefault(Return(reinterpret_cast<FunctionPointer>(&fake_glMapBufferRange)));
+    ON_CALL(mock_egl, eglGetProcAddress(StrEq("glUnmapBuffer")))
+        .WillByDefault(Return(reinterpret_cast<FunctionPointer>(&fake_glUnmapBuffer)));
+    ON_CALL(mock_egl, eglGetProcAddress(StrEq("glFenceSync")))
+        .WillByDefault(Return(reinterpret_cast<FunctionPointer>(&fake_glFenceSync)));
+    ON_CALL(mock_egl, eglGetProcAddress(StrEq("glClientWaitSync")))
+        .WillByDefault(Return(reinterpret_cast<FunctionPointer>(&fake_glClientWaitSync)));
+    ON_CALL(mock_egl, eglGetProcAddress(StrEq("glDeleteSync")))
+        .WillByDefault(Return(reinterpret_cast<FunctionPointer>(&fake_glDeleteSync)));
+
+    pbo_pixels.resize(width * height);
+    for (uint32_t i = 0; i < width * height; ++i)
+        pbo_pixels[i] = i;
+    waited_for_fence = false;
+
+    {
+        InSequence s;
+
+        /* The pixels are read into the pixel buffer object without waiting */
+        EXPECT_CALL(mock_gl, glGenBuffers(1,_))
+            .WillOnce(SetArgPointee<1>(pbo));
+        EXPECT_CALL(mock_gl, glBindBuffer(pixel_pack_buffer, pbo));
+        EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height,
+                                          GL_BGRA_EXT, GL_UNSIGNED_BYTE, nullptr));
+        EXPECT_CALL(mock_gl, glBindBuffer(pixel_pack_buffer, 0));
+        EXPECT_CALL(mock_gl, glFlush());
+
+        /* ...and mapped when they are needed */
+        EXPECT_CALL(mock_gl, glBindBuffer(pixel_pack_buffer, pbo));
+        EXPECT_CALL(mock_gl, glBindBuffer(pixel_pack_buffer, 0));
+
+        /* at destruction */
+        EXPECT_CALL(mock_gl, glDeleteBuffers(1, Pointee(pbo)));
+    }
+
+    EXPECT_CALL(mock_context, make_current()).Times(AnyNumber());
+
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer);
+    EXPECT_FALSE(waited_for_fence);
+
+    auto data = pixels.as_argb_8888();
+    EXPECT_TRUE(waited_for_fence);
+
+    /* Check that data has been properly y-flipped */
+    EXPECT_EQ(1,
+              static_cast<uint32_t const*>(data)[width * (height - 1) + 1]);
+    EXPECT_EQ(width * (height - 1),
+              static_cast<uint32_t const*>(data)[0]);
+    EXPECT_EQ(width - 1,
+              static_cast<uint32_t const*>(data)[width * height - 1]);
+}
@@ -73,6 +73,34 @@ struct MockCallback
     MOCK_METHOD0(call, void());
 };
 
+// A stream the test posts frames to, which is drawn at the size of the last one
+struct PostingBufferStream : mtd::MockBufferStream
+{
+    PostingBufferStream(bool submitted, geom::Size const& size)
+        : submitted{submitted},
+          size{size}
+    {
+        using namespace testing;
+        ON_CALL(*this, has_submitted_buffer())
+            .WillByDefault(ReturnPointee(&this->submitted));
+        ON_CALL(*this, stream_size())
+            .WillByDefault(ReturnPointee(&this->size));
+        ON_CALL(*this, set_frame_posted_callback(_))
+            .WillByDefault(SaveArg<0>(&frame_posted));
+    }
+
+    void post(geom::Size const& new_size)
+    {
+        submitted = true;
+        size = new_size;
+        frame_posted(size);
+    }
+
+    bool submitted;
+    geom::Size size;
+    std::function<void(geom::Size const&)> frame_posted;
+};
+
 struct MockSceneObserver : public ms::Observer
 {
     MOCK_METHOD1(surface_added, void(std::shared_ptr<ms::Surface> const&));
@@ -264,6 +292,167 @@ TEST_F(SurfaceStack, scene_counts_pending_accurately)
     }
 }
 
+TEST_F(SurfaceStack, scene_counts_frames_posted_after_surface_was_drained)
+{
+    using namespace testing;
+    ms::SurfaceStack stack{report};
+    stack.register_compositor(this);
+
+    auto stream = std::make_shared<mc::Stream>(geom::Size{ 1, 1 }, mir_pixel_format_abgr_8888);
+
+    auto surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{},{}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { stream, {}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+    stack.add_surface(surface, default_params.input_mode);
+
+    post_a_frame(*stream);
+    EXPECT_EQ(1, stack.frames_pending(this));
+
+    for (auto& element : stack.scene_elements_for(this))
+        element->renderable()->buffer();
+    EXPECT_EQ(0, stack.frames_pending(this));
+    EXPECT_EQ(0, stack.frames_pending(this));
+
+    post_a_frame(*stream);
+    EXPECT_EQ(1, stack.frames_pending(this));
+}
+
+TEST_F(SurfaceStack, scene_elements_are_reused_once_released)
+{
+    using namespace testing;
+    stack.register_compositor(this);
+    stack.add_surface(stub_surface1, default_params.input_mode);
+
+    auto held = stack.scene_elements_for(this);
+    ASSERT_THAT(held.size(), Eq(1u));
+
+    auto const other = stack.scene_elements_for(this);
+    ASSERT_THAT(other.size(), Eq(1u));
+    EXPECT_THAT(other.front(), Ne(held.front()));
+
+    auto const released = held.front().get();
+    held.clear();
+
+    auto const reused = stack.scene_elements_for(this);
+    ASSERT_THAT(reused.size(), Eq(1u));
+    EXPECT_THAT(reused.front().get(), Eq(released));
+    EXPECT_THAT(reused.front()->renderable()->id(), Eq(stub_buffer_stream1.get()));
+}
+
+TEST_F(SurfaceStack, scene_elements_leave_out_surfaces_outside_the_view_area)
+{
+    using namespace testing;
+
+    auto const surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{0, 0}, {100, 100}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { stub_buffer_stream1, {}, geom::Size{100, 100} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    void const* const left_output{this};
+    void const* const right_output{compositor_id};
+    void const* const unbounded{&stack};
+
+    stack.register_compositor(left_output);
+    stack.register_compositor(right_output);
+    stack.register_compositor(unbounded);
+    stack.set_view_area(left_output, {{0, 0}, {1000, 1000}});
+    stack.set_view_area(right_output, {{1000, 0}, {1000, 1000}});
+    stack.add_surface(surface, default_params.input_mode);
+
+    // Until the scene has seen where the surface is drawn, it could be anywhere
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(1u));
+    EXPECT_THAT(stack.scene_elements_for(left_output).size(), Eq(1u));
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(0u));
+    EXPECT_THAT(stack.scene_elements_for(unbounded).size(), Eq(1u));
+
+    surface->move_to({1500, 0});
+
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(1u));
+    EXPECT_THAT(stack.scene_elements_for(left_output).size(), Eq(0u));
+
+    surface->move_to({950, 0});
+
+    EXPECT_THAT(stack.scene_elements_for(left_output).size(), Eq(1u));
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(1u));
+}
+
+TEST_F(SurfaceStack, scene_elements_include_a_stream_posting_its_first_frame_in_the_view_area)
+{
+    using namespace testing;
+
+    auto const drawn_stream = std::make_shared<NiceMock<PostingBufferStream>>(true, geom::Size{100, 100});
+    auto const new_stream = std::make_shared<NiceMock<PostingBufferStream>>(false, geom::Size{});
+
+    auto const surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{0, 0}, {100, 100}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { drawn_stream, {}, {} }, { new_stream, {1200, 0}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    void const* const left_output{this};
+    void const* const right_output{compositor_id};
+
+    stack.register_compositor(left_output);
+    stack.register_compositor(right_output);
+    stack.set_view_area(left_output, {{0, 0}, {1000, 1000}});
+    stack.set_view_area(right_output, {{1000, 0}, {1000, 1000}});
+    stack.add_surface(surface, default_params.input_mode);
+
+    EXPECT_THAT(stack.scene_elements_for(left_output).size(), Eq(1u));
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(0u));
+
+    // The same size as the stream already drawn, but not where it is drawn
+    new_stream->post({100, 100});
+
+    EXPECT_THAT(stack.scene_elements_for(right_output), Contains(SceneElementForStream(new_stream)));
+}
+
+TEST_F(SurfaceStack, scene_elements_include_a_stream_resized_to_a_siblings_size_into_the_view_area)
+{
+    using namespace testing;
+
+    auto const large_stream = std::make_shared<NiceMock<PostingBufferStream>>(true, geom::Size{100, 100});
+    auto const small_stream = std::make_shared<NiceMock<PostingBufferStream>>(true, geom::Size{40, 40});
+
+    auto const surface = std::make_shared<ms::BasicSurface>(
+        nullptr /* session */,
+        std::string("stub"),
+        geom::Rectangle{{0, 0}, {100, 100}},
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo> { { large_stream, {}, {} }, { small_stream, {950, 0}, {} } },
+        std::shared_ptr<mg::CursorImage>(),
+        report);
+
+    void const* const left_output{this};
+    void const* const right_output{compositor_id};
+
+    stack.register_compositor(left_output);
+    stack.register_compositor(right_output);
+    stack.set_view_area(left_output, {{0, 0}, {1000, 1000}});
+    stack.set_view_area(right_output, {{1000, 0}, {1000, 1000}});
+    stack.add_surface(surface, default_params.input_mode);
+
+    EXPECT_THAT(stack.scene_elements_for(left_output).size(), Eq(2u));
+    EXPECT_THAT(stack.scene_elements_for(right_output).size(), Eq(0u));
+
+    // The size of the large stream, which now crosses into the right output
+    small_stream->post({100, 100});
+
+    EXPECT_THAT(stack.scene_elements_for(right_output), Contains(SceneElementForStream(small_stream)));
+}
+
 TEST_F(SurfaceStack, scene_doesnt_count_pending_frames_from_occluded_surfaces)
 {  // Regression test for LP: #1418081
     using namespace testing;
@@ -998,6 +1187,106 @@ TEST_F(SurfaceStack, returns_top_visible_surface_under_cursor)
     EXPECT_THAT(stack.surface_at(cursor_over_none).get(), IsNull());
 }
 
+TEST_F(SurfaceStack, surface_under_cursor_follows_moved_and_resized_surfaces)
+{
+    geom::Point const cursor{1500, 100};
+
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({200, 200});
+    stub_surface2->resize({200, 200});
+
+    EXPECT_THAT(stack.surface_at({100, 100}), Eq(stub_surface2));
+    EXPECT_THAT(stack.surface_at(cursor).get(), IsNull());
+
+    stub_surface2->move_to({1400, 0});
+
+    EXPECT_THAT(stack.surface_at({100, 100}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface2));
+
+    stub_surface1->resize({2000, 200});
+    stub_surface2->move_to({-1000, -1000});
+
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({-900, -900}), Eq(stub_surface2));
+}
+
+TEST_F(SurfaceStack, surface_under_cursor_follows_stacking_order)
+{
+    geom::Point const cursor{100, 100};
+
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({200, 200});
+    stub_surface2->resize({200, 200});
+
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface2));
+
+    stack.raise(stub_surface1);
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface1));
+
+    stack.remove_surface(stub_surface1);
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface2));
+
+    stack.add_surface(stub_surface3, default_params.input_mode);
+    stub_surface3->resize({200, 200});
+    EXPECT_THAT(stack.surface_at(cursor), Eq(stub_surface3));
+}
+
+TEST_F(SurfaceStack, surface_under_cursor_respects_input_region)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({1000, 1000});
+    stub_surface2->resize({100, 100});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface2));
+    EXPECT_THAT(stack.surface_at({350, 350}), Eq(stub_surface1));
+
+    // Custom input rectangles may reach beyond the content area
+    stub_surface2->set_input_region({{{300, 300}, {100, 100}}});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({350, 350}), Eq(stub_surface2));
+
+    stub_surface2->set_input_region({});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface2));
+    EXPECT_THAT(stack.surface_at({350, 350}), Eq(stub_surface1));
+}
+
+TEST_F(SurfaceStack, input_surface_at_finds_same_surface_as_for_each)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+    stack.add_surface(stub_surface3, default_params.input_mode);
+
+    stub_surface1->resize({10000, 10000});
+    stub_surface2->resize({500, 200});
+    stub_surface2->move_to({300, 300});
+    stub_surface3->resize({10000, 10});
+
+    for (auto x = -100; x < 1200; x += 50)
+    {
+        for (auto y = -100; y < 1200; y += 50)
+        {
+            geom::Point const point{x, y};
+
+            std::shared_ptr<mi::Surface> expected;
+            stack.for_each([&](std::shared_ptr<mi::Surface> const& surface)
+                {
+                    if (surface->input_area_contains(point))
+                        expected = surface;
+                });
+
+            EXPECT_THAT(stack.input_surface_at(point), Eq(expected)) << "at " << point;
+        }
+    }
+}
+
 TEST_F(SurfaceStack, raise_surfaces_to_top)
 {
     stack.add_surface(stub_surface1, default_params.input_mode);
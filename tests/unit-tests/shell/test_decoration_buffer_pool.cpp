@@ -0,0 +1,145 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/shell/decoration/buffer_pool.h"
+
+#include "mir/test/doubles/stub_buffer_allocator.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace mg = mir::graphics;
+namespace msd = mir::shell::decoration;
+namespace geom = mir::geometry;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+struct DecorationBufferPool : Test
+{
+    auto pixels_of(std::shared_ptr<mg::Buffer> const& buffer) -> std::vector<uint32_t>
+    {
+        auto const& written = std::dynamic_pointer_cast<mtd::StubBuffer>(buffer)->written_pixels;
+        auto const start = reinterpret_cast<uint32_t const*>(written.data());
+        return {start, start + written.size() / sizeof(uint32_t)};
+    }
+
+    auto buffer_for(std::vector<uint32_t> const& pixels, uint64_t content) -> std::shared_ptr<mg::Buffer>
+    {
+        auto const buffer = pool.buffer_for(pixels.data(), size, content);
+        EXPECT_TRUE(buffer);
+        return buffer ? buffer.value() : nullptr;
+    }
+
+    geom::Size const size{3, 2};
+    std::vector<uint32_t> const red = std::vector<uint32_t>(6, 0xFFFF0000);
+    std::vector<uint32_t> const blue = std::vector<uint32_t>(6, 0xFF0000FF);
+    size_t const max_buffers{3};
+    msd::BufferPool pool{std::make_shared<mtd::StubBufferAllocator>(), max_buffers};
+};
+}
+
+TEST_F(DecorationBufferPool, buffer_holds_the_pixels)
+{
+    auto const buffer = buffer_for(red, 1);
+
+    EXPECT_THAT(buffer->size(), Eq(size));
+    EXPECT_THAT(pixels_of(buffer), Eq(red));
+}
+
+TEST_F(DecorationBufferPool, hands_back_a_free_buffer_with_the_same_content)
+{
+    auto const id = buffer_for(red, 1)->id();
+
+    auto const buffer = buffer_for(red, 1);
+
+    EXPECT_THAT(buffer->id(), Eq(id));
+    EXPECT_THAT(pixels_of(buffer), Eq(red));
+}
+
+TEST_F(DecorationBufferPool, does_not_hand_back_a_buffer_still_in_use)
+{
+    auto const in_use = buffer_for(red, 1);
+
+    auto const buffer = buffer_for(red, 1);
+
+    EXPECT_THAT(buffer->id(), Ne(in_use->id()));
+}
+
+TEST_F(DecorationBufferPool, new_content_gets_a_new_buffer)
+{
+    auto const red_buffer = buffer_for(red, 1);
+    auto const red_id = red_buffer->id();
+
+    auto const blue_buffer = buffer_for(blue, 2);
+
+    // Anything caching the red buffer's texture must not be shown blue pixels under the same ID
+    EXPECT_THAT(blue_buffer->id(), Ne(red_id));
+    EXPECT_THAT(pixels_of(blue_buffer), Eq(blue));
+    EXPECT_THAT(pixels_of(red_buffer), Eq(red));
+}
+
+TEST_F(DecorationBufferPool, free_buffer_is_not_rewritten_with_new_content)
+{
+    auto const red_id = buffer_for(red, 1)->id();
+
+    auto const blue_buffer = buffer_for(blue, 2);
+
+    EXPECT_THAT(blue_buffer->id(), Ne(red_id));
+    EXPECT_THAT(pixels_of(blue_buffer), Eq(blue));
+}
+
+TEST_F(DecorationBufferPool, buffer_of_a_different_size_is_not_handed_back)
+{
+    auto const id = buffer_for(red, 1)->id();
+
+    std::vector<uint32_t> const wider(8, 0xFFFF0000);
+    auto const buffer = pool.buffer_for(wider.data(), {4, 2}, 1);
+
+    ASSERT_TRUE(buffer);
+    EXPECT_THAT(buffer.value()->id(), Ne(id));
+    EXPECT_THAT(buffer.value()->size(), Eq(geom::Size{4, 2}));
+}
+
+TEST_F(DecorationBufferPool, still_hands_out_buffers_when_full_of_buffers_in_use)
+{
+    std::vector<std::shared_ptr<mg::Buffer>> in_use;
+    for (uint64_t content = 1; content <= max_buffers + 2; ++content)
+        in_use.push_back(buffer_for(red, content));
+
+    for (auto const& buffer : in_use)
+        EXPECT_THAT(pixels_of(buffer), Eq(red));
+}
+
+TEST_F(DecorationBufferPool, makes_room_by_dropping_free_buffers)
+{
+    for (uint64_t content = 1; content <= max_buffers; ++content)
+        buffer_for(red, content);
+
+    auto const id = buffer_for(blue, max_buffers + 1)->id();
+
+    EXPECT_THAT(buffer_for(blue, max_buffers + 1)->id(), Eq(id));
+}
+
+TEST_F(DecorationBufferPool, zero_size_gets_no_buffer)
+{
+    EXPECT_FALSE(pool.buffer_for(red.data(), {0, 2}, 1));
+    EXPECT_FALSE(pool.buffer_for(red.data(), {3, 0}, 1));
+}
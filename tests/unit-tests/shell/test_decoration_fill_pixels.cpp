@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/shell/decoration/fill_pixels.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace msd = mir::shell::decoration;
+
+using namespace testing;
+
+namespace
+{
+uint32_t const color{0xFF323232};
+uint32_t const untouched{0xDEADBEEF};
+}
+
+TEST(DecorationFillPixels, fills_exactly_the_pixels_asked_for)
+{
+    // Every length up to a few vectors, from every alignment, so that the scalar tail is covered
+    for (size_t offset = 0; offset != 4; ++offset)
+    {
+        for (size_t count = 0; count != 19; ++count)
+        {
+            std::vector<uint32_t> pixels(offset + count + 4, untouched);
+
+            msd::fill_pixels(pixels.data() + offset, count, color);
+
+            for (size_t i = 0; i != pixels.size(); ++i)
+            {
+                auto const in_range = i >= offset && i < offset + count;
+                ASSERT_THAT(pixels[i], Eq(in_range ? color : untouched))
+                    << "pixel " << i << " filling " << count << " from " << offset;
+            }
+        }
+    }
+}
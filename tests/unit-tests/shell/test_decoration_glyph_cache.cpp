@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/shell/decoration/glyph_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace msd = mir::shell::decoration;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+struct DecorationGlyphCache : Test
+{
+    auto rasterize(char32_t code, geom::Height height) -> std::function<msd::Glyph()>
+    {
+        return [this, code, height]()
+            {
+                ++rasterized;
+                return msd::Glyph{
+                    {1, 2},
+                    {height.as_int() / 2, 0},
+                    {static_cast<int>(code % 8) + 1, height.as_int()},
+                    std::vector<unsigned char>((code % 8 + 1) * height.as_int(), 0x80)};
+            };
+    }
+
+    size_t const max_glyphs{4};
+    msd::GlyphCache cache{max_glyphs};
+    size_t rasterized{0};
+};
+}
+
+TEST_F(DecorationGlyphCache, rasterizes_each_glyph_once)
+{
+    geom::Height const height{12};
+
+    for (auto i = 0; i != 3; ++i)
+    {
+        cache.glyph_for(U'a', height, rasterize(U'a', height));
+        cache.glyph_for(U'b', height, rasterize(U'b', height));
+    }
+
+    EXPECT_THAT(rasterized, Eq(2u));
+}
+
+TEST_F(DecorationGlyphCache, returns_the_rasterized_glyph)
+{
+    geom::Height const height{12};
+
+    auto const& glyph = cache.glyph_for(U'c', height, rasterize(U'c', height));
+
+    EXPECT_THAT(glyph.offset, Eq(geom::Displacement{1, 2}));
+    EXPECT_THAT(glyph.advance, Eq(geom::Displacement{6, 0}));
+    EXPECT_THAT(glyph.size, Eq(geom::Size{4, 12}));
+    EXPECT_THAT(glyph.alpha.size(), Eq(4u * 12u));
+
+    auto const& cached = cache.glyph_for(U'c', height, rasterize(U'c', height));
+
+    EXPECT_THAT(cached.size, Eq(geom::Size{4, 12}));
+    EXPECT_THAT(rasterized, Eq(1u));
+}
+
+TEST_F(DecorationGlyphCache, rasterizes_a_glyph_again_at_a_different_height)
+{
+    auto const& small = cache.glyph_for(U'a', geom::Height{10}, rasterize(U'a', geom::Height{10}));
+    EXPECT_THAT(small.size.height, Eq(geom::Height{10}));
+
+    auto const& large = cache.glyph_for(U'a', geom::Height{20}, rasterize(U'a', geom::Height{20}));
+    EXPECT_THAT(large.size.height, Eq(geom::Height{20}));
+
+    cache.glyph_for(U'a', geom::Height{10}, rasterize(U'a', geom::Height{10}));
+    EXPECT_THAT(rasterized, Eq(2u));
+}
+
+TEST_F(DecorationGlyphCache, starts_afresh_when_full)
+{
+    geom::Height const height{12};
+
+    for (char32_t code = U'a'; code != U'a' + max_glyphs; ++code)
+        cache.glyph_for(code, height, rasterize(code, height));
+
+    // Doesn't fit, so the others are dropped
+    cache.glyph_for(U'z', height, rasterize(U'z', height));
+    cache.glyph_for(U'z', height, rasterize(U'z', height));
+    EXPECT_THAT(rasterized, Eq(max_glyphs + 1));
+
+    cache.glyph_for(U'a', height, rasterize(U'a', height));
+    EXPECT_THAT(rasterized, Eq(max_glyphs + 2));
+}
+
+TEST_F(DecorationGlyphCache, caches_nothing_when_rasterizing_fails)
+{
+    geom::Height const height{12};
+    auto const fail = [this]() -> msd::Glyph { ++rasterized; throw std::runtime_error{"no glyph"}; };
+
+    EXPECT_THROW(cache.glyph_for(U'a', height, fail), std::runtime_error);
+
+    cache.glyph_for(U'a', height, rasterize(U'a', height));
+    EXPECT_THAT(rasterized, Eq(2u));
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/shell/decoration/renderer.h"
+#include "src/server/shell/decoration/window.h"
+#include "src/server/shell/decoration/input.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/doubles/mock_surface.h"
+#include "mir/test/doubles/stub_buffer_allocator.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace mg = mir::graphics;
+namespace msd = mir::shell::decoration;
+namespace geom = mir::geometry;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+msd::StaticGeometry const static_geometry{
+    geom::Height{24},   // titlebar_height
+    geom::Width{6},     // side_border_width
+    geom::Height{6},    // bottom_border_height
+    geom::Size{16, 16}, // resize_corner_input_size
+    geom::Width{24},    // button_width
+    geom::Width{6},     // padding_between_buttons
+    geom::Height{14},   // title_font_height
+    geom::Point{8, 2},  // title_font_top_left
+    geom::Displacement{5, 5}, // icon_padding
+    geom::Width{1},     // detail_line_width
+};
+
+struct CountingBufferAllocator : mtd::StubBufferAllocator
+{
+    std::shared_ptr<mg::Buffer> alloc_software_buffer(geom::Size size, MirPixelFormat format) override
+    {
+        ++allocated;
+        return mtd::StubBufferAllocator::alloc_software_buffer(size, format);
+    }
+
+    int allocated{0};
+};
+
+struct DecorationRenderer : Test
+{
+    DecorationRenderer()
+    {
+        surface.resize({240, 120});
+        surface.rename("Window");
+    }
+
+    /// Renders every part of the decoration, and lets go of the buffers as the compositor would
+    void render(MirWindowFocusState focus, std::vector<msd::ButtonInfo> const& buttons = {})
+    {
+        surface.set_focus_state(focus);
+        msd::WindowState const window_state{geometry, mt::fake_shared(surface)};
+        msd::InputState const input_state{buttons, {}};
+
+        renderer.update_state(window_state, input_state);
+        EXPECT_TRUE(renderer.render_titlebar());
+        EXPECT_TRUE(renderer.render_left_border());
+        EXPECT_TRUE(renderer.render_right_border());
+        EXPECT_TRUE(renderer.render_bottom_border());
+    }
+
+    msd::ButtonInfo button(msd::ButtonState state)
+    {
+        return {msd::ButtonFunction::Close, state, {{210, 0}, {24, 24}}};
+    }
+
+    NiceMock<mtd::MockSurface> surface;
+    std::shared_ptr<msd::StaticGeometry const> const geometry{std::make_shared<msd::StaticGeometry>(static_geometry)};
+    std::shared_ptr<CountingBufferAllocator> const allocator{std::make_shared<CountingBufferAllocator>()};
+    msd::Renderer renderer{allocator, geometry};
+};
+}
+
+TEST_F(DecorationRenderer, toggling_focus_back_and_forth_does_not_allocate_buffers)
+{
+    render(mir_window_focus_state_focused);
+    render(mir_window_focus_state_unfocused);
+    auto const allocated = allocator->allocated;
+
+    for (auto i = 0; i != 5; ++i)
+    {
+        render(mir_window_focus_state_focused);
+        render(mir_window_focus_state_unfocused);
+    }
+
+    EXPECT_THAT(allocator->allocated, Eq(allocated));
+}
+
+TEST_F(DecorationRenderer, hovering_a_button_back_and_forth_does_not_allocate_buffers)
+{
+    render(mir_window_focus_state_focused, {button(msd::ButtonState::Up)});
+    render(mir_window_focus_state_focused, {button(msd::ButtonState::Hovered)});
+    auto const allocated = allocator->allocated;
+
+    for (auto i = 0; i != 5; ++i)
+    {
+        render(mir_window_focus_state_focused, {button(msd::ButtonState::Up)});
+        render(mir_window_focus_state_focused, {button(msd::ButtonState::Hovered)});
+    }
+
+    EXPECT_THAT(allocator->allocated, Eq(allocated));
+}
+
+TEST_F(DecorationRenderer, renaming_the_window_allocates_a_new_titlebar)
+{
+    render(mir_window_focus_state_focused);
+    auto const allocated = allocator->allocated;
+
+    surface.rename("Renamed");
+    render(mir_window_focus_state_focused);
+
+    EXPECT_THAT(allocator->allocated, Eq(allocated + 1));
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/platform_probe_cache.h"
+
+#include "mir_test_framework/temporary_environment_value.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+
+namespace fs = boost::filesystem;
+namespace mtf = mir_test_framework;
+
+using namespace testing;
+
+namespace
+{
+struct PlatformProbeCache : Test
+{
+    PlatformProbeCache()
+    {
+        fs::create_directories(platform_path);
+        add_module("graphics-kms.so");
+        add_module("input-evdev.so");
+    }
+
+    ~PlatformProbeCache()
+    {
+        boost::system::error_code ignored;
+        fs::remove_all(directory, ignored);
+    }
+
+    void add_module(std::string const& name) const
+    {
+        std::ofstream{(platform_path / name).string()} << name;
+    }
+
+    auto module(std::string const& name) const -> std::string
+    {
+        return (platform_path / name).string();
+    }
+
+    fs::path const directory{fs::temp_directory_path() / fs::unique_path("mir-probe-cache-%%%%-%%%%")};
+    fs::path const platform_path{directory / "platforms"};
+    std::string const cache_file{(directory / "probe cache").string()};
+};
+}
+
+TEST_F(PlatformProbeCache, finds_nothing_when_nothing_is_stored)
+{
+    mir::PlatformProbeCache const cache{cache_file, platform_path.string()};
+
+    EXPECT_FALSE(cache.lookup("graphics"));
+}
+
+TEST_F(PlatformProbeCache, finds_what_was_stored_by_an_earlier_start)
+{
+    mir::PlatformProbeCache{cache_file, platform_path.string()}.store("graphics", {module("graphics-kms.so"), 256});
+    mir::PlatformProbeCache{cache_file, platform_path.string()}.store("input", {module("input-evdev.so"), 128});
+
+    mir::PlatformProbeCache const cache{cache_file, platform_path.string()};
+
+    auto const graphics = cache.lookup("graphics");
+    auto const input = cache.lookup("input");
+
+    ASSERT_TRUE(graphics);
+    EXPECT_THAT(graphics.value().module, Eq(module("graphics-kms.so")));
+    EXPECT_THAT(graphics.value().priority, Eq(256));
+
+    ASSERT_TRUE(input);
+    EXPECT_THAT(input.value().module, Eq(module("input-evdev.so")));
+    EXPECT_THAT(input.value().priority, Eq(128));
+}
+
+TEST_F(PlatformProbeCache, finds_nothing_when_a_module_is_added)
+{
+    mir::PlatformProbeCache{cache_file, platform_path.string()}.store("graphics", {module("graphics-kms.so"), 256});
+
+    add_module("graphics-wayland.so");
+
+    mir::PlatformProbeCache const cache{cache_file, platform_path.string()};
+
+    EXPECT_FALSE(cache.lookup("graphics"));
+}
+
+TEST_F(PlatformProbeCache, finds_nothing_when_a_module_is_replaced)
+{
+    mir::PlatformProbeCache{cache_file, platform_path.string()}.store("graphics", {module("graphics-kms.so"), 256});
+
+    std::ofstream{module("graphics-kms.so")} << "a newer graphics-kms.so";
+
+    mir::PlatformProbeCache const cache{cache_file, platform_path.string()};
+
+    EXPECT_FALSE(cache.lookup("graphics"));
+}
+
+TEST_F(PlatformProbeCache, finds_nothing_when_the_server_environment_changes)
+{
+    mir::PlatformProbeCache{cache_file, platform_path.string()}.store("graphics", {module("graphics-kms.so"), 256});
+
+    mtf::TemporaryEnvironmentValue const wayland_host{"MIR_SERVER_WAYLAND_HOST", "wayland-0"};
+
+    mir::PlatformProbeCache const cache{cache_file, platform_path.string()};
+
+    EXPECT_FALSE(cache.lookup("graphics"));
+}
+
+TEST_F(PlatformProbeCache, without_a_file_stores_nothing)
+{
+    mir::PlatformProbeCache cache{{}, platform_path.string()};
+
+    cache.store("graphics", {module("graphics-kms.so"), 256});
+
+    EXPECT_FALSE(cache.lookup("graphics"));
+}
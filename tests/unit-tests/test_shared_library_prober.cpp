@@ -41,6 +41,8 @@ public:
     MOCK_METHOD2(probing_failed, void(boost::filesystem::path const&, std::exception const&));
     MOCK_METHOD1(loading_library, void(boost::filesystem::path const&));
     MOCK_METHOD2(loading_failed, void(boost::filesystem::path const&, std::exception const&));
+    MOCK_METHOD1(loading_cached_library, void(boost::filesystem::path const&));
+    MOCK_METHOD2(probing_finished, void(boost::filesystem::path const&, std::chrono::steady_clock::duration));
 };
 
 class SharedLibraryProber : public testing::Test
@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace fs = boost::filesystem;
+namespace mst = mir::startup_trace;
+
+using namespace testing;
+
+namespace
+{
+struct Component {};
+
+struct StartupTrace : Test
+{
+    ~StartupTrace()
+    {
+        boost::system::error_code ignored;
+        fs::remove(filename, ignored);
+    }
+
+    auto written_trace() const -> std::string
+    {
+        std::ifstream in{filename};
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        return contents.str();
+    }
+
+    std::string const filename{(fs::temp_directory_path() / fs::unique_path("mir-startup-trace-%%%%-%%%%")).string()};
+};
+}
+
+TEST_F(StartupTrace, records_construction_of_cached_components)
+{
+    mst::CachedPtr<Component> component;
+
+    mst::start(filename);
+    auto const kept = component([] { return std::make_shared<Component>(); });
+    mst::finish();
+
+    EXPECT_THAT(written_trace(), HasSubstr(R"("name":"(anonymous namespace)::Component","cat":"component","ph":"X")"));
+}
+
+TEST_F(StartupTrace, records_only_the_first_construction)
+{
+    mst::CachedPtr<Component> component;
+
+    mst::start(filename);
+    auto const kept = component([] { return std::make_shared<Component>(); });
+    component([] { return std::make_shared<Component>(); });
+    mst::finish();
+
+    auto const trace = written_trace();
+    auto const first = trace.find("Component");
+
+    ASSERT_THAT(first, Ne(std::string::npos));
+    EXPECT_THAT(trace.find("Component", first + 1), Eq(std::string::npos));
+}
+
+TEST_F(StartupTrace, records_spans)
+{
+    mst::start(filename);
+    {
+        mst::Span const span{"init \"callback\"", "callback"};
+    }
+    mst::finish();
+
+    EXPECT_THAT(written_trace(), HasSubstr(R"("name":"init \"callback\"","cat":"callback")"));
+}
+
+TEST_F(StartupTrace, writes_nothing_unless_started)
+{
+    {
+        mst::Span const span{"span", "callback"};
+    }
+    mst::finish();
+
+    EXPECT_FALSE(fs::exists(filename));
+    EXPECT_FALSE(mst::recording());
+}
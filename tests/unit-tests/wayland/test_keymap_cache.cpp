@@ -0,0 +1,83 @@
+/*
+ * Copyright © 2020 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/keymap_cache.h"
+
+#include "mir/input/keymap.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+
+namespace mf = mir::frontend;
+namespace mi = mir::input;
+
+using namespace testing;
+
+TEST(KeymapCache, instance_is_shared_while_in_use)
+{
+    auto const cache = mf::KeymapCache::instance();
+
+    EXPECT_THAT(mf::KeymapCache::instance(), Eq(cache));
+}
+
+TEST(KeymapCache, compiles_each_keymap_once)
+{
+    mf::KeymapCache cache;
+
+    auto const us = cache.keymap_for(mi::Keymap{"pc105", "us", "", ""});
+    auto const us_again = cache.keymap_for(mi::Keymap{"pc105", "us", "", ""});
+    auto const gb = cache.keymap_for(mi::Keymap{"pc105", "gb", "", ""});
+
+    ASSERT_THAT(us, NotNull());
+    EXPECT_THAT(us_again, Eq(us));
+    EXPECT_THAT(gb, Ne(us));
+    EXPECT_THAT(gb->keymap(), Ne(us->keymap()));
+}
+
+TEST(KeymapCache, clients_are_sent_the_keymap_text)
+{
+    mf::KeymapCache cache;
+
+    auto const keymap = cache.keymap_for(mi::Keymap{});
+    auto const fd = keymap->fd_for_client();
+
+    auto const mapping = static_cast<char const*>(mmap(nullptr, keymap->size(), PROT_READ, MAP_PRIVATE, fd, 0));
+    ASSERT_THAT(mapping, Ne(MAP_FAILED));
+
+    EXPECT_THAT(strlen(mapping) + 1, Eq(keymap->size()));
+    EXPECT_THAT(mapping, StartsWith("xkb_keymap"));
+
+    munmap(const_cast<char*>(mapping), keymap->size());
+}
+
+TEST(KeymapCache, shared_keymap_file_cannot_be_modified)
+{
+    mf::KeymapCache cache;
+
+    auto const keymap = cache.keymap_for(mi::Keymap{});
+    auto const fd = keymap->fd_for_client();
+
+    EXPECT_THAT(fd, Eq(keymap->fd_for_client()));
+    EXPECT_THAT(fcntl(fd, F_GET_SEALS) & F_SEAL_WRITE, Ne(0));
+    EXPECT_THAT(ftruncate(fd, 0), Ne(0));
+    EXPECT_THAT(mmap(nullptr, keymap->size(), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0), Eq(MAP_FAILED));
+}
@@ -159,3 +159,54 @@ TEST_F(WaylandExecutorTest, spawning_is_threadsafe)
 
     EXPECT_THAT(counter, Eq(thread_count));
 }
+
+TEST_F(WaylandExecutorTest, one_dispatch_runs_all_queued_tasks_and_consumes_the_wakeup)
+{
+    mf::WaylandExecutor executor{the_event_loop};
+
+    int const task_count{10};
+    int executed{0};
+    for (auto i = 0; i != task_count; ++i)
+    {
+        executor.spawn([&executed]() { ++executed; });
+    }
+
+    wl_event_loop_dispatch(the_event_loop, 0);
+
+    EXPECT_THAT(executed, Eq(task_count));
+    EXPECT_THAT(event_loop_fd, Not(FdIsReadable()));
+}
+
+TEST_F(WaylandExecutorTest, runs_tasks_spawned_from_several_threads_across_several_dispatches)
+{
+    mf::WaylandExecutor executor{the_event_loop};
+
+    int const round_count{10};
+    int const thread_count{4};
+    int const tasks_per_thread{50};
+    int executed{0};
+
+    for (auto round = 1; round <= round_count; ++round)
+    {
+        {
+            std::vector<mt::AutoJoinThread> threads;
+            for (auto i = 0; i != thread_count; ++i)
+            {
+                threads.emplace_back(
+                    [&executor, &executed]()
+                    {
+                        // These all run on the Wayland loop, so need no synchronisation
+                        for (auto j = 0; j != tasks_per_thread; ++j)
+                            executor.spawn([&executed]() { ++executed; });
+                    });
+            }
+        }
+
+        while (mt::fd_is_readable(event_loop_fd))
+        {
+            wl_event_loop_dispatch(the_event_loop, 0);
+        }
+
+        ASSERT_THAT(executed, Eq(round * thread_count * tasks_per_thread));
+    }
+}